@@ -357,6 +357,27 @@ template <class T> void BTree<T>::RecursiveConvertToDArray(DArray<T>* darray, BT
 	RecursiveConvertToDArray(darray, btree->Right());
 }
 
+template <class T> template <class Visitor> void BTree<T>::ForEach(Visitor visitor)
+{
+
+	RecursiveForEach(visitor);
+}
+
+template <class T> template <class Visitor> void BTree<T>::RecursiveForEach(Visitor& visitor)
+{
+
+	if (id) {
+		visitor(id, data);
+	}
+
+	if (ltree) {
+		ltree->RecursiveForEach(visitor);
+	}
+	if (rtree) {
+		rtree->RecursiveForEach(visitor);
+	}
+}
+
 template <class T> void BTree<T>::RecursiveConvertIndexToDArray(DArray<char*>* darray, BTree<T>* btree)
 {
 
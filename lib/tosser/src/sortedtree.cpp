@@ -0,0 +1,458 @@
+// SortedTree implementation file
+// Part of Tosser
+// AVL balanced, with parent links so nodes can be walked in order
+
+#ifndef _included_tosser_sortedtree
+#define _included_tosser_sortedtree
+
+#include "tosser.h"
+
+#include <assert.h>
+#include <string.h>
+
+//=================================================================
+// SortedTreeNode
+
+template <class T> SortedTreeNode<T>::SortedTreeNode(const char* newid, const T& newdata)
+{
+
+	id = new char[strlen(newid) + 1];
+	strcpy(id, newid);
+	data = newdata;
+
+	left = right = parent = NULL;
+	height = 1;
+}
+
+template <class T> SortedTreeNode<T>::~SortedTreeNode() { delete[] id; }
+
+template <class T> SortedTreeNode<T>* SortedTreeNode<T>::Next() const
+{
+
+	if (right) {
+		SortedTreeNode<T>* node = right;
+		while (node->left) {
+			node = node->left;
+		}
+		return node;
+	}
+
+	const SortedTreeNode<T>* node = this;
+	while (node->parent && node == node->parent->right) {
+		node = node->parent;
+	}
+	return node->parent;
+}
+
+template <class T> SortedTreeNode<T>* SortedTreeNode<T>::Previous() const
+{
+
+	if (left) {
+		SortedTreeNode<T>* node = left;
+		while (node->right) {
+			node = node->right;
+		}
+		return node;
+	}
+
+	const SortedTreeNode<T>* node = this;
+	while (node->parent && node == node->parent->left) {
+		node = node->parent;
+	}
+	return node->parent;
+}
+
+//=================================================================
+// SortedTree
+
+template <class T> SortedTree<T>::SortedTree()
+{
+
+	root = NULL;
+	numitems = 0;
+}
+
+template <class T> SortedTree<T>::SortedTree(const SortedTree<T>& copy)
+{
+
+	root = NULL;
+	numitems = 0;
+	Copy(copy);
+}
+
+template <class T> SortedTree<T>::~SortedTree() { Empty(); }
+
+template <class T> SortedTree<T>& SortedTree<T>::operator=(const SortedTree<T>& copy)
+{
+
+	if (this != &copy) {
+		Empty();
+		Copy(copy);
+	}
+
+	return *this;
+}
+
+template <class T> void SortedTree<T>::Copy(const SortedTree<T>& copy)
+{
+
+	// In order, so duplicates keep their order
+	for (SortedTreeNode<T>* node = copy.First(); node; node = node->Next()) {
+		PutData(node->id, node->data);
+	}
+}
+
+template <class T> void SortedTree<T>::PutData(const char* newid, const T& newdata)
+{
+
+	assert(newid);
+
+	SortedTreeNode<T>* node = new SortedTreeNode<T>(newid, newdata);
+	numitems++;
+
+	if (!root) {
+		root = node;
+		return;
+	}
+
+	// Equal ids go right, after the entries already there
+
+	SortedTreeNode<T>* parent = root;
+
+	while (true) {
+		if (strcmp(newid, parent->id) < 0) {
+			if (!parent->left) {
+				parent->left = node;
+				break;
+			}
+			parent = parent->left;
+		} else {
+			if (!parent->right) {
+				parent->right = node;
+				break;
+			}
+			parent = parent->right;
+		}
+	}
+
+	node->parent = parent;
+	Rebalance(parent);
+}
+
+template <class T> void SortedTree<T>::RemoveData(const char* removeid)
+{
+
+	assert(removeid);
+
+	SortedTreeNode<T>* node = LookupTree(removeid);
+
+	if (node) {
+		RemoveNode(node);
+	}
+}
+
+template <class T> void SortedTree<T>::RemoveData(const char* removeid, const T& removedata)
+{
+
+	assert(removeid);
+
+	for (SortedTreeNode<T>* node = LookupTree(removeid); node; node = LookupNext(node)) {
+		if (node->data == removedata) {
+			RemoveNode(node);
+			return;
+		}
+	}
+}
+
+template <class T> void SortedTree<T>::RemoveNode(SortedTreeNode<T>* node)
+{
+
+	assert(node);
+
+	SortedTreeNode<T>* rebalancefrom;
+
+	if (node->left && node->right) {
+
+		// Move the successor node itself into this position, rather than
+		// copying its data here, so no other entry's node changes
+
+		SortedTreeNode<T>* successor = node->right;
+		while (successor->left) {
+			successor = successor->left;
+		}
+
+		if (successor->parent != node) {
+			rebalancefrom = successor->parent;
+
+			successor->parent->left = successor->right;
+			if (successor->right) {
+				successor->right->parent = successor->parent;
+			}
+
+			successor->right = node->right;
+			node->right->parent = successor;
+		} else {
+			rebalancefrom = successor;
+		}
+
+		successor->left = node->left;
+		node->left->parent = successor;
+
+		successor->parent = node->parent;
+		ReplaceChild(node->parent, node, successor);
+		successor->height = node->height;
+
+	} else {
+
+		SortedTreeNode<T>* child = node->left ? node->left : node->right;
+
+		if (child) {
+			child->parent = node->parent;
+		}
+		ReplaceChild(node->parent, node, child);
+
+		rebalancefrom = node->parent;
+	}
+
+	delete node;
+	numitems--;
+
+	Rebalance(rebalancefrom);
+}
+
+template <class T> T SortedTree<T>::GetData(const char* searchid) const
+{
+
+	SortedTreeNode<T>* node = LookupTree(searchid);
+
+	if (node) {
+		return node->data;
+	} else {
+		return NULL;
+	}
+}
+
+template <class T> SortedTreeNode<T>* SortedTree<T>::LookupTree(const char* searchid) const
+{
+
+	assert(searchid);
+
+	// Keep going left after a match, to find the first of any duplicates
+
+	SortedTreeNode<T>* node = root;
+	SortedTreeNode<T>* found = NULL;
+
+	while (node) {
+		int compare = strcmp(searchid, node->id);
+
+		if (compare < 0) {
+			node = node->left;
+		} else if (compare > 0) {
+			node = node->right;
+		} else {
+			found = node;
+			node = node->left;
+		}
+	}
+
+	return found;
+}
+
+template <class T> SortedTreeNode<T>* SortedTree<T>::LookupNext(const SortedTreeNode<T>* node) const
+{
+
+	assert(node);
+
+	SortedTreeNode<T>* next = node->Next();
+
+	if (next && strcmp(next->id, node->id) == 0) {
+		return next;
+	} else {
+		return NULL;
+	}
+}
+
+template <class T> void SortedTree<T>::Empty()
+{
+
+	DeleteNodes(root);
+	root = NULL;
+	numitems = 0;
+}
+
+template <class T> void SortedTree<T>::DeleteNodes(SortedTreeNode<T>* node)
+{
+
+	if (!node) {
+		return;
+	}
+
+	DeleteNodes(node->left);
+	DeleteNodes(node->right);
+	delete node;
+}
+
+template <class T> int SortedTree<T>::Size() const { return numitems; }
+
+template <class T> void SortedTree<T>::Print()
+{
+
+	for (SortedTreeNode<T>* node = First(); node; node = node->Next()) {
+		cout << node->id << " : " << node->data << "\n";
+	}
+}
+
+template <class T> SortedTreeNode<T>* SortedTree<T>::First() const
+{
+
+	SortedTreeNode<T>* node = root;
+
+	while (node && node->left) {
+		node = node->left;
+	}
+
+	return node;
+}
+
+template <class T> template <class Visitor> void SortedTree<T>::ForEach(Visitor visitor) const
+{
+
+	// Step on before the visit, in case the visitor removes this entry
+
+	SortedTreeNode<T>* node = First();
+
+	while (node) {
+		SortedTreeNode<T>* next = node->Next();
+		visitor(node->id, node->data);
+		node = next;
+	}
+}
+
+template <class T> DArray<T>* SortedTree<T>::ConvertToDArray() const
+{
+
+	DArray<T>* darray = new DArray<T>;
+	darray->SetSize(numitems);
+
+	int index = 0;
+	for (SortedTreeNode<T>* node = First(); node; node = node->Next()) {
+		darray->PutData(node->data, index++);
+	}
+
+	return darray;
+}
+
+template <class T> DArray<char*>* SortedTree<T>::ConvertIndexToDArray() const
+{
+
+	DArray<char*>* darray = new DArray<char*>;
+	darray->SetSize(numitems);
+
+	int index = 0;
+	for (SortedTreeNode<T>* node = First(); node; node = node->Next()) {
+		darray->PutData(node->id, index++);
+	}
+
+	return darray;
+}
+
+template <class T> int SortedTree<T>::Height(const SortedTreeNode<T>* node)
+{
+
+	return node ? node->height : 0;
+}
+
+template <class T> void SortedTree<T>::UpdateHeight(SortedTreeNode<T>* node)
+{
+
+	int lheight = Height(node->left);
+	int rheight = Height(node->right);
+	node->height = (lheight > rheight ? lheight : rheight) + 1;
+}
+
+template <class T>
+void SortedTree<T>::ReplaceChild(SortedTreeNode<T>* parent,
+								 SortedTreeNode<T>* oldchild,
+								 SortedTreeNode<T>* newchild)
+{
+
+	if (!parent) {
+		root = newchild;
+	} else if (parent->left == oldchild) {
+		parent->left = newchild;
+	} else {
+		parent->right = newchild;
+	}
+}
+
+template <class T> SortedTreeNode<T>* SortedTree<T>::RotateLeft(SortedTreeNode<T>* node)
+{
+
+	SortedTreeNode<T>* pivot = node->right;
+
+	node->right = pivot->left;
+	if (pivot->left) {
+		pivot->left->parent = node;
+	}
+
+	pivot->parent = node->parent;
+	ReplaceChild(node->parent, node, pivot);
+
+	pivot->left = node;
+	node->parent = pivot;
+
+	UpdateHeight(node);
+	UpdateHeight(pivot);
+
+	return pivot;
+}
+
+template <class T> SortedTreeNode<T>* SortedTree<T>::RotateRight(SortedTreeNode<T>* node)
+{
+
+	SortedTreeNode<T>* pivot = node->left;
+
+	node->left = pivot->right;
+	if (pivot->right) {
+		pivot->right->parent = node;
+	}
+
+	pivot->parent = node->parent;
+	ReplaceChild(node->parent, node, pivot);
+
+	pivot->right = node;
+	node->parent = pivot;
+
+	UpdateHeight(node);
+	UpdateHeight(pivot);
+
+	return pivot;
+}
+
+template <class T> void SortedTree<T>::Rebalance(SortedTreeNode<T>* node)
+{
+
+	// Walk up to the root, rotating wherever the heights differ by 2
+
+	while (node) {
+
+		UpdateHeight(node);
+		int balance = Height(node->left) - Height(node->right);
+
+		if (balance > 1) {
+			if (Height(node->left->left) < Height(node->left->right)) {
+				RotateLeft(node->left);
+			}
+			node = RotateRight(node);
+		} else if (balance < -1) {
+			if (Height(node->right->right) < Height(node->right->left)) {
+				RotateRight(node->right);
+			}
+			node = RotateLeft(node);
+		}
+
+		node = node->parent;
+	}
+}
+
+#endif
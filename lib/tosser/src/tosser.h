@@ -3,7 +3,7 @@
 //                        T O S S E R                            //
 //                                                               //
 //                   By Christopher Delay                        //
-//                           V1.14                               //
+//                           V1.15                               //
 //===============================================================//
 
 #ifndef _included_tosser_h
@@ -130,6 +130,7 @@ protected:
 
 	void RecursiveConvertToDArray(DArray<T>* darray, BTree<T>* btree);
 	void RecursiveConvertIndexToDArray(DArray<char*>* darray, BTree<T>* btree);
+	template <class Visitor> void RecursiveForEach(Visitor& visitor);
 
 	void AppendRight(BTree<T>* tempright); // Used by Remove
 
@@ -162,10 +163,119 @@ public:
 
 	DArray<T>* ConvertToDArray();
 	DArray<char*>* ConvertIndexToDArray();
+
+	// Calls visitor ( id, data ) for each entry in place, in ConvertToDArray order
+	template <class Visitor> void ForEach(Visitor visitor);
+};
+
+//=================================================================
+// Sorted tree object
+// source :: sortedtree.cc
+// Use : A sorted dynamic data structure, like BTree but kept balanced
+// Every data item has a string id which is used for ordering
+// Lookups stay fast whatever order the ids arrive in
+// Duplicate ids are allowed - they are kept in the order they were added
+// Entries can be walked in order in place (for ( T data : tree ))
+// Nodes never move : adding or removing one entry leaves the others'
+// nodes and iterators valid
+
+template <class T> class SortedTree;
+
+template <class T> class SortedTreeNode {
+
+	friend class SortedTree<T>;
+
+protected:
+	SortedTreeNode* left;
+	SortedTreeNode* right;
+	SortedTreeNode* parent;
+	int height;
+
+	SortedTreeNode(const char* newid, const T& newdata);
+	~SortedTreeNode();
+
+public:
+	char* id;
+	T data;
+
+	SortedTreeNode* Next() const; // In id order, NULL after the last
+	SortedTreeNode* Previous() const;
+};
+
+template <class T> class SortedTree {
+
+protected:
+	SortedTreeNode<T>* root;
+	int numitems;
+
+	void Copy(const SortedTree<T>& copy);
+	void RemoveNode(SortedTreeNode<T>* node);
+	void DeleteNodes(SortedTreeNode<T>* node);
+
+	static int Height(const SortedTreeNode<T>* node);
+	static void UpdateHeight(SortedTreeNode<T>* node);
+	void ReplaceChild(SortedTreeNode<T>* parent, SortedTreeNode<T>* oldchild, SortedTreeNode<T>* newchild);
+	SortedTreeNode<T>* RotateLeft(SortedTreeNode<T>* node);
+	SortedTreeNode<T>* RotateRight(SortedTreeNode<T>* node);
+	void Rebalance(SortedTreeNode<T>* node); // From node up to the root
+
+public:
+	class iterator {
+
+	protected:
+		SortedTreeNode<T>* node;
+
+	public:
+		iterator(SortedTreeNode<T>* newnode) : node(newnode) { }
+
+		T& operator*() const { return node->data; }
+		iterator& operator++()
+		{
+			node = node->Next();
+			return *this;
+		}
+		bool operator==(const iterator& other) const { return node == other.node; }
+		bool operator!=(const iterator& other) const { return node != other.node; }
+
+		const char* Id() const { return node->id; }
+		SortedTreeNode<T>* Node() const { return node; }
+	};
+
+	SortedTree();
+	SortedTree(const SortedTree<T>& copy);
+	~SortedTree();
+	SortedTree& operator=(const SortedTree<T>& copy);
+
+	void PutData(const char* newid, const T& newdata); // Goes after any entries with the same id
+	void RemoveData(const char* removeid); // Removes the first entry with this id
+	void RemoveData(const char* removeid, const T& removedata);
+	T GetData(const char* searchid) const; // First entry with this id
+
+	SortedTreeNode<T>* LookupTree(const char* searchid) const; // First entry with this id, or NULL
+	SortedTreeNode<T>* LookupNext(const SortedTreeNode<T>* node) const; // Next with the same id, or NULL
+
+	void Empty();
+
+	int Size() const; // Returns the size in elements
+
+	void Print(); // Prints this tree to stdout
+
+	SortedTreeNode<T>* First() const; // Lowest id, NULL if empty
+
+	iterator begin() const { return iterator(First()); }
+	iterator end() const { return iterator(NULL); }
+
+	// Calls visitor ( id, data ) for each entry in id order
+	// The visitor may remove the entry it is given, but no other
+	template <class Visitor> void ForEach(Visitor visitor) const;
+
+	DArray<T>* ConvertToDArray() const; // In id order
+	DArray<char*>* ConvertIndexToDArray() const;
 };
 
 #include "btree.cpp"
 #include "darray.cpp"
 #include "llist.cpp"
+#include "sortedtree.cpp"
 
 #endif
@@ -3,457 +3,1526 @@
  */
 
 #include "gameserver.h"
+#include "network/ipaddress.h"
 #include "network/supabase_client.h"
+#include "server_host.h"
+#include "server_log.h"
 
 #include <cstdio>
-#include <ctime>
+#include <cstring>
 #include <thread>
 #include <algorithm>
 
-// #include "world/world.h"
-// #include "world/agent.h"
+// Game world simulation (uplink-core)
+#include "app/app_headless.h"
+#include "app/miscutils.h"
+#include "game/game.h"
+#include "game/gameobituary.h"
+#include "world/world.h"
 
 namespace Server {
 
-// Helper to get formatted timestamp for logging
-static const char* GetTimestamp()
-{
-	static char buffer[32];
-	time_t now = time(nullptr);
-	struct tm* timeinfo = localtime(&now);
-	strftime(buffer, sizeof(buffer), "%H:%M:%S", timeinfo);
-	return buffer;
-}
-
 // ============================================================================
 // GameServer Implementation
 // ============================================================================
 
+// KEEPALIVE payloads up to this size are echoed back as latency probes
+static const uint16_t MAX_PROBE_PAYLOAD = 32;
+
+// Last reliable sequence from this client that has taken effect. Actions only
+// take effect in the next game tick, so anything from the first queued one on
+// is neither acknowledged nor kept when the session is suspended.
+static uint32_t AppliedSequence(const PlayerConnection& player)
+{
+	return player.unappliedSequence != 0 ? player.unappliedSequence - 1 : player.reliableIn.GetReceived();
+}
+
+// Length of one tick at the given rate
+static std::chrono::steady_clock::duration TickStep(int rateHz)
+{
+	return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(1.0 / rateHz));
+}
+
+// Each shard keeps its store and journal in a subdirectory of the configured one
+static std::string ShardDirectory(const std::string& directory, int shardIndex)
+{
+	return directory + "/shard" + std::to_string(shardIndex);
+}
+
 GameServer::GameServer() :
+	m_index(0),
+	m_homeShards(nullptr),
+	m_initialized(false),
 	m_running(false),
-	m_gameTickInterval(1000.0 / 60.0) // 60Hz
-	,
-	m_networkTickInterval(1000.0 / 20.0) // 20Hz
-	,
-	m_nextPlayerId(1),
+	m_gameStep(TickStep(60)),
+	m_networkStep(TickStep(20)),
+	m_timeSyncInterval(TickStep(2)),
+	m_gameAccumulator(0),
+	m_networkAccumulator(0),
+	m_gameStepSeconds(1.0 / 60.0),
+	m_playersUnsorted(false),
+	m_load(0),
 	m_date(), // Initialize Date object directly
+	m_simulating(false),
 	m_tickNumber(0)
 {
 }
 
 GameServer::~GameServer() { Shutdown(); }
 
-bool GameServer::Init(const ServerConfig& config)
+bool GameServer::Init(const ServerConfig& config, int shardIndex, HomeShardTable* homeShards)
 {
 	m_config = config;
-
-	// Calculate tick intervals
-	m_gameTickInterval = 1000.0 / config.tickRateHz;
-	m_networkTickInterval = 1000.0 / config.networkTickRateHz;
-
-	printf("[Server] Initializing on port %d (max %d players)\n", config.port, config.maxPlayers);
-
-	// Initialize Supabase
-	if (!config.supabaseUrl.empty()) {
-		printf("[Server] Connecting to Supabase at %s\n", config.supabaseUrl.c_str());
-		Net::SupabaseClient::Instance().Init(config.supabaseUrl, config.supabaseKey);
-	} else {
-		printf("[Server] WARNING: Supabase URL not configured, persistence disabled\n");
-	}
-
-	// Initialize networking
-	Net::NetResult result = Net::NetInit();
-	if (result != Net::NetResult::OK) {
-		printf("[Server] ERROR: Failed to initialize networking\n");
-		return false;
+	m_index = shardIndex;
+	m_homeShards = homeShards;
+	if (config.shards > 1) {
+		m_config.localStoreDir = ShardDirectory(config.localStoreDir, shardIndex);
+		m_config.journalDir = ShardDirectory(config.journalDir, shardIndex);
 	}
 
-	// Start listening
-	result = Net::NetworkManager::Instance().Listen(config.port);
-	if (result != Net::NetResult::OK) {
-		printf("[Server] ERROR: Failed to listen on port %d\n", config.port);
+	// Calculate tick intervals
+	m_gameStep = TickStep(config.tickRateHz);
+	m_networkStep = TickStep(config.networkTickRateHz);
+	m_timeSyncInterval = TickStep(config.timeSyncRateHz) - m_networkStep / 2;
+	m_gameStepSeconds = 1.0 / config.tickRateHz;
+
+	// Every player socket of this shard, waited on by its own thread
+	if (!m_sockets.Init(config.maxPlayers)) {
+		LogError(LogCategory::SERVER, "Failed to allocate a socket set for %d players", config.maxPlayers);
 		return false;
 	}
 
-	printf("[Server] Listening on port %d\n", config.port);
-
 	// Reserve space for players
 	m_players.reserve(config.maxPlayers);
 
 	// Create the world (now just initializes date)
 	CreateWorld();
 
+	// The game's World lives in globals (app, game), so only one shard can run it
+	if (config.simulateWorld && shardIndex == 0) {
+		StartSimulation();
+	}
+
+	m_initialized = true;
 	m_running = true;
-	m_lastGameTick = std::chrono::steady_clock::now();
-	m_lastNetworkTick = std::chrono::steady_clock::now();
+	m_gameAccumulator = std::chrono::steady_clock::duration::zero();
+	m_networkAccumulator = std::chrono::steady_clock::duration::zero();
 
-	printf("[Server] Initialization complete\n");
 	return true;
 }
 
 void GameServer::Run()
 {
-	printf("[Server] Starting main loop\n");
+	LogInfo(LogCategory::SERVER, "Starting main loop");
+
+	using Clock = std::chrono::steady_clock;
+	using Millis = std::chrono::duration<double, std::milli>;
+
+	const double gameBudgetMs = Millis(m_gameStep).count();
+	const double networkBudgetMs = Millis(m_networkStep).count();
+
+	auto previous = Clock::now();
+	m_lastTimingReport = previous;
+	m_timing.Reset();
 
 	while (m_running) {
-		auto now = std::chrono::steady_clock::now();
+		AdoptConnections();
+
+		// Real time since the last pass feeds both tick accumulators, so time spent
+		// in slow ticks is paid back by later ones instead of being lost
+		auto now = Clock::now();
+		m_gameAccumulator += now - previous;
+		m_networkAccumulator += now - previous;
+		previous = now;
+
+		// Game ticks: fixed steps, replaying late ones up to the catch-up limit
+		int steps = 0;
+		while (m_gameAccumulator >= m_gameStep && steps < m_config.maxCatchUpTicks) {
+			auto start = Clock::now();
+			GameTick(m_gameStepSeconds);
+			double elapsedMs = Millis(Clock::now() - start).count();
+
+			m_timing.gameTick.Record(elapsedMs);
+			if (elapsedMs > gameBudgetMs) {
+				m_timing.gameOverruns++;
+			}
+
+			m_gameAccumulator -= m_gameStep;
+			steps++;
+		}
 
-		// Game tick (60Hz)
-		auto gameDelta = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastGameTick).count();
-		if (gameDelta >= m_gameTickInterval) {
-			GameTick();
-			m_lastGameTick = now;
+		// Still behind: drop the backlog rather than spiral. Simulation runs slow
+		// under sustained overload instead of stalling the network tick.
+		if (m_gameAccumulator >= m_gameStep) {
+			auto dropped = m_gameAccumulator / m_gameStep;
+			m_timing.droppedGameTicks += dropped;
+			m_gameAccumulator -= dropped * m_gameStep;
 		}
 
-		// Network tick (20Hz)
-		auto networkDelta =
-			std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastNetworkTick).count();
-		if (networkDelta >= m_networkTickInterval) {
+		// Network ticks send current state, so one late tick covers any missed ones
+		if (m_networkAccumulator >= m_networkStep) {
+			auto start = Clock::now();
 			NetworkTick();
-			m_lastNetworkTick = now;
+			double elapsedMs = Millis(Clock::now() - start).count();
+
+			m_timing.networkTick.Record(elapsedMs);
+			if (elapsedMs > networkBudgetMs) {
+				m_timing.networkOverruns++;
+			}
+
+			m_networkAccumulator -= m_networkStep;
+			if (m_networkAccumulator >= m_networkStep) {
+				auto dropped = m_networkAccumulator / m_networkStep;
+				m_timing.droppedNetworkTicks += dropped;
+				m_networkAccumulator -= dropped * m_networkStep;
+			}
 		}
 
-		// Small sleep to prevent spinning
-		std::this_thread::sleep_for(std::chrono::microseconds(500));
+		ReportTiming(now);
+
+		// Next deadline is whichever accumulator fills first, measured from the
+		// same instant the accumulators were last advanced
+		auto deadline = now + std::min(m_gameStep - m_gameAccumulator, m_networkStep - m_networkAccumulator);
+		WaitUntil(deadline);
 	}
 
-	printf("[Server] Main loop ended\n");
+	LogInfo(LogCategory::SERVER, "Main loop ended");
 }
 
+void GameServer::WaitUntil(std::chrono::steady_clock::time_point deadline)
+{
+	// Sleep in select() until a socket is readable or the deadline passes.
+	// select() only has millisecond resolution, so whole milliseconds are spent
+	// there and the sub-millisecond remainder in sleep_until.
+	while (m_running) {
+		auto remaining = deadline - std::chrono::steady_clock::now();
+		if (remaining <= std::chrono::steady_clock::duration::zero()) {
+			return;
+		}
+
+		auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count();
+		if (waitMs == 0) {
+			std::this_thread::sleep_until(deadline);
+			return;
+		}
+
+		// Nothing to wait on - sleep instead of letting an empty Poll spin
+		if (m_sockets.GetWatchedCount() == 0) {
+			std::this_thread::sleep_until(deadline);
+			return;
+		}
+
+		int ready = m_sockets.Poll(static_cast<uint32_t>(waitMs));
+		if (ready > 0) {
+			ServiceSockets();
+		}
+	}
+}
+
+void GameServer::ReportTiming(std::chrono::steady_clock::time_point now)
+{
+	if (m_config.timingReportIntervalSec <= 0) {
+		return;
+	}
+
+	double window = std::chrono::duration<double>(now - m_lastTimingReport).count();
+	if (window < m_config.timingReportIntervalSec) {
+		return;
+	}
+
+	m_timing.Print(window);
+	m_timing.Reset();
+	m_actionStats.Print(window);
+	m_actionStats.Reset();
+	m_lastTimingReport = now;
+}
+
+void GameServer::Stop() { m_running = false; }
+
 void GameServer::Shutdown()
 {
-	if (!m_running) {
+	if (!m_initialized) {
 		return;
 	}
 
+	m_initialized = false;
 	m_running = false;
 
-	printf("[Server] Shutting down...\n");
+	LogInfo(LogCategory::SERVER, "Shutting down...");
+
+	// Connections handed over since the last loop pass never became players
+	{
+		std::lock_guard<std::mutex> lock(m_adoptMutex);
+		m_adoptions.clear(); // Closes their sockets
+	}
 
 	// Disconnect all players
 	for (auto& player : m_players) {
 		DisconnectPlayer(player, "Server shutting down");
 	}
 	m_players.clear();
+	m_load = 0;
+
+	for (auto& session : m_suspended) {
+		EndSession(session);
+	}
+	m_suspended.clear();
 
-	// Stop listening
-	Net::NetworkManager::Instance().StopListening();
+	// Journal the last tick's changes and flush everything pending
+	PersistWorldChanges();
+	m_persister.Stop();
 
-	// Cleanup networking
-	Net::NetShutdown();
+	m_sockets.Free();
 
 	// Cleanup world
-	/*
-	if (m_world) {
-		delete m_world;
-		m_world = nullptr;
-	}
-	*/
+	StopSimulation();
 
-	printf("[Server] Shutdown complete\n");
+	LogInfo(LogCategory::SERVER, "Shutdown complete");
 }
 
 bool GameServer::IsRunning() const { return m_running; }
 
+int GameServer::GetIndex() const { return m_index; }
+
 int GameServer::GetPlayerCount() const { return static_cast<int>(m_players.size()); }
 
-void GameServer::GameTick()
+int GameServer::GetLoad() const { return m_load; }
+
+void GameServer::GameTick(double deltaSeconds)
 {
-	// Update world simulation
+	// Deliver finished Supabase requests (auth, profiles) on the tick thread
+	Net::SupabaseClient::Instance().PollCompletions();
 
-	// We only want to update the date for now to avoid side effects of full world update
-	// without full App context if not fully verified
-	m_date.Update();
+	// A resumed session takes back an old id and leaves m_players unsorted; sort
+	// before ProcessActions' merge pass and FindPlayer depend on the order
+	RemoveDisconnectedPlayers();
+
+	// Player actions received since the last tick, in deterministic order
+	ProcessActions();
+
+	// Update world simulation
+	m_date.Update(deltaSeconds);
+
+	// The game's World keeps its own clock (real time scaled by game speed), so
+	// this only sets how often its scheduler and NPC agents get to run
+	if (m_simulating) {
+		game->Update();
+		if (!game->IsRunning()) {
+			LogWarn(LogCategory::WORLD, "World simulation ended: %s", game->GetObituary()->GameOverReason());
+			StopSimulation();
+		}
+	}
 
 	// Update NPC agents
-	UpdateNPCs();
+	UpdateNPCs(deltaSeconds);
 
 	// Process mission completions
 	ProcessMissions();
 
-	// Periodic auto-save to Supabase (every 30 seconds)
-	SaveDirtyStateToSupabase();
+	// Journal dirty entities; the persister flushes them to the store
+	PersistWorldChanges();
 
 	m_tickNumber++;
 }
 
-void GameServer::NetworkTick()
+void GameServer::NetworkTick()
+{
+	// Incoming data is handled by ServiceSockets as soon as Poll reports it
+
+	// Snapshot world state once, then diff it against each client's baseline
+	m_replicator.Capture(m_world);
+
+	// Send world state deltas to all players, and acknowledge what they sent
+	for (auto& player : m_players) {
+		if (player.authenticated) {
+			SendWorldDelta(player);
+			SendAck(player);
+		}
+	}
+
+	// Broadcast online player list (every network tick = 20Hz)
+	BroadcastPlayerList();
+
+	// Write everything queued this tick (including chat from ServiceSockets)
+	FlushSendQueues();
+
+	// Check for timeouts
+	CheckTimeouts();
+	RemoveDisconnectedPlayers();
+}
+
+void GameServer::ServiceSockets()
+{
+	// Only touch players whose socket was flagged readable by Poll
+	for (auto& player : m_players) {
+		if (player.socket.IsReady()) {
+			ProcessIncoming(player);
+		}
+	}
+
+	RemoveDisconnectedPlayers();
+}
+
+void GameServer::Adopt(uint32_t playerId, Net::Socket&& socket, Net::PacketFramer&& received)
+{
+	std::lock_guard<std::mutex> lock(m_adoptMutex);
+	m_adoptions.push_back({ playerId, std::move(socket), std::move(received) });
+	m_load++;
+}
+
+void GameServer::AdoptConnections()
+{
+	std::vector<Adoption> adoptions;
+	{
+		std::lock_guard<std::mutex> lock(m_adoptMutex);
+		if (m_adoptions.empty()) {
+			return;
+		}
+		adoptions.swap(m_adoptions);
+	}
+
+	for (auto& adoption : adoptions) {
+		// FlushSendQueues writes without waiting, so the socket never blocks the shard
+		if (!adoption.socket.SetNonBlocking()) {
+			LogWarn(LogCategory::NET,
+					"REJECT: Connection from %s (cannot make it non-blocking)",
+					adoption.socket.GetRemoteIP().c_str());
+			adoption.socket.Close();
+			m_load--;
+			continue;
+		}
+
+		if (!m_sockets.Watch(adoption.socket)) {
+			LogWarn(LogCategory::NET,
+					"REJECT: Connection from %s (shard full)",
+					adoption.socket.GetRemoteIP().c_str());
+			adoption.socket.Close();
+			m_load--;
+			continue;
+		}
+
+		// ServerHost hands players over in id order, so m_players stays sorted
+		PlayerConnection player;
+		player.playerId = adoption.playerId;
+		player.socket = std::move(adoption.socket);
+		player.remoteIp = player.socket.GetRemoteIP();
+		player.recvStream = std::move(adoption.received);
+		player.actionLimiter.Configure(
+			m_config.actionRatePerSec, m_config.actionBurst, std::chrono::steady_clock::now());
+
+		LogInfo(LogCategory::NET,
+				"CONNECT: Player #%u from %s (total: %zu/%d)",
+				player.playerId,
+				player.remoteIp.c_str(),
+				m_players.size() + 1,
+				m_config.maxPlayers);
+
+		m_players.push_back(std::move(player));
+
+		// The handshake that routed the connection is still buffered
+		DispatchReceived(m_players.back());
+	}
+
+	RemoveDisconnectedPlayers();
+}
+
+void GameServer::ProcessIncoming(PlayerConnection& player)
+{
+	if (!player.socket.IsValid()) {
+		return;
+	}
+
+	// Receive straight into the reassembly buffer
+	Net::PacketFramer& stream = player.recvStream;
+	int received = player.socket.Recv(stream.WriteBegin(), stream.WriteSpace(), 0);
+
+	if (received < 0) {
+		// Error or disconnect
+		DisconnectPlayer(player, "Connection lost", true);
+		return;
+	}
+
+	if (received == 0) {
+		return; // No data
+	}
+
+	stream.CommitWrite(static_cast<size_t>(received));
+	player.lastActivity = std::chrono::steady_clock::now();
+
+	DispatchReceived(player);
+}
+
+void GameServer::DispatchReceived(PlayerConnection& player)
+{
+	// Dispatch every complete packet buffered so far; a trailing partial packet
+	// stays buffered until the rest arrives
+	Net::PacketView packet;
+	while (player.socket.IsValid() && player.recvStream.Next(packet)) {
+		DispatchPacket(player, packet);
+	}
+}
+
+void GameServer::DispatchPacket(PlayerConnection& player, const Net::PacketView& received)
+{
+	// Reliable packets carry their sequence ahead of the body. Copies resent
+	// after a reconnect that were already handled are dropped here.
+	Net::PacketView packet = received;
+	if (packet.header.flags & Net::FLAG_RELIABLE) {
+		if (packet.length < Net::RELIABLE_PREFIX_SIZE) {
+			DisconnectPlayer(player, "Malformed reliable packet");
+			return;
+		}
+
+		uint32_t sequence = Net::ReadSequence(packet.payload);
+		switch (player.reliableIn.Accept(sequence)) {
+		case Net::ReliableReceiver::Result::DUPLICATE:
+			return;
+		case Net::ReliableReceiver::Result::GAP:
+			DisconnectPlayer(player, "Reliable sequence gap");
+			return;
+		case Net::ReliableReceiver::Result::DELIVER:
+			break;
+		}
+
+		packet.payload += Net::RELIABLE_PREFIX_SIZE;
+		packet.length -= Net::RELIABLE_PREFIX_SIZE;
+		packet.header.length = static_cast<uint16_t>(packet.length);
+
+		if (static_cast<Net::PacketType>(packet.header.type) == Net::PacketType::PLAYER_ACTION &&
+			player.unappliedSequence == 0) {
+			player.unappliedSequence = sequence;
+		}
+	}
+
+	// Route to appropriate handler
+	switch (static_cast<Net::PacketType>(packet.header.type)) {
+	case Net::PacketType::HANDSHAKE:
+		HandleHandshake(player, packet.payload, packet.length);
+		break;
+	case Net::PacketType::PLAYER_ACTION:
+		HandlePlayerAction(player, packet.payload, packet.length);
+		break;
+	case Net::PacketType::PLAYER_CHAT:
+		HandleChat(player, packet.payload, packet.length);
+		break;
+	case Net::PacketType::ACK:
+		HandleAck(player, packet.payload, packet.length);
+		break;
+	case Net::PacketType::KEEPALIVE:
+		// lastActivity is already updated in ProcessIncoming. A small payload is a
+		// latency probe (uplink-loadgen) - echo it back untouched.
+		if (packet.length > 0 && packet.length <= MAX_PROBE_PAYLOAD) {
+			QueuePacket(
+				player, Net::PacketType::KEEPALIVE, Net::FLAG_NONE, packet.payload, packet.header.length);
+		}
+		break;
+	default:
+		LogDebug(LogCategory::NET,
+				 "Unknown packet type 0x%02X from player %u",
+				 packet.header.type,
+				 player.playerId);
+		break;
+	}
+}
+
+void GameServer::SendWorldDelta(PlayerConnection& player)
+{
+	// Clients run their own clock between TIME_SYNCs, so they only need a few a
+	// second to keep it in step - plus one straight away on join
+	auto now = std::chrono::steady_clock::now();
+	bool timeSyncDue = !player.baseline.hasSnapshot || now - player.lastTimeSync >= m_timeSyncInterval;
+	if (timeSyncDue) {
+		Net::TimeSyncPacket packet;
+		packet.second = m_date.GetSecond();
+		packet.minute = m_date.GetMinute();
+		packet.hour = m_date.GetHour();
+		packet.day = m_date.GetDay();
+		packet.month = m_date.GetMonth();
+		packet.year = m_date.GetYear();
+		packet.paused = false; // TODO: Support pausing
+		packet.gameSpeed = 1.0f;
+		packet.millisecond = static_cast<uint16_t>(m_date.GetMillisecond());
+		packet.serverTimeMs = static_cast<uint32_t>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+
+		size_t length = Net::EncodeMessage(packet, m_messageBuffer);
+		QueuePacket(player,
+					Net::PacketType::TIME_SYNC,
+					Net::FLAG_NONE,
+					m_messageBuffer.data(),
+					static_cast<uint16_t>(length));
+		player.lastTimeSync = now;
+	}
+
+	// Only computers this player can reach are replicated to them
+	m_world.GetVisibleComputers(player.playerId, player.interest.computers);
+
+	// Joining clients get the whole visible world first; everyone else only what changed
+	if (!player.baseline.hasSnapshot) {
+		SendWorldFull(player);
+		return;
+	}
+
+	m_replicationBuffer.Clear();
+	if (m_replicator.WriteDelta(m_replicationBuffer, player.baseline, player.interest)) {
+		QueueMessage(player,
+					 Net::PacketType::WORLD_DELTA,
+					 Net::FLAG_RELIABLE,
+					 m_replicationBuffer.Data(),
+					 m_replicationBuffer.Size());
+	}
+}
+
+void GameServer::SendWorldFull(PlayerConnection& player)
+{
+	m_replicationBuffer.Clear();
+	m_replicator.WriteFull(m_replicationBuffer, player.baseline, player.interest);
+	QueueMessage(player,
+				 Net::PacketType::WORLD_FULL,
+				 Net::FLAG_RELIABLE,
+				 m_replicationBuffer.Data(),
+				 m_replicationBuffer.Size());
+
+	LogDebug(LogCategory::NET,
+			 "Sent snapshot to player #%u (%zu of %zu entities, %zu bytes)",
+			 player.playerId,
+			 player.baseline.known.size(),
+			 m_replicator.GetEntityCount(),
+			 m_replicationBuffer.Size());
+}
+
+void GameServer::QueueMessage(
+	PlayerConnection& player, Net::PacketType type, uint8_t flags, const uint8_t* data, size_t length)
+{
+	if (length <= Net::MAX_FRAGMENT_PAYLOAD) {
+		QueuePacket(player, type, flags, data, static_cast<uint16_t>(length));
+		return;
+	}
+
+	// Too big for one 16-bit packet - stream it as fragments
+	for (size_t offset = 0; offset < length; offset += Net::MAX_FRAGMENT_PAYLOAD) {
+		size_t chunk = std::min(length - offset, static_cast<size_t>(Net::MAX_FRAGMENT_PAYLOAD));
+		uint8_t fragmentFlags = flags | Net::FLAG_FRAGMENTED;
+		if (offset + chunk == length) {
+			fragmentFlags |= Net::FLAG_LAST_FRAGMENT;
+		}
+		QueuePacket(player, type, fragmentFlags, data + offset, static_cast<uint16_t>(chunk));
+	}
+}
+
+void GameServer::QueuePacket(
+	PlayerConnection& player, Net::PacketType type, uint8_t flags, const void* payload, uint16_t payloadLen)
+{
+	if (!player.socket.IsValid() || player.sendOverflow) {
+		return;
+	}
+
+	// Reliable packets are kept (and numbered) until the client acknowledges them
+	uint32_t sequence = 0;
+	if (flags & Net::FLAG_RELIABLE) {
+		sequence = player.reliableOut.Retain(type, flags, payload, payloadLen);
+	}
+
+	QueueSequenced(player, type, flags, sequence, payload, payloadLen);
+}
+
+void GameServer::QueueSequenced(PlayerConnection& player,
+								Net::PacketType type,
+								uint8_t flags,
+								uint32_t sequence,
+								const void* body,
+								size_t length)
+{
+	size_t oldSize = player.sendBuffer.size();
+	size_t prefix = sequence != 0 ? Net::RELIABLE_PREFIX_SIZE : 0;
+	size_t bodyOffset = oldSize + sizeof(Net::PacketHeader) + prefix;
+
+	if (player.authenticated && Net::PacketCompressor::ShouldCompress(length)) {
+		// Compress straight into the queue behind a placeholder header
+		size_t bound = Net::PacketCompressor::MaxCompressedSize(length);
+		player.sendBuffer.resize(bodyOffset + bound);
+
+		size_t compressedLen =
+			player.compressor.Compress(body, length, player.sendBuffer.data() + bodyOffset, bound);
+		if (compressedLen == 0) {
+			// Stream state is undefined now - the client could never decode another block
+			player.sendBuffer.resize(oldSize);
+			player.sendOverflow = true;
+			return;
+		}
+
+		flags |= Net::FLAG_COMPRESSED;
+		length = compressedLen;
+	} else {
+		// Serialize straight into the connection's queue
+		player.sendBuffer.resize(bodyOffset + length);
+		if (length > 0) {
+			memcpy(player.sendBuffer.data() + bodyOffset, body, length);
+		}
+	}
+
+	player.sendBuffer.resize(bodyOffset + length);
+	uint8_t* packet = player.sendBuffer.data() + oldSize;
+	Net::WritePacket(packet, type, flags, nullptr, static_cast<uint16_t>(prefix + length));
+	if (sequence != 0) {
+		Net::WriteSequence(packet + sizeof(Net::PacketHeader), sequence);
+	}
+
+	if (player.sendBuffer.size() > m_config.sendHighWaterMark) {
+		player.sendOverflow = true;
+	}
+}
+
+void GameServer::SendAck(PlayerConnection& player)
+{
+	uint32_t applied = AppliedSequence(player);
+	if (player.reliableIn.TakeAck(applied)) {
+		Net::AckPacket ack;
+		ack.sequence = applied;
+		size_t length = Net::EncodeMessage(ack, m_messageBuffer);
+		QueuePacket(player,
+					Net::PacketType::ACK,
+					Net::FLAG_NONE,
+					m_messageBuffer.data(),
+					static_cast<uint16_t>(length));
+	}
+}
+
+void GameServer::QueueRaw(PlayerConnection& player, const void* data, size_t length)
+{
+	if (!player.socket.IsValid() || player.sendOverflow) {
+		return;
+	}
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	player.sendBuffer.insert(player.sendBuffer.end(), bytes, bytes + length);
+
+	if (player.sendBuffer.size() > m_config.sendHighWaterMark) {
+		player.sendOverflow = true;
+	}
+}
+
+void GameServer::FlushSendQueues()
+{
+	auto now = std::chrono::steady_clock::now();
+
+	for (auto& player : m_players) {
+		if (!player.socket.IsValid()) {
+			continue;
+		}
+
+		if (player.sendOverflow) {
+			DisconnectPlayer(player, "Send queue overflow (client too slow)");
+			continue;
+		}
+
+		if (player.reliableOut.GetUnackedBytes() > m_config.maxUnackedBytes) {
+			DisconnectPlayer(player, "Reliable data not acknowledged");
+			continue;
+		}
+
+		if (player.sendBuffer.empty()) {
+			continue;
+		}
+
+		// One non-blocking write per tick, up to the budget. Whatever the kernel
+		// doesn't take stays queued, so a client that stops reading backs up here
+		// until the high-water mark or the stall timeout drops it, and never
+		// stalls the tick for everyone else.
+		size_t toSend = std::min(player.sendBuffer.size(), m_config.sendBudgetPerTick);
+		size_t sent = 0;
+
+		if (player.socket.SendNonBlocking(player.sendBuffer.data(), toSend, sent) != Net::NetResult::OK) {
+			DisconnectPlayer(player, "Send failed", true);
+			continue;
+		}
+
+		player.sendBuffer.erase(player.sendBuffer.begin(), player.sendBuffer.begin() + sent);
+
+		if (sent > 0) {
+			player.sendStalledSince = {};
+		} else if (player.sendStalledSince == std::chrono::steady_clock::time_point {}) {
+			player.sendStalledSince = now;
+		} else if (now - player.sendStalledSince > std::chrono::milliseconds(m_config.sendStallTimeoutMs)) {
+			DisconnectPlayer(player, "Send stalled (client not reading)", true);
+		}
+	}
+}
+
+void GameServer::BroadcastPacket(Net::PacketType type,
+								 uint8_t flags,
+								 const void* payload,
+								 uint16_t payloadLen)
+{
+	for (auto& player : m_players) {
+		if (player.authenticated && player.socket.IsValid()) {
+			QueuePacket(player, type, flags, payload, payloadLen);
+		}
+	}
+}
+
+void GameServer::BroadcastMessage(const void* data, size_t length)
+{
+	for (auto& player : m_players) {
+		if (player.authenticated && player.socket.IsValid()) {
+			QueueRaw(player, data, length);
+		}
+	}
+}
+
+void GameServer::BroadcastPlayerList()
+{
+	m_playerListEntries.clear();
+	for (const auto& player : m_players) {
+		if (player.authenticated) {
+			Net::PlayerListEntry entry;
+			entry.playerId = player.playerId;
+			entry.handle = player.handle;
+			entry.rating = static_cast<int16_t>(player.uplinkRating);
+			m_playerListEntries.push_back(entry);
+		}
+	}
+
+	Net::PlayerListPacket packet;
+	packet.players =
+		Net::RepeatedView<Net::PlayerListEntry>(m_playerListEntries.data(), m_playerListEntries.size());
+
+	size_t length = Net::EncodeMessage(packet, m_messageBuffer);
+	BroadcastPacket(
+		Net::PacketType::PLAYER_LIST, Net::FLAG_NONE, m_messageBuffer.data(), static_cast<uint16_t>(length));
+}
+
+void GameServer::HandleHandshake(PlayerConnection& player, const uint8_t* data, size_t length)
+{
+	// Ignore repeats while verification is running or after it finished
+	if (player.authPending || player.authenticated) {
+		return;
+	}
+
+	// The version goes first and decodes from any handshake layout, so an old
+	// client is told about the mismatch rather than that its handshake is broken
+	Net::HandshakePacket handshake;
+	bool decoded = Net::DecodeMessage(data, length, handshake);
+
+	if (handshake.protocolVersion != Net::PROTOCOL_VERSION) {
+		LogInfo(LogCategory::AUTH,
+				"REJECT: Player %u has wrong protocol version (%u vs %u)",
+				player.playerId,
+				handshake.protocolVersion,
+				Net::PROTOCOL_VERSION);
+		DisconnectPlayer(player, "Protocol version mismatch");
+		return;
+	}
+
+	if (!decoded) {
+		DisconnectPlayer(player, "Invalid handshake");
+		return;
+	}
+
+	// Store player handle
+	player.handle = std::string(handshake.handle);
+
+	// Extract auth token
+	std::string authToken(handshake.authToken);
+
+	// Verify token with Supabase (if Supabase is configured). The HTTP round-trip
+	// runs on the Supabase worker pool; the player stays unauthenticated until
+	// the result comes back through PollCompletions in GameTick.
+	if (!m_config.supabaseUrl.empty() && !authToken.empty()) {
+		player.authPending = true;
+		uint32_t playerId = player.playerId;
+		uint64_t session = handshake.resumeSession;
+		uint32_t received = handshake.resumeReceived;
+		Net::SupabaseClient::Instance().VerifyTokenAsync(
+			authToken, [this, playerId, authToken, session, received](const std::string& authId) {
+				PlayerConnection* p = FindPlayer(playerId);
+				if (!p || !p->socket.IsValid()) {
+					return;
+				}
+				// A reconnect carries on where the dropped connection stopped, but
+				// only for the identity that owned the session
+				if (session != 0 && !authId.empty() && ResumeSession(*p, session, received, authId)) {
+					RemoveDisconnectedPlayers(); // Later completions' FindPlayer needs the order back
+					return;
+				}
+				OnTokenVerified(*p, authId, authToken);
+			});
+		return;
+	}
+
+	// No verified identity: a guest session resumes only from the address it was opened from
+	if (handshake.resumeSession != 0 &&
+		ResumeSession(player, handshake.resumeSession, handshake.resumeReceived, std::string())) {
+		return;
+	}
+
+	if (authToken.empty()) {
+		// No token provided - allow as guest for now (can be made stricter)
+		LogInfo(LogCategory::AUTH,
+				"AUTH GUEST: Player #%u '%s' (no token)",
+				player.playerId,
+				player.handle.c_str());
+	} else {
+		// Supabase not configured - trust the handle
+		LogInfo(LogCategory::AUTH,
+				"AUTH SKIP: Player #%u '%s' (Supabase disabled)",
+				player.playerId,
+				player.handle.c_str());
+	}
+
+	// Guest player - use defaults
+	player.authId = "";
+	player.credits = 3000;
+	player.uplinkRating = 1;
+	player.neuromancerRating = 0;
+	CompleteHandshake(player);
+}
+
+void GameServer::OnTokenVerified(PlayerConnection& player,
+								 const std::string& authId,
+								 const std::string& authToken)
+{
+	if (authId.empty()) {
+		LogInfo(LogCategory::AUTH, "AUTH FAIL: Player #%u - invalid token", player.playerId);
+		player.authPending = false;
+		DisconnectPlayer(player, "Invalid or expired auth token");
+		return;
+	}
+
+	player.authId = authId;
+	LogInfo(LogCategory::AUTH,
+			"AUTH OK: Player #%u '%s' verified (id: %.8s...)",
+			player.playerId,
+			player.handle.c_str(),
+			authId.c_str());
+
+	// Load player profile with the player's own token (not the shared client token)
+	uint32_t playerId = player.playerId;
+	Net::SupabaseClient::Instance().GetPlayerProfileAsync(
+		authId, authToken, [this, playerId, authToken](const std::optional<Net::PlayerProfile>& profile) {
+			PlayerConnection* p = FindPlayer(playerId);
+			if (p && p->socket.IsValid()) {
+				OnProfileLoaded(*p, profile, authToken);
+			}
+		});
+}
+
+void GameServer::OnProfileLoaded(PlayerConnection& player,
+								 const std::optional<Net::PlayerProfile>& profile,
+								 const std::string& authToken)
+{
+	if (profile.has_value()) {
+		player.credits = profile->credits;
+		player.uplinkRating = profile->uplink_rating;
+		player.neuromancerRating = profile->neuromancer_rating;
+		LogInfo(LogCategory::AUTH,
+				"Loaded profile for %s: credits=%d rating=%d",
+				player.handle.c_str(),
+				player.credits,
+				player.uplinkRating);
+	} else {
+		// Profile doesn't exist yet - create default
+		LogInfo(LogCategory::AUTH, "No profile found for %s, using defaults", player.handle.c_str());
+		player.credits = 3000; // PLAYER_START_BALANCE
+		player.uplinkRating = 1;
+		player.neuromancerRating = 0;
+
+		// Attempt to create profile in database (fire and forget)
+		Net::SupabaseClient::Instance().CreatePlayerProfileAsync(player.authId, player.handle, authToken);
+	}
+
+	CompleteHandshake(player);
+}
+
+void GameServer::CompleteHandshake(PlayerConnection& player)
+{
+	player.authPending = false;
+	player.authenticated = true;
+
+	// Server-side agent carries the bounce path and links used for interest management
+	m_world.CreatePlayerAgent(player.playerId, player.handle, player.uplinkRating, player.credits);
+
+	// Reconnects with this handle come back here, to resume, until EndSession
+	if (m_homeShards) {
+		m_homeShards->Add(player.handle, m_index);
+	}
+
+	// Initial world state goes out with the next NetworkTick (no baseline yet)
+	// The token is all a resume needs besides the handle and identity, so it
+	// comes straight from the OS generator rather than a seeded PRNG
+	player.session = (static_cast<uint64_t>(m_sessionTokens()) << 32 | m_sessionTokens()) | 1; // Never 0
+
+	Net::HandshakeAckPacket ack;
+	ack.playerId = player.playerId;
+	ack.session = player.session;
+	size_t length = Net::EncodeMessage(ack, m_messageBuffer);
+	QueuePacket(player,
+				Net::PacketType::HANDSHAKE_ACK,
+				Net::FLAG_NONE,
+				m_messageBuffer.data(),
+				static_cast<uint16_t>(length));
+}
+
+bool GameServer::ResumeSession(PlayerConnection& player,
+								 uint64_t session,
+								 uint32_t received,
+								 const std::string& authId)
+{
+	// The handle is public (PLAYER_LIST), so the session must also belong to the
+	// same verified account, or for guests have come from the same address
+	auto owns = [&](const PlayerConnection& p) {
+		return p.session == session && p.handle == player.handle && p.authId == authId &&
+			   (!authId.empty() || p.remoteIp == player.remoteIp);
+	};
+
+	// Usually the session is already suspended, but the client may have noticed
+	// the drop first and the old connection still looks alive
+	for (auto& other : m_players) {
+		if (&other != &player && other.authenticated && owns(other)) {
+			DisconnectPlayer(other, "Replaced by a resumed connection", true);
+		}
+	}
+
+	PlayerConnection* suspended = nullptr;
+	for (auto& other : m_players) {
+		if (other.suspended && owns(other)) {
+			suspended = &other;
+		}
+	}
+	auto it = std::find_if(m_suspended.begin(), m_suspended.end(), owns);
+	if (!suspended && it != m_suspended.end()) {
+		suspended = &*it;
+	}
+
+	if (!suspended) {
+		LogInfo(LogCategory::NET,
+				"RESUME FAIL: Player #%u '%s' - session expired, unknown or not theirs",
+				player.playerId,
+				player.handle.c_str());
+		return false;
+	}
+
+	// The new connection takes over the session under its old id; the world
+	// agent, reliable streams and world baseline carry on as they were. The
+	// baseline missed every capture while the session was suspended, so the
+	// next WORLD_DELTA catches it up rather than sending a WORLD_FULL.
+	player.playerId = suspended->playerId;
+	player.authId = suspended->authId;
+	player.credits = suspended->credits;
+	player.uplinkRating = suspended->uplinkRating;
+	player.neuromancerRating = suspended->neuromancerRating;
+	player.agent = suspended->agent;
+	player.baseline = std::move(suspended->baseline);
+	player.interest = std::move(suspended->interest);
+	player.actionLimiter = suspended->actionLimiter;
+	player.reliableOut = std::move(suspended->reliableOut);
+	player.reliableIn = suspended->reliableIn;
+	player.session = session;
+	player.authPending = false;
+	player.authenticated = true;
+
+	suspended->suspended = false; // Taken over, so it is dropped without ending the session
+	if (it != m_suspended.end() && suspended == &*it) {
+		m_suspended.erase(it);
+	}
+	m_playersUnsorted = true;
+
+	Net::HandshakeAckPacket ack;
+	ack.playerId = player.playerId;
+	ack.session = session;
+	ack.received = player.reliableIn.GetReceived();
+	ack.resumed = true;
+	size_t length = Net::EncodeMessage(ack, m_messageBuffer);
+	QueuePacket(player,
+				Net::PacketType::HANDSHAKE_ACK,
+				Net::FLAG_NONE,
+				m_messageBuffer.data(),
+				static_cast<uint16_t>(length));
+
+	// Everything the client hadn't acknowledged goes again, ahead of anything new
+	player.reliableOut.Acknowledge(received);
+	player.reliableOut.ForEachUnacked(
+		[&](uint32_t sequence, Net::PacketType type, uint8_t flags, const uint8_t* body, size_t length) {
+			QueueSequenced(player, type, flags, sequence, body, length);
+		});
+
+	LogInfo(LogCategory::NET,
+			"RESUME: Player #%u '%s' (%zu packets resent)",
+			player.playerId,
+			player.handle.c_str(),
+			player.reliableOut.GetUnackedCount());
+	return true;
+}
+
+void GameServer::HandlePlayerAction(PlayerConnection& player, const uint8_t* data, size_t length)
+{
+	if (!player.authenticated) {
+		return;
+	}
+
+	m_actionStats.received++;
+
+	Net::ActionPacket action;
+	if (!Net::DecodeMessage(data, length, action)) {
+		m_actionStats.malformed++;
+		return;
+	}
+
+	if (!player.actionLimiter.TryTake(std::chrono::steady_clock::now())) {
+		m_actionStats.rateLimited++;
+		return;
+	}
+
+	// The queue keeps its own copy of action.data - the receive buffer is
+	// reused before the next game tick
+	m_actionQueue.Push(player.playerId, action);
+}
+
+void GameServer::HandleChat(PlayerConnection& player, const uint8_t* data, size_t length)
+{
+	if (!player.authenticated) {
+		return;
+	}
+
+	Net::ChatPacket incoming;
+	if (!Net::DecodeMessage(data, length, incoming)) {
+		LogDebug(LogCategory::CHAT, "Invalid chat packet from %u", player.playerId);
+		return;
+	}
+
+	LogInfo(LogCategory::CHAT,
+			"[%.*s] %s: %.*s",
+			static_cast<int>(incoming.channel.size()),
+			incoming.channel.data(),
+			player.handle.c_str(),
+			static_cast<int>(incoming.message.size()),
+			incoming.message.data());
+
+	// Same text and channel, under the server-verified sender
+	Net::ChatPacket outgoing = incoming;
+	outgoing.sender = player.handle;
+
+	size_t encoded = Net::EncodeMessage(outgoing, m_messageBuffer);
+	BroadcastPacket(Net::PacketType::PLAYER_CHAT,
+					Net::FLAG_RELIABLE,
+					m_messageBuffer.data(),
+					static_cast<uint16_t>(encoded));
+}
+
+void GameServer::HandleAck(PlayerConnection& player, const uint8_t* data, size_t length)
+{
+	Net::AckPacket ack;
+	if (Net::DecodeMessage(data, length, ack)) {
+		player.reliableOut.Acknowledge(ack.sequence);
+	}
+}
+
+PlayerConnection* GameServer::FindPlayer(uint32_t playerId)
+{
+	return const_cast<PlayerConnection*>(static_cast<const GameServer*>(this)->FindPlayer(playerId));
+}
+
+const PlayerConnection* GameServer::FindPlayer(uint32_t playerId) const
+{
+	// m_players is kept sorted by playerId
+	auto it = std::lower_bound(
+		m_players.begin(), m_players.end(), playerId, [](const PlayerConnection& p, uint32_t id) {
+			return p.playerId < id;
+		});
+	return it != m_players.end() && it->playerId == playerId ? &*it : nullptr;
+}
+
+void GameServer::DisconnectPlayer(PlayerConnection& player, const char* reason, bool resumable)
+{
+	bool suspend = resumable && player.authenticated && m_config.resumeWindowSec > 0;
+
+	LogInfo(LogCategory::NET,
+			"DISCONNECT: Player #%u '%s' - %s%s (remaining: %zu)",
+			player.playerId,
+			player.handle.empty() ? "(unknown)" : player.handle.c_str(),
+			reason,
+			suspend ? ", resumable" : "",
+			m_players.size() - 1);
+
+	if (suspend) {
+		// The agent stays in the world until the session expires. Actions not yet
+		// applied are dropped and left unacknowledged, so a resuming client
+		// sends them again.
+		player.reliableIn.Rewind(AppliedSequence(player));
+		player.unappliedSequence = 0;
+		m_actionQueue.RemovePlayer(player.playerId);
+		player.suspended = true;
+	} else if (player.authenticated) {
+		EndSession(player);
+	}
+
+	m_sockets.Unwatch(player.socket);
+	player.socket.Close();
+	player.authenticated = false;
+	player.sendBuffer.clear();
+
+	// Removal from m_players is deferred to RemoveDisconnectedPlayers so callers
+	// iterating the player list stay valid
+}
+
+void GameServer::EndSession(PlayerConnection& player)
+{
+	// Save player state to Supabase
+	// TODO: Get actual stats from agent
+	Net::PlayerProfile profile;
+	profile.handle = player.handle;
+	// profile.credits = player.agent->GetBalance(); // Stub
+
+	// Net::SupabaseClient::Instance().UpdatePlayerProfile(profile);
+	LogInfo(LogCategory::AUTH, "SAVE: Saving state for '%s'", player.handle.c_str());
+
+	m_world.RemovePlayerAgent(player.playerId);
+
+	if (m_homeShards) {
+		m_homeShards->Remove(player.handle, m_index);
+	}
+}
+
+void GameServer::RemoveDisconnectedPlayers()
+{
+	auto now = std::chrono::steady_clock::now();
+	for (auto& player : m_players) {
+		if (!player.socket.IsValid() && player.suspended) {
+			player.suspendedAt = now;
+			m_suspended.push_back(std::move(player));
+		}
+	}
+
+	auto removed = std::remove_if(
+		m_players.begin(), m_players.end(), [](const PlayerConnection& p) { return !p.socket.IsValid(); });
+	m_load -= static_cast<int>(m_players.end() - removed);
+	m_players.erase(removed, m_players.end());
+
+	if (m_playersUnsorted) {
+		std::sort(
+			m_players.begin(), m_players.end(), [](const PlayerConnection& a, const PlayerConnection& b) {
+				return a.playerId < b.playerId;
+			});
+		m_playersUnsorted = false;
+	}
+}
+
+void GameServer::CheckTimeouts()
+{
+	auto now = std::chrono::steady_clock::now();
+
+	for (auto& player : m_players) {
+		if (!player.socket.IsValid()) {
+			continue;
+		}
+
+		auto elapsed =
+			std::chrono::duration_cast<std::chrono::milliseconds>(now - player.lastActivity).count();
+
+		if (elapsed > m_config.connectionTimeoutMs) {
+			DisconnectPlayer(player, "Connection timeout", true);
+		}
+	}
+
+	ExpireSessions(now);
+}
+
+void GameServer::ExpireSessions(std::chrono::steady_clock::time_point now)
+{
+	auto window = std::chrono::seconds(m_config.resumeWindowSec);
+
+	for (auto& session : m_suspended) {
+		if (now - session.suspendedAt > window) {
+			LogInfo(LogCategory::NET,
+					"EXPIRE: Session of player #%u '%s' was not resumed",
+					session.playerId,
+					session.handle.c_str());
+			EndSession(session);
+			session.suspended = false;
+		}
+	}
+
+	m_suspended.erase(std::remove_if(m_suspended.begin(),
+									 m_suspended.end(),
+									 [](const PlayerConnection& p) { return !p.suspended; }),
+					  m_suspended.end());
+}
+
+void GameServer::CreateWorld()
+{
+	LogInfo(LogCategory::WORLD, "Creating world...");
+
+	// Set start date: 14:00, 14th April 2010 (Uplink default)
+	m_date.SetDate(0, 0, 14, 14, 4, 3010);
+	m_date.Activate(); // Ensure it updates
+
+	// Load world state from the configured store
+	LoadWorld();
+
+	LogInfo(LogCategory::WORLD, "World created at %s", m_date.GetLongString());
+}
+
+std::unique_ptr<WorldStore> GameServer::CreateWorldStore() const
 {
-	// Accept new connections
-	AcceptConnections();
+	// Default: the shared database when configured, otherwise local disk
+	std::string backend = m_config.worldStore;
+	if (backend.empty()) {
+		backend = m_config.supabaseUrl.empty() ? "local" : "supabase";
+	}
 
-	// Process incoming data from all players
-	for (auto& player : m_players) {
-		ProcessIncoming(player);
+	// The Supabase tables hold a single world
+	if (backend == "supabase" && m_index > 0) {
+		LogWarn(LogCategory::WORLD, "Supabase store is kept by shard 0, using a local store");
+		backend = "local";
 	}
 
-	// Send world state deltas to all players
-	for (auto& player : m_players) {
-		if (player.authenticated) {
-			SendWorldDelta(player);
+	if (backend == "supabase") {
+		if (m_config.supabaseUrl.empty()) {
+			LogError(LogCategory::WORLD, "Supabase store selected but no --url given");
+			return nullptr;
 		}
+		return std::make_unique<SupabaseWorldStore>();
 	}
-
-	// Broadcast online player list (every network tick = 20Hz)
-	BroadcastPlayerList();
-
-	// Check for timeouts
-	CheckTimeouts();
+	if (backend == "local") {
+		return std::make_unique<LocalWorldStore>(m_config.localStoreDir);
+	}
+	if (backend != "none") {
+		LogError(LogCategory::WORLD, "Unknown world store '%s'", backend.c_str());
+	}
+	return nullptr;
 }
 
-void GameServer::AcceptConnections()
+void GameServer::LoadWorld()
 {
-	if (static_cast<int>(m_players.size()) >= m_config.maxPlayers) {
-		return; // Full
+	m_store = CreateWorldStore();
+	if (!m_config.importStore.empty() && !ImportWorld()) {
+		LogWarn(LogCategory::WORLD, "Import failed, loading the world the store already holds");
 	}
-
-	Net::Socket* newSocket = Net::NetworkManager::Instance().Accept();
-	if (!newSocket) {
-		return; // No pending connection
+	if (m_store && !LoadWorldFromStore()) {
+		m_store.reset(); // Never overwrite a store we couldn't read
+	}
+	if (!m_store) {
+		LogWarn(LogCategory::WORLD, "Persistence disabled, world changes will not be saved");
 	}
 
-	// Create new player connection
-	PlayerConnection player;
-	player.playerId = m_nextPlayerId++;
-	player.socket = std::move(*newSocket);
-	delete newSocket;
-
-	printf("[%s] CONNECT: Player #%u from %s (total: %zu/%d)\n",
-		   GetTimestamp(),
-		   player.playerId,
-		   player.socket.GetRemoteIP().c_str(),
-		   m_players.size() + 1,
-		   m_config.maxPlayers);
+	// Spawn NPCs that run independently of players
+	m_world.SpawnNPCs(5);
 
-	m_players.push_back(std::move(player));
+	LogInfo(LogCategory::WORLD, "Load complete");
 }
 
-void GameServer::ProcessIncoming(PlayerConnection& player)
+bool GameServer::ImportWorld()
 {
-	if (!player.socket.IsValid()) {
-		return;
+	auto* local = dynamic_cast<LocalWorldStore*>(m_store.get());
+	if (!local) {
+		LogError(LogCategory::WORLD, "--import only seeds a local store (--store local)");
+		return false;
 	}
 
-	uint8_t buffer[4096];
-	int received = player.socket.Recv(buffer, sizeof(buffer), 0);
-
-	if (received < 0) {
-		// Error or disconnect
-		DisconnectPlayer(player, "Connection lost");
-		return;
+	// Only reads the source, so every shard may import the same world
+	if (m_config.importStore != "supabase") {
+		LogError(LogCategory::WORLD, "Cannot import from '%s'", m_config.importStore.c_str());
+		return false;
 	}
-
-	if (received == 0) {
-		return; // No data
+	if (m_config.supabaseUrl.empty()) {
+		LogError(LogCategory::WORLD, "Supabase import selected but no --url given");
+		return false;
 	}
 
-	player.lastActivity = std::chrono::steady_clock::now();
+	SupabaseWorldStore source;
+	return local->Import(source);
+}
 
-	// Parse packet header
-	if (received < static_cast<int>(sizeof(Net::PacketHeader))) {
-		return; // Incomplete header
+bool GameServer::LoadWorldFromStore()
+{
+	auto start = std::chrono::steady_clock::now();
+	if (!m_world.Load(*m_store)) {
+		return false;
 	}
+	auto elapsed = std::chrono::steady_clock::now() - start;
 
-	const Net::PacketHeader* header = reinterpret_cast<const Net::PacketHeader*>(buffer);
-	const uint8_t* payload = buffer + sizeof(Net::PacketHeader);
-	size_t payloadLen = received - sizeof(Net::PacketHeader);
+	LogInfo(LogCategory::WORLD,
+			"Loaded from %s store in %.1fms",
+			m_store->GetName(),
+			std::chrono::duration<double, std::milli>(elapsed).count());
 
-	// Route to appropriate handler
-	switch (static_cast<Net::PacketType>(header->type)) {
-	case Net::PacketType::HANDSHAKE:
-		HandleHandshake(player, payload, payloadLen);
-		break;
-	case Net::PacketType::PLAYER_ACTION:
-		HandlePlayerAction(player, payload, payloadLen);
-		break;
-	case Net::PacketType::PLAYER_CHAT:
-		HandleChat(player, payload, payloadLen);
-		break;
-	case Net::PacketType::KEEPALIVE:
-		// Just update lastActivity, already done above
-		break;
-	default:
-		printf("[Server] Unknown packet type 0x%02X from player %u\n", header->type, player.playerId);
-		break;
+	// Replays anything a previous run journaled but never got into the store
+	if (!m_persister.Start(m_world, *m_store, m_config.journalDir, m_config.persistIntervalSec)) {
+		LogError(LogCategory::WORLD, "Could not open journal in '%s'", m_config.journalDir.c_str());
+		return false;
 	}
+	return true;
 }
 
-void GameServer::SendWorldDelta(PlayerConnection& player)
+void GameServer::PersistWorldChanges()
 {
-	// Send TimeSync packet
-	Net::TimeSyncPacket packet;
-	packet.second = m_date.GetSecond();
-	packet.minute = m_date.GetMinute();
-	packet.hour = m_date.GetHour();
-	packet.day = m_date.GetDay();
-	packet.month = m_date.GetMonth();
-	packet.year = m_date.GetYear();
-	packet.paused = false; // TODO: Support pausing
-	packet.gameSpeed = 1.0f;
-
-	uint8_t buffer[128];
-	size_t len =
-		Net::WritePacket(buffer, Net::PacketType::TIME_SYNC, Net::FLAG_NONE, &packet, sizeof(packet));
+	if (!m_persister.IsRunning() || !m_world.CollectChanges(m_changes)) {
+		return;
+	}
 
-	player.socket.Send(buffer, len);
+	m_persister.Submit(m_changes);
 }
 
-void GameServer::BroadcastMessage(const void* data, size_t length)
+bool GameServer::StartSimulation()
 {
-	for (auto& player : m_players) {
-		if (player.authenticated && player.socket.IsValid()) {
-			player.socket.Send(data, length);
-		}
+	std::string archiveDir = m_config.archiveDir;
+	if (archiveDir.empty()) {
+		archiveDir = "./";
+	} else if (archiveDir.back() != '/' && archiveDir.back() != '\\') {
+		archiveDir += '/';
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	if (!CoreInitialise(archiveDir.c_str())) {
+		LogWarn(LogCategory::WORLD,
+				"No game data in %s, running without the world simulation",
+				archiveDir.c_str());
+		return false;
 	}
+
+	game->NewGame();
+	m_simulating = true;
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	World* world = game->GetWorld();
+	LogInfo(LogCategory::WORLD,
+			"Generated game world in %.1fms: %d computers, %d people, %s",
+			std::chrono::duration<double, std::milli>(elapsed).count(),
+			world->computers.Size(),
+			world->people.Size(),
+			world->date.GetLongString());
+	return true;
 }
 
-void GameServer::BroadcastPlayerList()
+void GameServer::StopSimulation()
 {
-	Net::PlayerListPacket packet;
-	memset(&packet, 0, sizeof(packet));
-
-	uint8_t count = 0;
-	for (const auto& player : m_players) {
-		if (player.authenticated && count < 32) {
-			packet.players[count].playerId = player.playerId;
-			strncpy(packet.players[count].handle,
-					player.handle.c_str(),
-					sizeof(packet.players[count].handle) - 1);
-			packet.players[count].rating = player.uplinkRating;
-			count++;
-		}
+	if (!m_simulating) {
+		return;
 	}
-	packet.playerCount = count;
 
-	// Calculate actual packet size (header + count + entries)
-	size_t dataSize = sizeof(uint8_t) + (count * sizeof(Net::PlayerListEntry));
+	m_simulating = false;
+	CoreShutdown();
+}
 
-	uint8_t buffer[2048];
-	size_t len = Net::WritePacket(buffer, Net::PacketType::PLAYER_LIST, Net::FLAG_NONE, &packet, dataSize);
+void GameServer::UpdateNPCs(double deltaSeconds)
+{
+	// Run NPC AI through ServerWorld
+	m_world.Update(static_cast<float>(deltaSeconds));
+}
 
-	BroadcastMessage(buffer, len);
+void GameServer::ProcessMissions()
+{
+	// TODO: Check for mission completions, update ratings, etc.
 }
 
-void GameServer::HandleHandshake(PlayerConnection& player, const uint8_t* data, size_t length)
+// ============================================================================
+// Action Pipeline
+// ============================================================================
+
+void GameServer::ProcessActions()
 {
-	if (length < sizeof(Net::HandshakePacket)) {
-		DisconnectPlayer(player, "Invalid handshake");
-		return;
+	// Everything queued is applied or rejected below, so it can all be acknowledged
+	for (auto& player : m_players) {
+		player.unappliedSequence = 0;
 	}
 
-	const Net::HandshakePacket* handshake = reinterpret_cast<const Net::HandshakePacket*>(data);
-
-	// Check protocol version
-	if (handshake->protocolVersion != Net::PROTOCOL_VERSION) {
-		printf("[Server] Player %u has wrong protocol version (%u vs %u)\n",
-			   player.playerId,
-			   handshake->protocolVersion,
-			   Net::PROTOCOL_VERSION);
-		DisconnectPlayer(player, "Protocol version mismatch");
+	if (m_actionQueue.Empty()) {
 		return;
 	}
 
-	// Store player handle
-	player.handle = std::string(handshake->handle, strnlen(handshake->handle, sizeof(handshake->handle)));
-
-	// Extract auth token
-	std::string authToken(handshake->authToken, strnlen(handshake->authToken, sizeof(handshake->authToken)));
-
-	// Verify token with Supabase (if Supabase is configured)
-	if (!m_config.supabaseUrl.empty() && !authToken.empty()) {
-		std::string authId = Net::SupabaseClient::Instance().VerifyToken(authToken);
+	m_actionStats.largestBatch = std::max(m_actionStats.largestBatch, m_actionQueue.Size());
+	m_actionQueue.Sort();
+	std::vector<QueuedAction>& actions = m_actionQueue.GetActions();
 
-		if (authId.empty()) {
-			printf("[%s] AUTH FAIL: Player #%u - invalid token\n", GetTimestamp(), player.playerId);
-			DisconnectPlayer(player, "Invalid or expired auth token");
-			return;
+	// Both lists are in playerId order, so senders are matched in one merge pass.
+	// Actions from players who left since they were queued are dropped.
+	size_t next = 0;
+	for (QueuedAction& action : actions) {
+		while (next < m_players.size() && m_players[next].playerId < action.playerId) {
+			next++;
 		}
-
-		player.authId = authId;
-		printf("[%s] AUTH OK: Player #%u '%s' verified (id: %.8s...)\n",
-			   GetTimestamp(),
-			   player.playerId,
-			   player.handle.c_str(),
-			   authId.c_str());
-	} else if (authToken.empty()) {
-		// No token provided - allow as guest for now (can be made stricter)
-		printf("[%s] AUTH GUEST: Player #%u '%s' (no token)\n",
-			   GetTimestamp(),
-			   player.playerId,
-			   player.handle.c_str());
-		player.authId = "";
-	} else {
-		// Supabase not configured - trust the handle
-		printf("[%s] AUTH SKIP: Player #%u '%s' (Supabase disabled)\n",
-			   GetTimestamp(),
-			   player.playerId,
-			   player.handle.c_str());
-		player.authId = "";
+		bool connected = next < m_players.size() && m_players[next].playerId == action.playerId &&
+						 m_players[next].authenticated;
+		action.valid = connected && ValidateAction(m_players[next], action);
 	}
 
-	player.authenticated = true;
-
-	// Load player profile from Supabase if authId is set
-	if (!player.authId.empty()) {
-		// Need to set auth token for profile queries
-		Net::SupabaseClient::Instance().SetAuthToken(authToken);
-
-		auto profile = Net::SupabaseClient::Instance().GetPlayerProfile(player.authId);
-		if (profile.has_value()) {
-			player.credits = profile->credits;
-			player.uplinkRating = profile->uplink_rating;
-			player.neuromancerRating = profile->neuromancer_rating;
-			printf("[Server] Loaded profile for %s: credits=%d rating=%d\n",
-				   player.handle.c_str(),
-				   player.credits,
-				   player.uplinkRating);
-		} else {
-			// Profile doesn't exist yet - create default
-			printf("[Server] No profile found for %s, using defaults\n", player.handle.c_str());
-			player.credits = 3000; // PLAYER_START_BALANCE
-			player.uplinkRating = 1;
-			player.neuromancerRating = 0;
-
-			// Attempt to create profile in database
-			Net::SupabaseClient::Instance().CreatePlayerProfile(player.authId, player.handle);
+	// Validation only reads the world; state changes happen here, in order
+	next = 0;
+	for (const QueuedAction& action : actions) {
+		if (!action.valid) {
+			m_actionStats.rejected++;
+			continue;
 		}
-	} else {
-		// Guest player - use defaults
-		player.credits = 3000;
-		player.uplinkRating = 1;
-		player.neuromancerRating = 0;
+		while (m_players[next].playerId < action.playerId) {
+			next++;
+		}
+		ApplyAction(m_players[next], action);
+		m_actionStats.applied++;
 	}
 
-	// TODO: Create or load agent for this player
-	// TODO: Send handshake response with player ID
-	// TODO: Send initial world state
+	m_actionQueue.Clear();
 }
 
-void GameServer::HandlePlayerAction(PlayerConnection& player, const uint8_t* data, size_t length)
+bool GameServer::ValidateAction(const PlayerConnection& player, QueuedAction& action) const
 {
-	if (!player.authenticated) {
-		return;
-	}
+	const Net::ActionPacket& packet = action.packet;
 
-	if (length < sizeof(Net::ActionPacket)) {
-		return;
+	switch (packet.actionType) {
+	case Net::ActionType::ADD_BOUNCE:
+	case Net::ActionType::CONNECT_TARGET: {
+		// data = target IP string, resolved once here through the IP index
+		int64_t ip;
+		if (!Net::ParseIP(m_actionQueue.GetData(action), ip)) {
+			return false;
+		}
+		const ServerComputer* computer = m_world.FindComputerByIP(ip);
+		if (!computer) {
+			return false;
+		}
+		if (packet.actionType == Net::ActionType::CONNECT_TARGET && !computer->running) {
+			return false;
+		}
+		action.targetIp = ip;
+		return true;
 	}
 
-	const Net::ActionPacket* action = reinterpret_cast<const Net::ActionPacket*>(data);
+	case Net::ActionType::CLEAR_BOUNCES:
+	case Net::ActionType::DISCONNECT_ALL:
+	case Net::ActionType::RUN_SOFTWARE:
+	case Net::ActionType::BYPASS_SECURITY:
+	case Net::ActionType::DOWNLOAD_FILE:
+	case Net::ActionType::DELETE_FILE:
+	case Net::ActionType::DELETE_LOG:
+		return true;
+
+	case Net::ActionType::TRANSFER_MONEY:
+		// param1 = amount, param2 = source account, targetId = destination account
+		return packet.param1 > 0 && packet.param1 <= INT32_MAX && packet.param2 != packet.targetId;
+
+	case Net::ActionType::FRAME_PLAYER:
+		return packet.targetId != player.playerId && FindPlayer(packet.targetId) != nullptr;
+
+	case Net::ActionType::PLACE_BOUNTY:
+		// Funds are checked when applied - earlier actions this tick may spend them
+		return packet.param1 > 0 && packet.param1 <= INT32_MAX && packet.targetId != player.playerId &&
+			   FindPlayer(packet.targetId) != nullptr;
 
-	printf("[Server] Player %u action: type=0x%02X target=%u param1=%u param2=%u\n",
-		   player.playerId,
-		   static_cast<uint8_t>(action->actionType),
-		   action->targetId,
-		   action->param1,
-		   action->param2);
+	default:
+		return false; // Unknown or not yet supported action type
+	}
+}
 
-	// Route action to appropriate handler
-	switch (action->actionType) {
+void GameServer::ApplyAction(PlayerConnection& player, const QueuedAction& action)
+{
+	switch (action.packet.actionType) {
 	// Connection actions
 	case Net::ActionType::ADD_BOUNCE:
 		HandleAction_AddBounce(player, action);
 		break;
+	case Net::ActionType::CLEAR_BOUNCES:
+		HandleAction_ClearBounces(player, action);
+		break;
 	case Net::ActionType::CONNECT_TARGET:
 		HandleAction_ConnectTarget(player, action);
 		break;
@@ -496,279 +1565,128 @@ void GameServer::HandlePlayerAction(PlayerConnection& player, const uint8_t* dat
 		break;
 
 	default:
-		printf("[Server] Unknown action type 0x%02X from player %u\n",
-			   static_cast<uint8_t>(action->actionType),
-			   player.playerId);
-		break;
+		break; // Rejected by ValidateAction
 	}
 }
 
-void GameServer::HandleChat(PlayerConnection& player, const uint8_t* data, size_t length)
-{
-	if (!player.authenticated) {
-		return;
-	}
-
-	if (length < sizeof(Net::PacketHeader) + sizeof(Net::ChatPacket)) {
-		printf("[%s] CHAT: Invalid packet size from %u\n", GetTimestamp(), player.playerId);
-		return;
-	}
-
-	const Net::ChatPacket* incoming =
-		reinterpret_cast<const Net::ChatPacket*>(data + sizeof(Net::PacketHeader));
-
-	// Sanitize message (ensure null termination)
-	char message[256];
-	strncpy(message, incoming->message, sizeof(message) - 1);
-	message[sizeof(message) - 1] = '\0';
-
-	// Log the chat
-	printf("[%s] CHAT: [%s] %s: %s\n", GetTimestamp(), incoming->channel, player.handle.c_str(), message);
-
-	// Create outgoing chat packet with server-verified sender
-	Net::ChatPacket outgoing;
-	strncpy(outgoing.sender, player.handle.c_str(), sizeof(outgoing.sender) - 1);
-	outgoing.sender[sizeof(outgoing.sender) - 1] = '\0';
-	strncpy(outgoing.channel, incoming->channel, sizeof(outgoing.channel) - 1);
-	outgoing.channel[sizeof(outgoing.channel) - 1] = '\0';
-	strncpy(outgoing.message, message, sizeof(outgoing.message) - 1);
-	outgoing.message[sizeof(outgoing.message) - 1] = '\0';
-
-	// Serialize and broadcast to all authenticated players
-	uint8_t buffer[512];
-	size_t packetLen =
-		Net::WritePacket(buffer, Net::PacketType::PLAYER_CHAT, Net::FLAG_NONE, &outgoing, sizeof(outgoing));
-
-	for (auto& p : m_players) {
-		if (p.authenticated && p.socket.IsValid()) {
-			p.socket.Send(buffer, packetLen);
-		}
-	}
-}
+// ============================================================================
+// Action Handlers
+// ============================================================================
 
-PlayerConnection* GameServer::FindPlayer(uint32_t playerId)
-{
-	for (auto& player : m_players) {
-		if (player.playerId == playerId) {
-			return &player;
-		}
-	}
-	return nullptr;
-}
+// Called once per validated action on the tick thread. Targets have already
+// been checked by ValidateAction; nothing here logs per action.
 
-void GameServer::DisconnectPlayer(PlayerConnection& player, const char* reason)
+void GameServer::HandleAction_AddBounce(PlayerConnection& player, const QueuedAction& action)
 {
-	printf("[%s] DISCONNECT: Player #%u '%s' - %s (remaining: %zu)\n",
-		   GetTimestamp(),
-		   player.playerId,
-		   player.handle.empty() ? "(unknown)" : player.handle.c_str(),
-		   reason,
-		   m_players.size() - 1);
-
-	// Save player state to Supabase
-	if (player.authenticated) {
-		// TODO: Get actual stats from agent
-		Net::PlayerProfile profile;
-		profile.handle = player.handle;
-		// profile.credits = player.agent->GetBalance(); // Stub
-
-		// Net::SupabaseClient::Instance().UpdatePlayerProfile(profile);
-		printf("[%s] SAVE: Saving state for '%s'\n", GetTimestamp(), player.handle.c_str());
-	}
-
-	player.socket.Close();
-	player.authenticated = false;
-
-	// Remove from list
-	m_players.erase(
-		std::remove_if(m_players.begin(),
-					   m_players.end(),
-					   [&player](const PlayerConnection& p) { return p.playerId == player.playerId; }),
-		m_players.end());
+	// data = IP string, resolved to targetIp
+	m_world.AddBounce(player.playerId, action.targetIp);
 }
 
-void GameServer::CheckTimeouts()
+void GameServer::HandleAction_ClearBounces(PlayerConnection& player, const QueuedAction& action)
 {
-	auto now = std::chrono::steady_clock::now();
-
-	for (auto& player : m_players) {
-		auto elapsed =
-			std::chrono::duration_cast<std::chrono::milliseconds>(now - player.lastActivity).count();
-
-		if (elapsed > m_config.connectionTimeoutMs) {
-			DisconnectPlayer(player, "Connection timeout");
-		}
-	}
+	(void)action;
+	m_world.ClearBounces(player.playerId);
 }
 
-void GameServer::CreateWorld()
+void GameServer::HandleAction_ConnectTarget(PlayerConnection& player, const QueuedAction& action)
 {
-	printf("[%s] Creating world...\n", GetTimestamp());
-
-	// Set start date: 14:00, 14th April 2010 (Uplink default)
-	m_date.SetDate(0, 0, 14, 14, 4, 3010);
-	m_date.Activate(); // Ensure it updates
-
-	// Load world state from Supabase
-	LoadWorldFromSupabase();
-
-	m_lastSaveTime = std::chrono::steady_clock::now();
-	printf("[%s] World created at %s\n", GetTimestamp(), m_date.GetLongString());
-}
+	// data = target IP string, resolved to targetIp
 
-void GameServer::LoadWorldFromSupabase()
-{
-	if (m_config.supabaseUrl.empty()) {
-		printf("[%s] WORLD: Supabase not configured, using empty world\n", GetTimestamp());
-		return;
+	// Drop any previous connection first
+	ServerAgent* agent = m_world.FindPlayerAgent(player.playerId);
+	if (agent && agent->connectedToIp != 0) {
+		m_world.PlayerDisconnect(player.playerId, agent->connectedToIp);
 	}
 
-	printf("[%s] WORLD: Loading from Supabase via ServerWorld...\n", GetTimestamp());
-	m_world.LoadFromSupabase();
-
-	// Spawn NPCs that run independently of players
-	m_world.SpawnNPCs(5);
-
-	printf("[%s] WORLD: Load complete\n", GetTimestamp());
+	m_world.PlayerConnect(player.playerId, action.targetIp);
+	// TODO: Start trace timer, etc.
 }
 
-void GameServer::SaveDirtyStateToSupabase()
+void GameServer::HandleAction_Disconnect(PlayerConnection& player, const QueuedAction& action)
 {
-	if (m_config.supabaseUrl.empty()) {
-		return;
-	}
+	(void)action;
 
-	// Only save every 30 seconds
-	auto now = std::chrono::steady_clock::now();
-	auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastSaveTime).count();
-	if (elapsed < 30) {
-		return;
+	ServerAgent* agent = m_world.FindPlayerAgent(player.playerId);
+	if (agent && agent->connectedToIp != 0) {
+		m_world.PlayerDisconnect(player.playerId, agent->connectedToIp);
 	}
-
-	m_lastSaveTime = now;
-	printf("[%s] WORLD: Auto-saving state via ServerWorld...\n", GetTimestamp());
-	m_world.SaveDirtyState();
-}
-
-void GameServer::UpdateNPCs()
-{
-	// Run NPC AI through ServerWorld
-	// deltaTime = 1/60 second at 60Hz tick
-	m_world.Update(1.0f / 60.0f);
-}
-
-void GameServer::ProcessMissions()
-{
-	// TODO: Check for mission completions, update ratings, etc.
+	// TODO: Stop trace, clean up
 }
 
-// ============================================================================
-// Action Handlers
-// ============================================================================
-
-void GameServer::HandleAction_AddBounce(PlayerConnection& player, const Net::ActionPacket* action)
-{
-	// param1 = IP address as uint32
-	// data = IP string
-	printf("[Server] Player %u adding bounce: %s\n", player.playerId, action->data);
-	// TODO: Add to player's bounce path, validate IP exists
-}
-
-void GameServer::HandleAction_ConnectTarget(PlayerConnection& player, const Net::ActionPacket* action)
-{
-	// data = target IP string
-	printf("[Server] Player %u connecting to: %s\n", player.playerId, action->data);
-	// TODO: Initiate connection, start trace timer, etc.
-}
-
-void GameServer::HandleAction_Disconnect(PlayerConnection& player, const Net::ActionPacket* action)
-{
-	(void)action;
-	printf("[Server] Player %u disconnecting from current target\n", player.playerId);
-	// TODO: Clear connection, stop trace, clean up
-}
-
-void GameServer::HandleAction_RunSoftware(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_RunSoftware(PlayerConnection& player, const QueuedAction& action)
 {
 	// param1 = software type
 	// param2 = software version
-	printf("[Server] Player %u running software type=%u ver=%u\n",
-		   player.playerId,
-		   action->param1,
-		   action->param2);
+	(void)player;
+	(void)action;
 	// TODO: Validate player owns software, execute effect
 }
 
-void GameServer::HandleAction_BypassSecurity(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_BypassSecurity(PlayerConnection& player, const QueuedAction& action)
 {
 	// param1 = security type (proxy, firewall, monitor, etc.)
-	printf("[Server] Player %u bypassing security type=%u\n", player.playerId, action->param1);
+	(void)player;
+	(void)action;
 	// TODO: Check if player has right tools, grant access
 }
 
-void GameServer::HandleAction_DownloadFile(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_DownloadFile(PlayerConnection& player, const QueuedAction& action)
 {
 	// targetId = file ID
 	// data = filename
-	printf("[Server] Player %u downloading file: %s\n", player.playerId, action->data);
+	(void)player;
+	(void)action;
 	// TODO: Check access, start download, transfer data
 }
 
-void GameServer::HandleAction_DeleteFile(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_DeleteFile(PlayerConnection& player, const QueuedAction& action)
 {
 	// targetId = file ID
-	printf("[Server] Player %u deleting file ID=%u\n", player.playerId, action->targetId);
+	(void)player;
+	(void)action;
 	// TODO: Check permission, remove file, log action
 }
 
-void GameServer::HandleAction_DeleteLog(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_DeleteLog(PlayerConnection& player, const QueuedAction& action)
 {
 	// targetId = log entry ID
-	printf("[Server] Player %u deleting log ID=%u\n", player.playerId, action->targetId);
+	(void)player;
+	(void)action;
 	// TODO: Check if log is visible to player, remove it
 }
 
-void GameServer::HandleAction_TransferMoney(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_TransferMoney(PlayerConnection& player, const QueuedAction& action)
 {
 	// param1 = amount
 	// param2 = source account ID
 	// targetId = destination account ID
-	printf("[Server] Player %u transferring %u credits from %u to %u\n",
-		   player.playerId,
-		   action->param1,
-		   action->param2,
-		   action->targetId);
+	(void)player;
+	(void)action;
 	// TODO: Validate accounts, check balance, make transfer
 }
 
-void GameServer::HandleAction_FramePlayer(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_FramePlayer(PlayerConnection& player, const QueuedAction& action)
 {
 	// targetId = target player ID (to frame)
 	// param1 = crime type
-	printf("[Server] PVP: Player %u framing player %u for crime %u\n",
-		   player.playerId,
-		   action->targetId,
-		   action->param1);
+	(void)player;
+	(void)action;
 	// TODO: Plant evidence, modify logs to incriminate target player
 }
 
-void GameServer::HandleAction_PlaceBounty(PlayerConnection& player, const Net::ActionPacket* action)
+void GameServer::HandleAction_PlaceBounty(PlayerConnection& player, const QueuedAction& action)
 {
 	// targetId = target player ID
 	// param1 = bounty amount
-	printf("[Server] PVP: Player %u placing bounty of %u on player %u\n",
-		   player.playerId,
-		   action->param1,
-		   action->targetId);
+	int32_t amount = static_cast<int32_t>(action.packet.param1);
 
 	// Validate player has funds
-	if ((int32_t)action->param1 > player.credits) {
-		printf("[Server] Player %u has insufficient funds for bounty\n", player.playerId);
+	if (amount > player.credits) {
 		return;
 	}
 
 	// Deduct from player
-	player.credits -= action->param1;
+	player.credits -= amount;
 
 	// TODO: Add bounty to target player in database
 	// TODO: Notify target player of bounty
@@ -778,12 +1696,35 @@ void GameServer::HandleAction_PlaceBounty(PlayerConnection& player, const Net::A
 // Server Entry Point
 // ============================================================================
 
+// "<level>" for every category or "<category>=<level>", e.g. "net=debug"
+static bool ApplyLogLevel(const char* spec)
+{
+	LogLevel level;
+	const char* separator = strchr(spec, '=');
+	if (!separator) {
+		if (!ParseLogLevel(spec, level)) {
+			return false;
+		}
+		Logger::Instance().SetLevel(level);
+		return true;
+	}
+
+	LogCategory category;
+	std::string name(spec, separator - spec);
+	if (!ParseLogCategory(name.c_str(), category) || !ParseLogLevel(separator + 1, level)) {
+		return false;
+	}
+	Logger::Instance().SetLevel(category, level);
+	return true;
+}
+
 int ServerMain(int argc, char* argv[])
 {
 	printf("Cybrelink Dedicated Server\n");
 	printf("==========================\n\n");
 
 	ServerConfig config;
+	std::string logJsonPath;
 
 	// Default Supabase config (Cybrelink project)
 	config.supabaseUrl = "https://lszlgjxdygugmvylkxta.supabase.co";
@@ -802,6 +1743,10 @@ int ServerMain(int argc, char* argv[])
 			if (i + 1 < argc) {
 				config.maxPlayers = atoi(argv[++i]);
 			}
+		} else if (strcmp(argv[i], "--shards") == 0) {
+			if (i + 1 < argc) {
+				config.shards = std::max(1, atoi(argv[++i]));
+			}
 		} else if (strcmp(argv[i], "--url") == 0) {
 			if (i + 1 < argc) {
 				config.supabaseUrl = argv[++i];
@@ -810,27 +1755,88 @@ int ServerMain(int argc, char* argv[])
 			if (i + 1 < argc) {
 				config.supabaseKey = argv[++i];
 			}
+		} else if (strcmp(argv[i], "--store") == 0) {
+			if (i + 1 < argc) {
+				config.worldStore = argv[++i];
+			}
+		} else if (strcmp(argv[i], "--data") == 0) {
+			if (i + 1 < argc) {
+				config.localStoreDir = argv[++i];
+			}
+		} else if (strcmp(argv[i], "--import") == 0) {
+			if (i + 1 < argc) {
+				config.importStore = argv[++i];
+			}
+		} else if (strcmp(argv[i], "--journal") == 0) {
+			if (i + 1 < argc) {
+				config.journalDir = argv[++i];
+			}
+		} else if (strcmp(argv[i], "--archives") == 0) {
+			if (i + 1 < argc) {
+				config.archiveDir = argv[++i];
+			}
+		} else if (strcmp(argv[i], "--no-sim") == 0) {
+			config.simulateWorld = false;
+		} else if (strcmp(argv[i], "--log-level") == 0) {
+			if (i + 1 < argc && !ApplyLogLevel(argv[++i])) {
+				printf("Invalid --log-level '%s'\n", argv[i]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--log-json") == 0) {
+			if (i + 1 < argc) {
+				logJsonPath = argv[++i];
+			}
 		} else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
 			printf("Usage: uplink-server [options]\n");
 			printf("  -p, --port <port>          Server port (default: %d)\n", Net::DEFAULT_PORT);
-			printf("  -m, --max-players <num>    Max players (default: 8)\n");
+			printf("  -m, --max-players <num>    Max players per shard (default: 256)\n");
+			printf("  --shards <num>             Independent worlds, one thread each (default: 1)\n");
 			printf("  --url <url>                Supabase URL\n");
 			printf("  --key <key>                Supabase Anon Key\n");
+			printf("  --store <backend>          World store: supabase, local or none\n");
+			printf("                             (default: supabase with --url, otherwise local)\n");
+			printf("  --data <dir>               Local world store directory (default: world)\n");
+			printf("  --import supabase          Seed the local store: replace its world with the\n");
+			printf("                             Supabase one at startup (with --store local).\n");
+			printf("                             Without it a new local store starts empty\n");
+			printf("  --journal <dir>            World change journal (default: journal)\n");
+			printf("                             (with several shards, each uses <dir>/shard<n>)\n");
+			printf("  --archives <dir>           Game data (data.dat) for the world simulation\n");
+			printf("                             (default: the server's directory)\n");
+			printf("  --no-sim                   Don't run the game's world simulation\n");
+			printf("  --log-level <spec>         debug, info, warn, error or off, for all categories\n");
+			printf("                             or one: <category>=<level> (repeatable, default: info)\n");
+			printf("  --log-json <file>          Also append logs to file as JSON Lines\n");
 			printf("  -h, --help                 Show this help\n");
 			return 0;
 		}
 	}
 
-	GameServer server;
+	// The game data ships next to the executables, as for the game itself
+	if (config.archiveDir.empty()) {
+		char* serverPath = GetFilePath(argv[0]);
+		config.archiveDir = serverPath;
+		delete[] serverPath;
+	}
 
-	if (!server.Init(config)) {
-		printf("Failed to initialize server\n");
+	// Log calls from here on only queue; the writer thread does the I/O
+	if (!Logger::Instance().Start(logJsonPath)) {
 		return 1;
 	}
 
-	server.Run();
+	int exitCode = 0;
+	{
+		ServerHost host;
+		if (host.Init(config)) {
+			host.Run();
+		} else {
+			LogError(LogCategory::SERVER, "Failed to initialize server");
+			exitCode = 1;
+		}
+	} // Shutdown logs from the destructor
 
-	return 0;
+	Logger::Instance().Stop();
+	return exitCode;
 }
 
 } // namespace Server
@@ -10,20 +10,33 @@
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
 
 #include "network/network_sdl.h"
 #include "network/protocol.h"
+#include "network/packetframer.h"
+#include "network/packetcompressor.h"
+#include "network/reliablechannel.h"
 #include "network/supabase_client.h"
 
 // Forward declarations
 class World;
 class Agent;
 
+#include "server_actions.h"
 #include "server_date.h"
 #include "server_world.h"
+#include "server_persistence.h"
+#include "server_store.h"
+#include "server_replication.h"
+#include "server_timing.h"
 
 namespace Server {
 
+class HomeShardTable;
+
 // ============================================================================
 // Player Connection
 // ============================================================================
@@ -31,16 +44,45 @@ namespace Server {
 struct PlayerConnection {
 	uint32_t playerId;
 	Net::Socket socket;
+	std::string remoteIp; // Address the connection came from
 	std::string handle;
 	Agent* agent;
 
 	std::chrono::steady_clock::time_point lastActivity;
 	std::chrono::steady_clock::time_point lastNetworkTick;
+	std::chrono::steady_clock::time_point lastTimeSync; // Epoch until the first one is sent
+
+	// Reassembles the TCP stream into whole packets
+	Net::PacketFramer recvStream;
 
-	// Send queue for batching
+	// Outbound packets queued during the tick, flushed once per NetworkTick
 	std::vector<uint8_t> sendBuffer;
+	bool sendOverflow; // Queue passed the high-water mark - slow consumer
+	std::chrono::steady_clock::time_point sendStalledSince; // Epoch while the socket takes our writes
+
+	// zstd stream for FLAG_COMPRESSED payloads (matches the client's decompressor)
+	Net::PacketCompressor compressor;
+
+	// World entities this client has been sent, and the ones it can currently see
+	ClientBaseline baseline;
+	InterestSet interest;
+
+	// PLAYER_ACTION rate limit
+	TokenBucket actionLimiter;
+
+	// FLAG_RELIABLE packets: ours until the client ACKs them, and the client's
+	// handled so far. ACKs only cover actions once the game tick has applied them.
+	Net::ReliableSender reliableOut;
+	Net::ReliableReceiver reliableIn;
+	uint32_t unappliedSequence; // First reliable PLAYER_ACTION still in the action queue, 0 = none
+
+	// Resuming after a dropped connection
+	uint64_t session; // Token from HANDSHAKE_ACK
+	bool suspended; // Connection lost, session kept in m_suspended until resumed or expired
+	std::chrono::steady_clock::time_point suspendedAt;
 
 	bool authenticated;
+	bool authPending; // Token/profile lookup in flight on the Supabase workers
 	bool ready;
 	std::string authId; // Supabase user UUID (verified)
 
@@ -52,7 +94,12 @@ struct PlayerConnection {
 	PlayerConnection() :
 		playerId(0),
 		agent(nullptr),
+		sendOverflow(false),
+		unappliedSequence(0),
+		session(0),
+		suspended(false),
 		authenticated(false),
+		authPending(false),
 		ready(false),
 		credits(0),
 		uplinkRating(0),
@@ -69,44 +116,107 @@ struct PlayerConnection {
 
 struct ServerConfig {
 	uint16_t port = Net::DEFAULT_PORT;
-	int maxPlayers = 8;
+	int shards = 1; // Independent worlds behind one port, each on its own thread
+	int maxPlayers = 256; // Per shard, bounded by its SDL_net socket set (select FD_SETSIZE)
 	int tickRateHz = 60;
 	int networkTickRateHz = 20;
+	int timeSyncRateHz = 2; // TIME_SYNC per player; clients interpolate the clock in between
+	int maxCatchUpTicks = 5; // Late game ticks replayed per loop before the backlog is dropped
+	int timingReportIntervalSec = 60; // Tick timing summary on stdout, 0 = off
 	int connectionTimeoutMs = 15000;
+
+	// Outbound queue limits (per player)
+	size_t sendBudgetPerTick = 32 * 1024; // Bytes written per flush; rest waits for the next tick
+	size_t sendHighWaterMark = 4 * 1024 * 1024; // Queued bytes before a player is dropped as too slow
+	int sendStallTimeoutMs = 10000; // Socket accepting nothing this long before a player is dropped
+	size_t maxUnackedBytes = 16 * 1024 * 1024; // Reliable bytes awaiting an ACK before a player is dropped
+
+	// Sessions whose connection dropped stay resumable this long (0 = never)
+	int resumeWindowSec = 30;
+
+	// Player actions (per player token bucket)
+	double actionRatePerSec = 20.0; // Sustained actions per second
+	double actionBurst = 40.0; // Actions accepted back to back before the rate applies
 	std::string worldSeed;
 
 	// Supabase (optional)
 	std::string supabaseUrl;
 	std::string supabaseKey;
+	int supabaseWorkers = Net::SupabaseClient::DEFAULT_WORKERS; // HTTP requests in flight at once
+
+	// World persistence
+	std::string worldStore; // "supabase", "local" or "none"; empty = supabase if configured, else local
+	std::string localStoreDir = "world"; // LocalWorldStore snapshot and log
+	std::string importStore; // "supabase" = copy its world into the local store at startup; empty = none
+	std::string journalDir = "journal"; // Write-ahead journal of unflushed world changes
+	int persistIntervalSec = 30; // Bulk upsert of dirty entities to Supabase
+
+	// Game world simulation (uplink-core)
+	bool simulateWorld = true;
+	std::string archiveDir; // Holds data.dat and the patches; empty = the server's own directory
 };
 
 // ============================================================================
 // Game Server
 // ============================================================================
 
+// One world shard: a world, its players and the tick loop that serves them.
+// ServerHost owns the listen socket and hands each connection to a shard.
+
 class GameServer {
 public:
 	GameServer();
 	~GameServer();
 
 	// Lifecycle
-	bool Init(const ServerConfig& config);
-	void Run();
-	void Shutdown();
+	// homeShards (ServerHost's) learns which handles hold a session here
+	bool Init(const ServerConfig& config, int shardIndex = 0, HomeShardTable* homeShards = nullptr);
+	void Run(); // Tick loop on the shard's thread, returns after Stop
+	void Stop(); // Any thread
+	void Shutdown(); // Once Run has returned
+
+	// Take over an accepted connection along with anything it has already sent.
+	// Any thread - the shard picks it up at the start of its next loop pass.
+	void Adopt(uint32_t playerId, Net::Socket&& socket, Net::PacketFramer&& received);
 
 	// State
 	bool IsRunning() const;
+	int GetIndex() const;
 	int GetPlayerCount() const;
+	int GetLoad() const; // Players plus adoptions not yet picked up - any thread
 
 private:
 	// Main loops
-	void GameTick(); // 60Hz game logic
-	void NetworkTick(); // 20Hz network sync
+	void GameTick(double deltaSeconds); // Fixed-step game logic (tickRateHz)
+	void NetworkTick(); // Network sync (networkTickRateHz)
+	void WaitUntil(std::chrono::steady_clock::time_point deadline); // Service sockets until then
+	void ReportTiming(std::chrono::steady_clock::time_point now);
 
 	// Networking
-	void AcceptConnections();
+	void ServiceSockets(); // Handle sockets flagged readable by the last Poll
+	void AdoptConnections(); // Players handed over by ServerHost
 	void ProcessIncoming(PlayerConnection& player);
+	void DispatchReceived(PlayerConnection& player); // Every complete packet in recvStream
+	void DispatchPacket(PlayerConnection& player, const Net::PacketView& packet);
+	void SendWorldFull(PlayerConnection& player);
 	void SendWorldDelta(PlayerConnection& player);
+	void QueueMessage(
+		PlayerConnection& player, Net::PacketType type, uint8_t flags, const uint8_t* data, size_t length);
+	void QueuePacket(PlayerConnection& player,
+					 Net::PacketType type,
+					 uint8_t flags,
+					 const void* payload,
+					 uint16_t payloadLen);
+	void QueueSequenced(PlayerConnection& player, // sequence = 0 for unreliable packets
+						Net::PacketType type,
+						uint8_t flags,
+						uint32_t sequence,
+						const void* body,
+						size_t length);
+	void SendAck(PlayerConnection& player);
+	void QueueRaw(PlayerConnection& player, const void* data, size_t length);
+	void FlushSendQueues(); // One Send per player per network tick
+	void BroadcastPacket(Net::PacketType type, uint8_t flags, const void* payload, uint16_t payloadLen);
 	void BroadcastMessage(const void* data, size_t length);
 	void BroadcastPlayerList(); // Send online players to all clients
 
@@ -114,51 +224,120 @@ private:
 	void HandleHandshake(PlayerConnection& player, const uint8_t* data, size_t length);
 	void HandlePlayerAction(PlayerConnection& player, const uint8_t* data, size_t length);
 	void HandleChat(PlayerConnection& player, const uint8_t* data, size_t length);
-
-	// Action handlers (called by HandlePlayerAction)
-	void HandleAction_AddBounce(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_ConnectTarget(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_Disconnect(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_RunSoftware(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_BypassSecurity(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_DownloadFile(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_DeleteFile(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_DeleteLog(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_TransferMoney(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_FramePlayer(PlayerConnection& player, const Net::ActionPacket* action);
-	void HandleAction_PlaceBounty(PlayerConnection& player, const Net::ActionPacket* action);
+	void HandleAck(PlayerConnection& player, const uint8_t* data, size_t length);
+
+	// Handshake continuations (run from Supabase completions on the tick thread)
+	void OnTokenVerified(PlayerConnection& player, const std::string& authId, const std::string& authToken);
+	void OnProfileLoaded(PlayerConnection& player,
+						 const std::optional<Net::PlayerProfile>& profile,
+						 const std::string& authToken);
+	void CompleteHandshake(PlayerConnection& player);
+	// authId is the handshake token's verified identity, empty for a guest
+	bool
+	ResumeSession(PlayerConnection& player, uint64_t session, uint32_t received, const std::string& authId);
+
+	// Action pipeline (HandlePlayerAction queues, GameTick processes)
+	void ProcessActions(); // Validate and apply everything queued since the last tick
+	bool ValidateAction(const PlayerConnection& player, QueuedAction& action) const;
+	void ApplyAction(PlayerConnection& player, const QueuedAction& action);
+
+	// Action handlers (called by ApplyAction for validated actions)
+	void HandleAction_AddBounce(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_ClearBounces(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_ConnectTarget(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_Disconnect(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_RunSoftware(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_BypassSecurity(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_DownloadFile(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_DeleteFile(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_DeleteLog(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_TransferMoney(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_FramePlayer(PlayerConnection& player, const QueuedAction& action);
+	void HandleAction_PlaceBounty(PlayerConnection& player, const QueuedAction& action);
 
 	// Player management
 	PlayerConnection* FindPlayer(uint32_t playerId);
-	void DisconnectPlayer(PlayerConnection& player, const char* reason);
+	const PlayerConnection* FindPlayer(uint32_t playerId) const;
+	// resumable: the connection failed rather than the player being turned away,
+	// so the session is suspended for resumeWindowSec instead of ended
+	void DisconnectPlayer(PlayerConnection& player, const char* reason, bool resumable = false);
+	void EndSession(PlayerConnection& player); // Save the player and remove their agent
+	void RemoveDisconnectedPlayers(); // Erase players closed by DisconnectPlayer, suspending resumable ones
 	void CheckTimeouts();
+	void ExpireSessions(std::chrono::steady_clock::time_point now);
 
 	// World management
 	void CreateWorld();
-	void LoadWorldFromSupabase();
-	void SaveDirtyStateToSupabase();
-	void UpdateNPCs();
+	std::unique_ptr<WorldStore> CreateWorldStore() const; // nullptr = persistence disabled
+	void LoadWorld();
+	bool ImportWorld(); // Seeds the local store when --import is given
+	bool LoadWorldFromStore();
+	void PersistWorldChanges(); // Hand this tick's dirty entities to the persister
+	void UpdateNPCs(double deltaSeconds);
 	void ProcessMissions();
+	bool StartSimulation(); // Generate the game's World through uplink-core
+	void StopSimulation();
 
 private:
+	// A handed over connection waiting for the shard thread
+	struct Adoption {
+		uint32_t playerId;
+		Net::Socket socket;
+		Net::PacketFramer received;
+	};
+
 	ServerConfig m_config;
+	int m_index;
+	HomeShardTable* m_homeShards; // nullptr = no host routes by handle
+	bool m_initialized;
 	std::atomic<bool> m_running;
 
-	// Timing
-	std::chrono::steady_clock::time_point m_lastGameTick;
-	std::chrono::steady_clock::time_point m_lastNetworkTick;
-	double m_gameTickInterval;
-	double m_networkTickInterval;
-
-	// Players
+	// Timing - fixed steps fed by accumulated real time (see Run)
+	std::chrono::steady_clock::duration m_gameStep;
+	std::chrono::steady_clock::duration m_networkStep;
+	std::chrono::steady_clock::duration m_timeSyncInterval; // Less half a network step of jitter
+	std::chrono::steady_clock::duration m_gameAccumulator;
+	std::chrono::steady_clock::duration m_networkAccumulator;
+	double m_gameStepSeconds;
+
+	// Tick duration histograms, reported every timingReportIntervalSec
+	ServerTimingStats m_timing;
+	std::chrono::steady_clock::time_point m_lastTimingReport;
+
+	// Players, in ascending playerId order. New ids only grow and removal keeps
+	// order; a resumed session takes back its old id and sets m_playersUnsorted
+	// until RemoveDisconnectedPlayers sorts again, which GameTick also calls
+	// before it processes actions.
 	std::vector<PlayerConnection> m_players;
-	uint32_t m_nextPlayerId;
+	bool m_playersUnsorted;
+	std::vector<PlayerConnection> m_suspended; // Dropped connections that may still resume
+	std::random_device m_sessionTokens; // OS CSPRNG, drawn afresh for every token
+	Net::SocketSet m_sockets; // Every player's socket, polled by WaitUntil
+
+	std::mutex m_adoptMutex;
+	std::vector<Adoption> m_adoptions; // Guarded by m_adoptMutex
+	std::atomic<int> m_load; // m_players plus m_adoptions
 
 	// Authoritative world simulation
 	ServerDate m_date;
 	ServerWorld m_world; // Manages computers, banks, missions, NPCs
-
-	std::chrono::steady_clock::time_point m_lastSaveTime;
+	bool m_simulating; // The game's World (uplink-core) exists and is updated every game tick
+
+	// World state replication
+	WorldReplicator m_replicator;
+	Net::DeltaBuffer m_replicationBuffer; // Reused for every client's payload
+	std::vector<uint8_t> m_messageBuffer; // Reused to encode every other message
+	std::vector<Net::PlayerListEntry> m_playerListEntries; // Reused by BroadcastPlayerList
+
+	// Journals dirty entities and flushes them to the store in the background.
+	// Declared after m_store so it is destroyed (and stops writing) first.
+	std::unique_ptr<WorldStore> m_store;
+	WorldPersister m_persister;
+	WorldChangeSet m_changes; // Reused for every tick's collection
+
+	// Actions received since the last game tick, and what became of them
+	ActionQueue m_actionQueue;
+	ActionStats m_actionStats;
 
 	// Network tick counter for delta encoding
 	uint32_t m_tickNumber;
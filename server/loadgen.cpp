@@ -0,0 +1,635 @@
+/*
+ * Cybrelink Load Generator
+ * Headless protocol clients for measuring uplink-server capacity
+ *
+ * Opens N connections to a running server, handshakes each one, then replays
+ * a script of player actions per client at a fixed rate. Reports throughput,
+ * round-trip latency (KEEPALIVE echo probes), join latency (handshake to
+ * first TIME_SYNC) and the spacing of TIME_SYNC packets, which stretches
+ * beyond the time sync interval (500ms by default) whenever ticks overrun.
+ *
+ * For repeatable numbers run the server without persistence:
+ *   uplink-server --store none -m 512
+ *   uplink-loadgen -n 300 --rate 5 --duration 60
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/network_sdl.h"
+#include "network/packetframer.h"
+#include "network/protocol.h"
+#include "network/reliablechannel.h"
+#include "server_timing.h"
+
+namespace LoadGen {
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct LoadConfig {
+	std::string host = "localhost";
+	uint16_t port = Net::DEFAULT_PORT;
+	int clients = 100;
+	double actionRate = 2.0; // Script steps per second, per client
+	int durationSec = 30;
+	int rampSec = 5; // Connections are spread evenly over this long
+	int probeIntervalMs = 250; // KEEPALIVE echo probes, per client
+	int reportIntervalSec = 5;
+	std::string scriptPath; // Empty = built-in script
+	unsigned int seed = 1;
+};
+
+// ============================================================================
+// Action Script
+// ============================================================================
+
+// Script file, one step per line ('#' starts a comment):
+//   bounce <ip>                      ADD_BOUNCE
+//   clear                            CLEAR_BOUNCES
+//   connect <ip>                     CONNECT_TARGET
+//   disconnect                       DISCONNECT_ALL
+//   transfer <amount> <from> <to>    TRANSFER_MONEY (account ids)
+//   bounty <player id> <amount>      PLACE_BOUNTY
+//   chat <message...>                PLAYER_CHAT on the global channel
+//   wait <ms>                        Pause this client
+// <ip> may be "random" for a fresh address each time the step runs.
+// Every client loops over the script from a random starting step.
+
+enum class StepType { ACTION, CHAT, WAIT };
+
+struct ScriptStep {
+	StepType type = StepType::ACTION;
+	Net::ActionPacket action {};
+	std::string data; // action.data
+	bool randomIp = false; // Send a random IP as action.data instead
+	std::string text; // CHAT
+	int waitMs = 0; // WAIT
+};
+
+static const char* DEFAULT_SCRIPT[] = {
+	"bounce random", "bounce random", "connect random", "transfer 100 1 2",
+	"chat load test", "disconnect", "clear",
+};
+
+static bool ParseScriptLine(const char* line, ScriptStep& step)
+{
+	char verb[16];
+	int consumed = 0;
+	if (sscanf(line, " %15s %n", verb, &consumed) != 1 || verb[0] == '#') {
+		return false;
+	}
+	const char* args = line + consumed;
+
+	step = ScriptStep {};
+	Net::ActionPacket& action = step.action;
+
+	auto setIp = [&](Net::ActionType type) {
+		char ip[Net::MAX_ACTION_DATA_LENGTH + 1] = {};
+		if (sscanf(args, "%64s", ip) != 1) {
+			return false;
+		}
+		action.actionType = type;
+		step.randomIp = strcmp(ip, "random") == 0;
+		step.data = ip;
+		return true;
+	};
+
+	if (strcmp(verb, "bounce") == 0) {
+		return setIp(Net::ActionType::ADD_BOUNCE);
+	}
+	if (strcmp(verb, "connect") == 0) {
+		return setIp(Net::ActionType::CONNECT_TARGET);
+	}
+	if (strcmp(verb, "clear") == 0) {
+		action.actionType = Net::ActionType::CLEAR_BOUNCES;
+		return true;
+	}
+	if (strcmp(verb, "disconnect") == 0) {
+		action.actionType = Net::ActionType::DISCONNECT_ALL;
+		return true;
+	}
+	if (strcmp(verb, "transfer") == 0) {
+		action.actionType = Net::ActionType::TRANSFER_MONEY;
+		return sscanf(args, "%u %u %u", &action.param1, &action.param2, &action.targetId) == 3;
+	}
+	if (strcmp(verb, "bounty") == 0) {
+		action.actionType = Net::ActionType::PLACE_BOUNTY;
+		return sscanf(args, "%u %u", &action.targetId, &action.param1) == 2;
+	}
+	if (strcmp(verb, "chat") == 0) {
+		step.type = StepType::CHAT;
+		step.text = args;
+		while (!step.text.empty() && (step.text.back() == '\n' || step.text.back() == '\r')) {
+			step.text.pop_back();
+		}
+		return !step.text.empty();
+	}
+	if (strcmp(verb, "wait") == 0) {
+		step.type = StepType::WAIT;
+		return sscanf(args, "%d", &step.waitMs) == 1 && step.waitMs >= 0;
+	}
+
+	printf("[LoadGen] WARNING: Unknown script step '%s'\n", verb);
+	return false;
+}
+
+static bool LoadScript(const std::string& path, std::vector<ScriptStep>& out)
+{
+	out.clear();
+	ScriptStep step;
+
+	if (path.empty()) {
+		for (const char* line : DEFAULT_SCRIPT) {
+			if (ParseScriptLine(line, step)) {
+				out.push_back(step);
+			}
+		}
+		return true;
+	}
+
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file) {
+		printf("[LoadGen] ERROR: Cannot open script %s\n", path.c_str());
+		return false;
+	}
+	char line[512];
+	while (fgets(line, sizeof(line), file)) {
+		if (ParseScriptLine(line, step)) {
+			out.push_back(step);
+		}
+	}
+	fclose(file);
+
+	if (out.empty()) {
+		printf("[LoadGen] ERROR: Script %s has no steps\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+struct LoadStats {
+	Server::TickHistogram rtt; // KEEPALIVE probe round trip
+	Server::TickHistogram join; // Handshake sent -> first TIME_SYNC
+	Server::TickHistogram timeSyncGap; // Between consecutive TIME_SYNCs on one client
+
+	uint64_t connects = 0;
+	uint64_t connectFailures = 0;
+	uint64_t disconnects = 0;
+	uint64_t actionsSent = 0;
+	uint64_t chatsSent = 0;
+	uint64_t chatsReceived = 0; // Broadcasts, so roughly chatsSent * clients
+	uint64_t packetsReceived = 0;
+	uint64_t bytesSent = 0;
+	uint64_t bytesReceived = 0;
+
+	void Reset() { *this = LoadStats {}; }
+
+	void Print(const char* label, double seconds, int connected) const
+	{
+		seconds = seconds > 0.0 ? seconds : 1.0;
+		printf("[LoadGen] %s %.0fs | clients %d (+%llu -%llu, %llu failed)"
+			   " | sent %.0f actions/s %.0f chats/s %.1f KiB/s | recv %.0f pkts/s %.1f KiB/s\n",
+			   label,
+			   seconds,
+			   connected,
+			   static_cast<unsigned long long>(connects),
+			   static_cast<unsigned long long>(disconnects),
+			   static_cast<unsigned long long>(connectFailures),
+			   actionsSent / seconds,
+			   chatsSent / seconds,
+			   bytesSent / seconds / 1024.0,
+			   packetsReceived / seconds,
+			   bytesReceived / seconds / 1024.0);
+		printf("[LoadGen]   rtt %llu p50=%.2fms p99=%.2fms max=%.2fms"
+			   " | join %llu p50=%.1fms p99=%.1fms | time sync gap p50=%.1fms p99=%.1fms max=%.1fms\n",
+			   static_cast<unsigned long long>(rtt.GetCount()),
+			   rtt.Percentile(50.0),
+			   rtt.Percentile(99.0),
+			   rtt.GetMax(),
+			   static_cast<unsigned long long>(join.GetCount()),
+			   join.Percentile(50.0),
+			   join.Percentile(99.0),
+			   timeSyncGap.Percentile(50.0),
+			   timeSyncGap.Percentile(99.0),
+			   timeSyncGap.GetMax());
+	}
+};
+
+// ============================================================================
+// Simulated Client
+// ============================================================================
+
+struct LoadClient {
+	int index = 0;
+	Net::Socket socket;
+	Net::PacketFramer recvStream;
+	bool joined = false; // Received the first TIME_SYNC
+
+	Clock::time_point connectAt; // Scheduled by the ramp
+	Clock::time_point handshakeAt;
+	Clock::time_point lastTimeSync;
+	Clock::time_point nextStepAt;
+	Clock::time_point nextProbeAt;
+	size_t nextStep = 0;
+
+	// Reliable channel: actions and chat go out sequenced, and the server's
+	// reliable packets are acknowledged. Nothing is kept for resending - a
+	// dropped client is simply counted as lost.
+	uint32_t nextSequence = 1;
+	uint32_t received = 0;
+	uint32_t acknowledged = 0;
+};
+
+static double ElapsedMs(Clock::time_point from, Clock::time_point to)
+{
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+class LoadGenerator {
+public:
+	LoadGenerator(const LoadConfig& config, std::vector<ScriptStep> script) :
+		m_config(config),
+		m_script(std::move(script)),
+		m_rng(config.seed),
+		m_connected(0)
+	{
+	}
+
+	int Run()
+	{
+		if (Net::NetInit(m_config.clients + 1) != Net::NetResult::OK) {
+			printf("[LoadGen] ERROR: Network init failed\n");
+			return 1;
+		}
+
+		printf("[LoadGen] %d clients -> %s:%u, %.1f steps/s each, %d script steps, %ds\n",
+			   m_config.clients,
+			   m_config.host.c_str(),
+			   m_config.port,
+			   m_config.actionRate,
+			   static_cast<int>(m_script.size()),
+			   m_config.durationSec);
+
+		auto start = Clock::now();
+		auto end = start + std::chrono::seconds(m_config.durationSec);
+		auto rampStep = m_config.clients > 0 ? std::chrono::seconds(m_config.rampSec) / m_config.clients
+											 : Clock::duration::zero();
+
+		m_clients.resize(m_config.clients);
+		for (int i = 0; i < m_config.clients; i++) {
+			m_clients[i].index = i;
+			m_clients[i].connectAt = start + rampStep * i;
+		}
+
+		auto lastReport = start;
+		size_t nextConnect = 0;
+
+		while (Clock::now() < end) {
+			auto now = Clock::now();
+
+			while (nextConnect < m_clients.size() && m_clients[nextConnect].connectAt <= now) {
+				Connect(m_clients[nextConnect++]);
+			}
+
+			for (auto& client : m_clients) {
+				if (client.socket.IsValid()) {
+					SendDue(client, now);
+				}
+			}
+
+			if (Net::NetworkManager::Instance().Poll(1) > 0) {
+				for (auto& client : m_clients) {
+					if (client.socket.IsValid() && client.socket.IsReady()) {
+						Receive(client);
+					}
+				}
+			} else if (m_connected == 0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Nothing to poll yet
+			}
+
+			now = Clock::now();
+			if (now - lastReport >= std::chrono::seconds(m_config.reportIntervalSec)) {
+				m_window.Print("window", ElapsedMs(lastReport, now) / 1000.0, m_connected);
+				m_window.Reset();
+				lastReport = now;
+			}
+		}
+
+		printf("[LoadGen] ---- Summary ----\n");
+		m_total.Print("total", ElapsedMs(start, Clock::now()) / 1000.0, m_connected);
+
+		for (auto& client : m_clients) {
+			Close(client, false);
+		}
+		Net::NetShutdown();
+		return m_total.connects > 0 ? 0 : 1;
+	}
+
+private:
+	template <typename Fn> void Count(Fn&& fn)
+	{
+		fn(m_window);
+		fn(m_total);
+	}
+
+	void Connect(LoadClient& client)
+	{
+		auto& net = Net::NetworkManager::Instance();
+		if (net.Connect(m_config.host, m_config.port, client.socket) != Net::NetResult::OK ||
+			!net.Watch(client.socket)) {
+			client.socket.Close();
+			Count([](LoadStats& s) { s.connectFailures++; });
+			return;
+		}
+
+		char handle[Net::MAX_HANDLE_LENGTH];
+		snprintf(handle, sizeof(handle), "loadgen%04d", client.index);
+
+		Net::HandshakePacket handshake;
+		handshake.protocolVersion = Net::PROTOCOL_VERSION;
+		handshake.handle = handle;
+		// Empty token: the server trusts the handle without a Supabase round trip
+
+		auto now = Clock::now();
+		client.handshakeAt = now;
+		client.joined = false;
+		client.nextSequence = 1;
+		client.received = 0;
+		client.acknowledged = 0;
+		client.nextStep = m_script.empty() ? 0 : m_rng() % m_script.size();
+		client.nextStepAt = now + StepInterval();
+		client.nextProbeAt = now + std::chrono::milliseconds(m_config.probeIntervalMs);
+
+		m_connected++;
+		Count([](LoadStats& s) { s.connects++; });
+		SendEncoded(client, Net::PacketType::HANDSHAKE, handshake);
+	}
+
+	void Close(LoadClient& client, bool lost)
+	{
+		if (!client.socket.IsValid()) {
+			return;
+		}
+		Net::NetworkManager::Instance().Unwatch(client.socket);
+		client.socket.Close();
+		client.recvStream.Clear();
+		m_connected--;
+		if (lost) {
+			Count([](LoadStats& s) { s.disconnects++; });
+		}
+	}
+
+	Clock::duration StepInterval() const
+	{
+		double rate = m_config.actionRate > 0.0 ? m_config.actionRate : 1.0;
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+	}
+
+	bool SendPacket(
+		LoadClient& client, Net::PacketType type, const void* payload, uint16_t length, bool reliable = false)
+	{
+		uint8_t buffer[sizeof(Net::PacketHeader) + Net::RELIABLE_PREFIX_SIZE + 1024];
+		size_t packetLen;
+		if (reliable) {
+			uint8_t* body = buffer + sizeof(Net::PacketHeader);
+			Net::WriteSequence(body, client.nextSequence++);
+			memcpy(body + Net::RELIABLE_PREFIX_SIZE, payload, length);
+			packetLen = Net::WritePacket(buffer,
+										 type,
+										 Net::FLAG_RELIABLE,
+										 nullptr,
+										 static_cast<uint16_t>(Net::RELIABLE_PREFIX_SIZE + length));
+		} else {
+			packetLen = Net::WritePacket(buffer, type, Net::FLAG_NONE, payload, length);
+		}
+		if (client.socket.Send(buffer, packetLen) != Net::NetResult::OK) {
+			Close(client, true);
+			return false;
+		}
+		Count([&](LoadStats& s) { s.bytesSent += packetLen; });
+		return true;
+	}
+
+	template <typename Msg>
+	bool SendEncoded(LoadClient& client, Net::PacketType type, const Msg& message, bool reliable = false)
+	{
+		size_t length = Net::EncodeMessage(message, m_messageBuffer);
+		return SendPacket(client, type, m_messageBuffer.data(), static_cast<uint16_t>(length), reliable);
+	}
+
+	void SendDue(LoadClient& client, Clock::time_point now)
+	{
+		// RTT probe: the server echoes a KEEPALIVE payload back on its next network tick
+		if (now >= client.nextProbeAt) {
+			int64_t sentAt = now.time_since_epoch().count();
+			client.nextProbeAt = now + std::chrono::milliseconds(m_config.probeIntervalMs);
+			if (!SendPacket(client, Net::PacketType::KEEPALIVE, &sentAt, sizeof(sentAt))) {
+				return;
+			}
+		}
+
+		if (!client.joined || m_script.empty() || now < client.nextStepAt) {
+			return;
+		}
+
+		const ScriptStep& step = m_script[client.nextStep];
+		client.nextStep = (client.nextStep + 1) % m_script.size();
+		client.nextStepAt += StepInterval();
+		if (client.nextStepAt < now) {
+			client.nextStepAt = now; // Don't burst to catch up after a stall
+		}
+
+		switch (step.type) {
+		case StepType::ACTION: {
+			Net::ActionPacket action = step.action;
+			char ip[16];
+			if (step.randomIp) {
+				snprintf(ip,
+						 sizeof(ip),
+						 "%u.%u.%u.%u",
+						 static_cast<unsigned>(m_rng() % 1000),
+						 static_cast<unsigned>(m_rng() % 1000),
+						 static_cast<unsigned>(m_rng() % 1000),
+						 static_cast<unsigned>(m_rng() % 1000));
+				action.data = ip;
+			} else {
+				action.data = step.data;
+			}
+			if (SendEncoded(client, Net::PacketType::PLAYER_ACTION, action, true)) {
+				Count([](LoadStats& s) { s.actionsSent++; });
+			}
+			break;
+		}
+		case StepType::CHAT: {
+			// What the game client's NetworkClient::SendChat sends; the server fills in the sender
+			Net::ChatPacket chat;
+			chat.channel = "global";
+			chat.message = step.text;
+			if (SendEncoded(client, Net::PacketType::PLAYER_CHAT, chat, true)) {
+				Count([](LoadStats& s) { s.chatsSent++; });
+			}
+			break;
+		}
+		case StepType::WAIT:
+			client.nextStepAt = now + std::chrono::milliseconds(step.waitMs);
+			break;
+		}
+	}
+
+	void Receive(LoadClient& client)
+	{
+		Net::PacketFramer& stream = client.recvStream;
+		int received = client.socket.Recv(stream.WriteBegin(), stream.WriteSpace(), 0);
+		if (received < 0) {
+			Close(client, true);
+			return;
+		}
+		if (received == 0) {
+			return;
+		}
+
+		stream.CommitWrite(static_cast<size_t>(received));
+		auto now = Clock::now();
+		Count([&](LoadStats& s) { s.bytesReceived += received; });
+
+		// Payloads are never inflated: only packet types and the (uncompressed)
+		// probe echo matter here
+		Net::PacketView packet;
+		while (stream.Next(packet)) {
+			Count([](LoadStats& s) { s.packetsReceived++; });
+
+			if ((packet.header.flags & Net::FLAG_RELIABLE) && packet.length >= Net::RELIABLE_PREFIX_SIZE) {
+				client.received = Net::ReadSequence(packet.payload);
+			}
+
+			switch (static_cast<Net::PacketType>(packet.header.type)) {
+			case Net::PacketType::TIME_SYNC:
+				if (!client.joined) {
+					client.joined = true;
+					double joinMs = ElapsedMs(client.handshakeAt, now);
+					Count([&](LoadStats& s) { s.join.Record(joinMs); });
+				} else {
+					double gapMs = ElapsedMs(client.lastTimeSync, now);
+					Count([&](LoadStats& s) { s.timeSyncGap.Record(gapMs); });
+				}
+				client.lastTimeSync = now;
+				break;
+			case Net::PacketType::KEEPALIVE:
+				if (packet.length == sizeof(int64_t) && !(packet.header.flags & Net::FLAG_COMPRESSED)) {
+					int64_t sentAt;
+					memcpy(&sentAt, packet.payload, sizeof(sentAt));
+					double rttMs = ElapsedMs(Clock::time_point(Clock::duration(sentAt)), now);
+					Count([&](LoadStats& s) { s.rtt.Record(rttMs); });
+				}
+				break;
+			case Net::PacketType::PLAYER_CHAT:
+				Count([](LoadStats& s) { s.chatsReceived++; });
+				break;
+			default:
+				break;
+			}
+		}
+
+		// One cumulative ACK per read, or the server drops us for not acknowledging
+		if (client.received != client.acknowledged) {
+			Net::AckPacket ack;
+			ack.sequence = client.received;
+			if (SendEncoded(client, Net::PacketType::ACK, ack)) {
+				client.acknowledged = client.received;
+			}
+		}
+	}
+
+	LoadConfig m_config;
+	std::vector<ScriptStep> m_script;
+	std::vector<LoadClient> m_clients;
+	std::mt19937 m_rng;
+	int m_connected;
+	std::vector<uint8_t> m_messageBuffer; // Reused to encode every message
+
+	LoadStats m_window; // Since the last periodic report
+	LoadStats m_total;
+};
+
+// ============================================================================
+// Entry Point
+// ============================================================================
+
+int LoadGenMain(int argc, char* argv[])
+{
+	printf("===========================================\n");
+	printf("  CYBRELINK LOAD GENERATOR\n");
+	printf("===========================================\n");
+
+	LoadConfig config;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--host") == 0 && hasValue) {
+			config.host = argv[++i];
+		} else if ((strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--port") == 0) && hasValue) {
+			config.port = static_cast<uint16_t>(atoi(argv[++i]));
+		} else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--clients") == 0) && hasValue) {
+			config.clients = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--rate") == 0 && hasValue) {
+			config.actionRate = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--duration") == 0 && hasValue) {
+			config.durationSec = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--ramp") == 0 && hasValue) {
+			config.rampSec = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--probe") == 0 && hasValue) {
+			config.probeIntervalMs = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--report") == 0 && hasValue) {
+			config.reportIntervalSec = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+			config.scriptPath = argv[++i];
+		} else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+			config.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+		} else {
+			printf("Usage: uplink-loadgen [options]\n");
+			printf("  --host <host>              Server host (default: localhost)\n");
+			printf("  -p, --port <port>          Server port (default: %d)\n", Net::DEFAULT_PORT);
+			printf("  -n, --clients <num>        Simulated clients (default: 100)\n");
+			printf("  --rate <steps/s>           Script steps per second per client (default: 2)\n");
+			printf("  --duration <sec>           Test length (default: 30)\n");
+			printf("  --ramp <sec>               Spread connections over this long (default: 5)\n");
+			printf("  --probe <ms>               RTT probe interval per client (default: 250)\n");
+			printf("  --report <sec>             Periodic report interval (default: 5)\n");
+			printf("  --script <file>            Action script (default: built-in mix)\n");
+			printf("  --seed <num>               Random seed (default: 1)\n");
+			return strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+	}
+
+	if (config.clients <= 0 || config.durationSec <= 0 || config.probeIntervalMs <= 0 ||
+		config.reportIntervalSec <= 0) {
+		printf("[LoadGen] ERROR: clients, duration, probe and report must be positive\n");
+		return 1;
+	}
+
+	std::vector<ScriptStep> script;
+	if (!LoadScript(config.scriptPath, script)) {
+		return 1;
+	}
+
+	LoadGenerator generator(config, std::move(script));
+	return generator.Run();
+}
+
+} // namespace LoadGen
+
+int main(int argc, char* argv[]) { return LoadGen::LoadGenMain(argc, argv); }
@@ -0,0 +1,832 @@
+/*
+ * Cybrelink Protocol Benchmarks
+ * CPU cost of the wire format, so protocol changes come with numbers
+ *
+ * Covers varints, DeltaBuffer / DeltaReader, WritePacket, the PacketFramer,
+ * the message codec, world replication and zstd at several payload sizes.
+ * World payloads are real WORLD_FULL / WORLD_DELTA messages: a synthetic
+ * ServerWorld is replicated through WorldReplicator exactly as the server
+ * does it, so they carry the server's record mix and strings.
+ *
+ * Each benchmark runs in batches of growing iteration counts until one batch
+ * takes --min-time, and that batch is reported. The JSON output has the same
+ * shape as Google Benchmark's, so its compare.py can diff two runs:
+ *   uplink-protobench --json before.json
+ *   uplink-protobench --json after.json
+ *   compare.py benchmarks before.json after.json
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "network/deltaencoder.h"
+#include "network/ipaddress.h"
+#include "network/network_sdl.h"
+#include "network/packetcompressor.h"
+#include "network/packetframer.h"
+#include "network/protocol.h"
+#include "network/worldreplication.h"
+#include "server_log.h"
+#include "server_replication.h"
+#include "server_store.h"
+#include "server_world.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ProtoBench {
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct BenchConfig {
+	double minTime = 0.5; // Seconds per reported batch
+	std::string filter; // Only benchmarks whose name contains this
+	std::string jsonPath; // Empty = console only
+	int computers = 3000; // Synthetic world size
+	int visible = 300; // Computers the replicated player knows
+	unsigned int seed = 1;
+};
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+// Keeps the compiler from dropping a result nothing else reads
+template <typename T> inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	static const volatile void* sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Handed to each benchmark body: run Iterations() times, then report totals
+class State {
+public:
+	explicit State(uint64_t iterations) : m_iterations(iterations), m_bytes(0), m_items(0) { }
+
+	uint64_t Iterations() const { return m_iterations; }
+
+	void SetBytesProcessed(uint64_t bytes) { m_bytes = bytes; }
+	void SetItemsProcessed(uint64_t items) { m_items = items; }
+
+	// Reported as is, e.g. a compression ratio
+	void SetCounter(const char* name, double value) { m_counters.emplace_back(name, value); }
+
+	uint64_t GetBytes() const { return m_bytes; }
+	uint64_t GetItems() const { return m_items; }
+	const std::vector<std::pair<std::string, double>>& GetCounters() const { return m_counters; }
+
+private:
+	uint64_t m_iterations;
+	uint64_t m_bytes;
+	uint64_t m_items;
+	std::vector<std::pair<std::string, double>> m_counters;
+};
+
+struct BenchResult {
+	std::string name;
+	uint64_t iterations;
+	double realNs; // Per iteration
+	double cpuNs;
+	double bytesPerSecond;
+	double itemsPerSecond;
+	std::vector<std::pair<std::string, double>> counters;
+};
+
+class Runner {
+public:
+	explicit Runner(const BenchConfig& config) : m_config(config) { }
+
+	void Add(std::string name, std::function<void(State&)> body)
+	{
+		if (m_config.filter.empty() || name.find(m_config.filter) != std::string::npos) {
+			m_benchmarks.emplace_back(std::move(name), std::move(body));
+		}
+	}
+
+	void RunAll()
+	{
+		printf("%-40s %14s %14s %12s %14s\n", "Benchmark", "Time", "CPU", "Iterations", "Throughput");
+		for (const auto& [name, body] : m_benchmarks) {
+			BenchResult result = Run(name, body);
+			Print(result);
+			m_results.push_back(std::move(result));
+		}
+	}
+
+	const std::vector<BenchResult>& GetResults() const { return m_results; }
+
+private:
+	BenchResult Run(const std::string& name, const std::function<void(State&)>& body) const
+	{
+		uint64_t iterations = 1;
+		for (;;) {
+			State state(iterations);
+			auto start = Clock::now();
+			std::clock_t cpuStart = std::clock();
+			body(state);
+			double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			if (seconds >= m_config.minTime || iterations >= MAX_ITERATIONS) {
+				BenchResult result;
+				result.name = name;
+				result.iterations = iterations;
+				result.realNs = seconds * 1e9 / iterations;
+				result.cpuNs = cpuSeconds * 1e9 / iterations;
+				result.bytesPerSecond = seconds > 0.0 ? state.GetBytes() / seconds : 0.0;
+				result.itemsPerSecond = seconds > 0.0 ? state.GetItems() / seconds : 0.0;
+				result.counters = state.GetCounters();
+				return result;
+			}
+
+			// Aim a little past the target, growing at most 10x per batch
+			double predicted = iterations * m_config.minTime * 1.4 / std::max(seconds, 1e-9);
+			iterations = static_cast<uint64_t>(
+				std::clamp(predicted, static_cast<double>(iterations + 1), iterations * 10.0));
+		}
+	}
+
+	static void Print(const BenchResult& result)
+	{
+		char throughput[32] = "";
+		if (result.bytesPerSecond > 0.0) {
+			snprintf(throughput, sizeof(throughput), "%.1f MiB/s", result.bytesPerSecond / (1024.0 * 1024.0));
+		} else if (result.itemsPerSecond > 0.0) {
+			snprintf(throughput, sizeof(throughput), "%.2fM items/s", result.itemsPerSecond / 1e6);
+		}
+
+		printf("%-40s %11.1f ns %11.1f ns %12llu %14s",
+			   result.name.c_str(),
+			   result.realNs,
+			   result.cpuNs,
+			   static_cast<unsigned long long>(result.iterations),
+			   throughput);
+		for (const auto& [counter, value] : result.counters) {
+			printf(" %s=%.3g", counter.c_str(), value);
+		}
+		printf("\n");
+	}
+
+	static constexpr uint64_t MAX_ITERATIONS = 1000000000;
+
+	BenchConfig m_config;
+	std::vector<std::pair<std::string, std::function<void(State&)>>> m_benchmarks;
+	std::vector<BenchResult> m_results;
+};
+
+// ============================================================================
+// Synthetic World
+// ============================================================================
+
+// Computers, missions and accounts shaped like a generated game world: game
+// IPs, company names with the usual computer suffixes, mission descriptions.
+
+class SyntheticWorldStore : public Server::WorldStore {
+public:
+	SyntheticWorldStore(int computers, unsigned int seed) : m_computers(computers), m_rng(seed) { }
+
+	const char* GetName() const override { return "synthetic"; }
+
+	bool Load(Server::WorldChangeSet& out) override
+	{
+		static const char* companies[] = { "Uplink",	"Arunmor",	 "Andromeda", "Bluestar", "Darwin",
+										   "Eclipse", "Fenwick",	 "Gordon",	 "Hallmark", "Interlock",
+										   "Jackson", "Kronos",	 "Liberty",	 "Maxwell",	 "Nexus",
+										   "Osiris",  "Pentagram", "Quantum",	 "Redline",	 "Sterling" };
+		static const struct {
+			const char* suffix;
+			int16_t type;
+		} machines[] = {
+			{ "Public Access Server", 1 }, { "Internal Services Machine", 2 }, { "Central Mainframe", 4 },
+			{ "International Bank", 8 },   { "Personal Computer", 16 },	  { "Local Area Network", 64 },
+		};
+		static const char* missions[] = {
+			"Steal important data from a rival company's file server",
+			"Destroy all files on a rival company's file server",
+			"Find financial details of an individual and transfer the balance",
+			"Change the academic record of a friend",
+			"Trace a hacker who recently broke into our systems",
+		};
+
+		std::unordered_set<int64_t> usedIps;
+		for (int i = 0; i < m_computers; i++) {
+			int64_t ip;
+			do {
+				ip = 0;
+				for (int part = 0; part < 4; part++) {
+					ip = ip * Net::IP_OCTET_RANGE + Pick(Net::IP_OCTET_RANGE);
+				}
+			} while (!usedIps.insert(ip).second);
+
+			const auto& machine = machines[Pick(std::size(machines))];
+			Server::ServerComputer computer {};
+			computer.id = i + 1;
+			computer.ip = ip;
+			computer.ipString = Net::FormatIP(ip);
+			computer.name = std::string(companies[Pick(std::size(companies))]) + " " + machine.suffix;
+			computer.type = machine.type;
+			computer.securityLevel = static_cast<int16_t>(1 + Pick(5));
+			computer.running = true;
+			out.computers.push_back(std::move(computer));
+		}
+
+		for (int i = 0; i < m_computers / 20; i++) {
+			Server::ServerMission mission {};
+			mission.id = i + 1;
+			mission.type = static_cast<int16_t>(1 + Pick(std::size(missions)));
+			mission.targetIp = out.computers[Pick(out.computers.size())].ip;
+			mission.description = missions[mission.type - 1];
+			mission.payment = static_cast<int32_t>(1000 + Pick(20) * 500);
+			mission.difficulty = static_cast<int16_t>(1 + Pick(10));
+			out.missions.push_back(std::move(mission));
+		}
+		return true;
+	}
+
+	bool Write(const Server::WorldChangeSet&) override { return true; }
+
+private:
+	int64_t Pick(size_t range) { return static_cast<int64_t>(m_rng() % range); }
+
+	int m_computers;
+	std::mt19937 m_rng;
+};
+
+// Everything the benchmarks read, built once up front
+struct Fixture {
+	Server::ServerWorld world;
+	Server::WorldReplicator replicator;
+	Server::InterestSet interest;
+	std::vector<uint8_t> worldFull; // WORLD_FULL for a player who knows config.visible computers
+	std::vector<uint8_t> worldDelta; // WORLD_DELTA after a tick of security changes
+	std::vector<std::string> names; // Computer names, for the string benchmarks
+};
+
+static const uint32_t BENCH_PLAYER_ID = 1;
+
+static bool BuildFixture(const BenchConfig& config, Fixture& fixture)
+{
+	SyntheticWorldStore store(config.computers, config.seed);
+	if (!fixture.world.Load(store)) {
+		return false;
+	}
+	fixture.world.SpawnNPCs(10);
+	fixture.world.CreatePlayerAgent(BENCH_PLAYER_ID, "benchmark", 3, 5000);
+
+	// A player some way into the game: a few hundred known links
+	const auto& computers = fixture.world.GetComputers();
+	std::mt19937 rng(config.seed);
+	int visible = std::min<int>(config.visible, static_cast<int>(computers.size()));
+	for (int i = 0; i < visible; i++) {
+		fixture.world.AddBounce(BENCH_PLAYER_ID, computers[rng() % computers.size()].ip);
+	}
+	fixture.world.ClearBounces(BENCH_PLAYER_ID);
+	fixture.world.GetVisibleComputers(BENCH_PLAYER_ID, fixture.interest.computers);
+
+	Net::DeltaBuffer buffer;
+	Server::ClientBaseline baseline;
+	fixture.replicator.Capture(fixture.world);
+	fixture.replicator.WriteFull(buffer, baseline, fixture.interest);
+	fixture.worldFull.assign(buffer.Data(), buffer.Data() + buffer.Size());
+
+	// One tick of hacking: security state flips on a few percent of computers
+	Server::WorldChangeSet changes;
+	for (size_t i = 0; i < computers.size(); i += 25) {
+		Server::ServerComputer changed = computers[i];
+		changed.proxyBypassed = true;
+		changed.securityLevel = static_cast<int16_t>(changed.securityLevel + 1);
+		changes.computers.push_back(std::move(changed));
+	}
+	fixture.world.ApplyChanges(changes);
+
+	buffer.Clear();
+	fixture.replicator.Capture(fixture.world);
+	fixture.replicator.WriteDelta(buffer, baseline, fixture.interest);
+	fixture.worldDelta.assign(buffer.Data(), buffer.Data() + buffer.Size());
+
+	for (const auto& computer : computers) {
+		fixture.names.push_back(computer.name);
+	}
+	return true;
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+// Mostly small values, like the ids, ticks and lengths the protocol carries
+static std::vector<uint32_t> VarintValues(unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<uint32_t> values(4096);
+	for (auto& value : values) {
+		uint32_t bucket = rng() % 100;
+		uint32_t bits = bucket < 50 ? 7 : bucket < 80 ? 14 : bucket < 95 ? 21 : 32;
+		value = bits == 32 ? rng() : rng() & ((1u << bits) - 1);
+	}
+	return values;
+}
+
+static void AddVarintBenchmarks(Runner& runner, const BenchConfig& config)
+{
+	auto values = std::make_shared<std::vector<uint32_t>>(VarintValues(config.seed));
+	auto encoded = std::make_shared<std::vector<uint8_t>>(values->size() * 5);
+	size_t encodedLen = 0;
+	for (uint32_t value : *values) {
+		encodedLen += Net::EncodeVarint(encoded->data() + encodedLen, value);
+	}
+	encoded->resize(encodedLen);
+
+	runner.Add("varint/encode", [values, encodedLen](State& state) {
+		std::vector<uint8_t> out(values->size() * 5);
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			size_t pos = 0;
+			for (uint32_t value : *values) {
+				pos += Net::EncodeVarint(out.data() + pos, value);
+			}
+			DoNotOptimize(out.data()[pos - 1]);
+		}
+		state.SetItemsProcessed(state.Iterations() * values->size());
+		state.SetBytesProcessed(state.Iterations() * encodedLen);
+	});
+
+	runner.Add("varint/decode", [values, encoded](State& state) {
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			const uint8_t* data = encoded->data();
+			size_t remaining = encoded->size();
+			uint32_t sum = 0;
+			while (remaining > 0) {
+				uint32_t value;
+				size_t used = Net::DecodeVarint(data, remaining, value);
+				data += used;
+				remaining -= used;
+				sum += value;
+			}
+			DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.Iterations() * values->size());
+		state.SetBytesProcessed(state.Iterations() * encoded->size());
+	});
+}
+
+static void AddDeltaBufferBenchmarks(Runner& runner, const std::shared_ptr<Fixture>& fixture)
+{
+	size_t names = std::min<size_t>(fixture->names.size(), 1024);
+	Net::DeltaBuffer written;
+	for (size_t i = 0; i < names; i++) {
+		written.WriteString(fixture->names[i]);
+	}
+	auto encoded = std::make_shared<std::vector<uint8_t>>(written.Data(), written.Data() + written.Size());
+
+	runner.Add("delta_buffer/write_string", [fixture, names, encoded](State& state) {
+		Net::DeltaBuffer buffer(encoded->size());
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			buffer.Clear();
+			for (size_t n = 0; n < names; n++) {
+				buffer.WriteString(fixture->names[n]);
+			}
+			DoNotOptimize(buffer.Data()[0]);
+		}
+		state.SetItemsProcessed(state.Iterations() * names);
+		state.SetBytesProcessed(state.Iterations() * encoded->size());
+	});
+
+	runner.Add("delta_reader/read_string", [names, encoded](State& state) {
+		std::string name;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::DeltaReader reader(encoded->data(), encoded->size());
+			for (size_t n = 0; n < names; n++) {
+				reader.ReadString(name);
+			}
+			DoNotOptimize(name.data()[0]);
+		}
+		state.SetItemsProcessed(state.Iterations() * names);
+		state.SetBytesProcessed(state.Iterations() * encoded->size());
+	});
+
+	// The record walk a client does for every WORLD_FULL, without storing anything
+	runner.Add("delta_reader/world_full", [fixture](State& state) {
+		const std::vector<uint8_t>& payload = fixture->worldFull;
+		uint64_t records = 0;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::DeltaReader reader(payload.data(), payload.size());
+			uint32_t tick;
+			reader.ReadVarint(tick);
+			while (reader.HasMore()) {
+				uint64_t key;
+				uint8_t op;
+				Net::EntityState entity;
+				if (!Net::ReadEntityHeader(reader, key, op) ||
+					(op == Net::ENTITY_UPDATE && !Net::ReadEntityFields(reader, entity))) {
+					break;
+				}
+				records++;
+			}
+		}
+		state.SetItemsProcessed(records);
+		state.SetBytesProcessed(state.Iterations() * payload.size());
+	});
+}
+
+static void AddReplicationBenchmarks(Runner& runner, const std::shared_ptr<Fixture>& fixture)
+{
+	runner.Add("replicator/capture", [fixture](State& state) {
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			fixture->replicator.Capture(fixture->world);
+		}
+		state.SetItemsProcessed(state.Iterations() * fixture->replicator.GetEntityCount());
+	});
+
+	runner.Add("replicator/write_full", [fixture](State& state) {
+		Net::DeltaBuffer buffer(fixture->worldFull.size());
+		Server::ClientBaseline baseline;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			buffer.Clear();
+			baseline.Reset();
+			fixture->replicator.WriteFull(buffer, baseline, fixture->interest);
+			DoNotOptimize(buffer.Data()[0]);
+		}
+		state.SetBytesProcessed(state.Iterations() * fixture->worldFull.size());
+	});
+
+	runner.Add("world_mirror/apply_full", [fixture](State& state) {
+		Net::WorldMirror mirror;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			mirror.ApplyFull(fixture->worldFull.data(), fixture->worldFull.size());
+		}
+		state.SetBytesProcessed(state.Iterations() * fixture->worldFull.size());
+		state.SetCounter("entities", static_cast<double>(mirror.GetEntities().size()));
+	});
+
+	runner.Add("world_mirror/apply_delta", [fixture](State& state) {
+		Net::WorldMirror mirror;
+		mirror.ApplyFull(fixture->worldFull.data(), fixture->worldFull.size());
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			mirror.ApplyDelta(fixture->worldDelta.data(), fixture->worldDelta.size());
+		}
+		state.SetBytesProcessed(state.Iterations() * fixture->worldDelta.size());
+	});
+}
+
+static void AddPacketBenchmarks(Runner& runner)
+{
+	for (size_t size : { 16, 256, 4096 }) {
+		runner.Add("packet/write/" + std::to_string(size), [size](State& state) {
+			std::vector<uint8_t> payload(size, 0x5A);
+			std::vector<uint8_t> buffer(sizeof(Net::PacketHeader) + size);
+			for (uint64_t i = 0; i < state.Iterations(); i++) {
+				size_t written = Net::WritePacket(buffer.data(),
+												  Net::PacketType::WORLD_DELTA,
+												  Net::FLAG_RELIABLE,
+												  payload.data(),
+												  static_cast<uint16_t>(size));
+				DoNotOptimize(buffer.data()[written - 1]);
+			}
+			state.SetBytesProcessed(state.Iterations() * (sizeof(Net::PacketHeader) + size));
+		});
+	}
+
+	// One recv's worth of packets through the framer: copy in, then split
+	for (size_t size : { 16, 256, 4096 }) {
+		runner.Add("framer/next/" + std::to_string(size), [size](State& state) {
+			std::vector<uint8_t> chunk;
+			std::vector<uint8_t> payload(size, 0x5A);
+			size_t packets = std::max<size_t>(1, Net::PacketFramer::RECV_CHUNK * 4 / (size + 4));
+			for (size_t p = 0; p < packets; p++) {
+				size_t offset = chunk.size();
+				chunk.resize(offset + sizeof(Net::PacketHeader) + size);
+				Net::WritePacket(chunk.data() + offset,
+								 Net::PacketType::WORLD_DELTA,
+								 Net::FLAG_NONE,
+								 payload.data(),
+								 static_cast<uint16_t>(size));
+			}
+
+			Net::PacketFramer framer;
+			for (uint64_t i = 0; i < state.Iterations(); i++) {
+				framer.Append(chunk.data(), chunk.size());
+				Net::PacketView packet;
+				while (framer.Next(packet)) {
+					DoNotOptimize(packet.payload);
+				}
+			}
+			state.SetItemsProcessed(state.Iterations() * packets);
+			state.SetBytesProcessed(state.Iterations() * chunk.size());
+		});
+	}
+}
+
+static void AddMessageBenchmarks(Runner& runner)
+{
+	Net::TimeSyncPacket timeSync;
+	timeSync.second = 42;
+	timeSync.minute = 17;
+	timeSync.hour = 14;
+	timeSync.day = 24;
+	timeSync.month = 3;
+	timeSync.year = 3010;
+	timeSync.millisecond = 500;
+	timeSync.serverTimeMs = 123456789;
+
+	runner.Add("message/encode/time_sync", [timeSync](State& state) {
+		std::vector<uint8_t> buffer;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::EncodeMessage(timeSync, buffer);
+			DoNotOptimize(buffer.data()[0]);
+		}
+		state.SetBytesProcessed(state.Iterations() * buffer.size());
+	});
+
+	runner.Add("message/decode/time_sync", [timeSync](State& state) {
+		std::vector<uint8_t> buffer;
+		Net::EncodeMessage(timeSync, buffer);
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::TimeSyncPacket decoded;
+			Net::DecodeMessage(buffer.data(), buffer.size(), decoded);
+			DoNotOptimize(decoded);
+		}
+		state.SetBytesProcessed(state.Iterations() * buffer.size());
+	});
+
+	// A busy shard's PLAYER_LIST
+	auto handles = std::make_shared<std::vector<std::string>>();
+	for (int i = 0; i < 64; i++) {
+		handles->push_back("agent" + std::to_string(i * 37));
+	}
+
+	runner.Add("message/encode/player_list_64", [handles](State& state) {
+		std::vector<Net::PlayerListEntry> entries(handles->size());
+		for (size_t i = 0; i < entries.size(); i++) {
+			entries[i].playerId = static_cast<uint32_t>(i + 1);
+			entries[i].handle = (*handles)[i];
+			entries[i].rating = static_cast<int16_t>(i % 16);
+		}
+		Net::PlayerListPacket list;
+		list.players = Net::RepeatedView<Net::PlayerListEntry>(entries.data(), entries.size());
+
+		std::vector<uint8_t> buffer;
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::EncodeMessage(list, buffer);
+			DoNotOptimize(buffer.data()[0]);
+		}
+		state.SetBytesProcessed(state.Iterations() * buffer.size());
+	});
+
+	runner.Add("message/decode/player_list_64", [handles](State& state) {
+		std::vector<Net::PlayerListEntry> entries(handles->size());
+		for (size_t i = 0; i < entries.size(); i++) {
+			entries[i].playerId = static_cast<uint32_t>(i + 1);
+			entries[i].handle = (*handles)[i];
+		}
+		Net::PlayerListPacket list;
+		list.players = Net::RepeatedView<Net::PlayerListEntry>(entries.data(), entries.size());
+		std::vector<uint8_t> buffer;
+		Net::EncodeMessage(list, buffer);
+
+		for (uint64_t i = 0; i < state.Iterations(); i++) {
+			Net::PlayerListPacket decoded;
+			Net::DecodeMessage(buffer.data(), buffer.size(), decoded);
+			uint32_t sum = 0;
+			decoded.players.ForEach([&](const Net::PlayerListEntry& entry) { sum += entry.playerId; });
+			DoNotOptimize(sum);
+		}
+		state.SetBytesProcessed(state.Iterations() * buffer.size());
+	});
+}
+
+// Payload cut into blockSize pieces, as the sender would queue them
+static std::vector<std::vector<uint8_t>> SplitBlocks(const std::vector<uint8_t>& payload, size_t blockSize)
+{
+	std::vector<std::vector<uint8_t>> blocks;
+	for (size_t offset = 0; offset + blockSize <= payload.size(); offset += blockSize) {
+		blocks.emplace_back(payload.begin() + offset, payload.begin() + offset + blockSize);
+	}
+	return blocks;
+}
+
+static void AddCompressionBenchmarks(Runner& runner, const std::shared_ptr<Fixture>& fixture)
+{
+	// Stream compression as on a connection: every block is compressed in the
+	// same zstd stream, so later blocks can match earlier ones. One iteration
+	// sends a whole WORLD_FULL in blockSize pieces on a fresh stream; the
+	// world_delta case is a single delta on a fresh stream.
+	std::vector<std::pair<std::string, std::vector<std::vector<uint8_t>>>> inputs;
+	for (size_t size : { size_t(256), size_t(1024), size_t(4096), size_t(Net::MAX_FRAGMENT_PAYLOAD) }) {
+		auto blocks = SplitBlocks(fixture->worldFull, size);
+		if (!blocks.empty()) {
+			inputs.emplace_back(std::to_string(size), std::move(blocks));
+		}
+	}
+	inputs.emplace_back("world_delta", std::vector<std::vector<uint8_t>> { fixture->worldDelta });
+
+	for (auto& [label, input] : inputs) {
+		auto blocks = std::make_shared<std::vector<std::vector<uint8_t>>>(std::move(input));
+		size_t totalBytes = 0;
+		for (const auto& block : *blocks) {
+			totalBytes += block.size();
+		}
+
+		runner.Add("zstd/compress/" + label, [blocks, totalBytes](State& state) {
+			Net::PacketCompressor compressor;
+			std::vector<uint8_t> out(Net::PacketCompressor::MaxCompressedSize((*blocks)[0].size()));
+			uint64_t compressedBytes = 0;
+			for (uint64_t i = 0; i < state.Iterations(); i++) {
+				compressor.Reset();
+				for (const auto& block : *blocks) {
+					compressedBytes +=
+						compressor.Compress(block.data(), block.size(), out.data(), out.size());
+				}
+			}
+			state.SetItemsProcessed(state.Iterations() * blocks->size());
+			state.SetBytesProcessed(state.Iterations() * totalBytes);
+			double inputBytes = static_cast<double>(state.Iterations() * totalBytes);
+			state.SetCounter("ratio", compressedBytes ? inputBytes / compressedBytes : 0.0);
+		});
+
+		runner.Add("zstd/decompress/" + label, [blocks, totalBytes](State& state) {
+			// Compressed once as one stream; every iteration replays it from the start
+			Net::PacketCompressor compressor;
+			std::vector<std::vector<uint8_t>> compressed;
+			for (const auto& block : *blocks) {
+				std::vector<uint8_t> out(Net::PacketCompressor::MaxCompressedSize(block.size()));
+				out.resize(compressor.Compress(block.data(), block.size(), out.data(), out.size()));
+				compressed.push_back(std::move(out));
+			}
+
+			Net::PacketDecompressor decompressor;
+			for (uint64_t i = 0; i < state.Iterations(); i++) {
+				decompressor.Reset();
+				for (const auto& block : compressed) {
+					const uint8_t* out;
+					size_t outLen;
+					decompressor.Decompress(block.data(), block.size(), out, outLen);
+					DoNotOptimize(out);
+				}
+			}
+			state.SetItemsProcessed(state.Iterations() * compressed.size());
+			state.SetBytesProcessed(state.Iterations() * totalBytes);
+		});
+	}
+}
+
+// ============================================================================
+// JSON Output
+// ============================================================================
+
+static bool WriteJson(const std::string& path,
+					  const char* executable,
+					  const BenchConfig& config,
+					  const Fixture& fixture,
+					  const std::vector<BenchResult>& results)
+{
+	char date[32];
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	nlohmann::json context = {
+		{ "date", date },
+		{ "executable", executable },
+		{ "num_cpus", std::thread::hardware_concurrency() },
+#ifdef NDEBUG
+		{ "library_build_type", "release" },
+#else
+		{ "library_build_type", "debug" },
+#endif
+		{ "protocol_version", Net::PROTOCOL_VERSION },
+		{ "world_computers", config.computers },
+		{ "world_visible_computers", fixture.interest.computers.size() },
+		{ "world_full_bytes", fixture.worldFull.size() },
+		{ "world_delta_bytes", fixture.worldDelta.size() },
+		{ "seed", config.seed },
+	};
+
+	nlohmann::json benchmarks = nlohmann::json::array();
+	for (const BenchResult& result : results) {
+		nlohmann::json entry = {
+			{ "name", result.name },
+			{ "run_name", result.name },
+			{ "run_type", "iteration" },
+			{ "iterations", result.iterations },
+			{ "real_time", result.realNs },
+			{ "cpu_time", result.cpuNs },
+			{ "time_unit", "ns" },
+		};
+		if (result.bytesPerSecond > 0.0) {
+			entry["bytes_per_second"] = result.bytesPerSecond;
+		}
+		if (result.itemsPerSecond > 0.0) {
+			entry["items_per_second"] = result.itemsPerSecond;
+		}
+		for (const auto& [counter, value] : result.counters) {
+			entry[counter] = value;
+		}
+		benchmarks.push_back(std::move(entry));
+	}
+
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+	file << nlohmann::json { { "context", context }, { "benchmarks", benchmarks } }.dump(2) << "\n";
+	return static_cast<bool>(file);
+}
+
+// ============================================================================
+// Entry Point
+// ============================================================================
+
+int ProtoBenchMain(int argc, char* argv[])
+{
+	BenchConfig config;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--json") == 0 && hasValue) {
+			config.jsonPath = argv[++i];
+		} else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+			config.filter = argv[++i];
+		} else if (strcmp(argv[i], "--min-time") == 0 && hasValue) {
+			config.minTime = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--computers") == 0 && hasValue) {
+			config.computers = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--visible") == 0 && hasValue) {
+			config.visible = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+			config.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+		} else {
+			printf("Usage: uplink-protobench [options]\n");
+			printf("  --json <file>              Also write results as JSON\n");
+			printf("  --filter <text>            Only benchmarks whose name contains text\n");
+			printf("  --min-time <sec>           Time per reported batch (default: 0.5)\n");
+			printf("  --computers <num>          Synthetic world size (default: 3000)\n");
+			printf("  --visible <num>            Computers the replicated player knows (default: 300)\n");
+			printf("  --seed <num>               Random seed (default: 1)\n");
+			return strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+	}
+
+	if (config.computers <= 0 || config.visible < 0 || config.minTime <= 0.0) {
+		printf("[ProtoBench] ERROR: computers and min-time must be positive\n");
+		return 1;
+	}
+
+	// World loading is chatty at INFO; only problems matter here
+	Server::Logger::Instance().SetLevel(Server::LogLevel::WARN);
+
+	auto fixture = std::make_shared<Fixture>();
+	if (!BuildFixture(config, *fixture)) {
+		printf("[ProtoBench] ERROR: could not build the synthetic world\n");
+		return 1;
+	}
+	printf("[ProtoBench] World: %d computers, %zu visible | WORLD_FULL %zu bytes, WORLD_DELTA %zu bytes\n",
+		   config.computers,
+		   fixture->interest.computers.size(),
+		   fixture->worldFull.size(),
+		   fixture->worldDelta.size());
+
+	Runner runner(config);
+	AddVarintBenchmarks(runner, config);
+	AddDeltaBufferBenchmarks(runner, fixture);
+	AddReplicationBenchmarks(runner, fixture);
+	AddPacketBenchmarks(runner);
+	AddMessageBenchmarks(runner);
+	AddCompressionBenchmarks(runner, fixture);
+	runner.RunAll();
+
+	if (!config.jsonPath.empty()) {
+		if (!WriteJson(config.jsonPath, argv[0], config, *fixture, runner.GetResults())) {
+			printf("[ProtoBench] ERROR: could not write %s\n", config.jsonPath.c_str());
+			return 1;
+		}
+		printf("[ProtoBench] Results written to %s\n", config.jsonPath.c_str());
+	}
+	return 0;
+}
+
+} // namespace ProtoBench
+
+int main(int argc, char* argv[]) { return ProtoBench::ProtoBenchMain(argc, argv); }
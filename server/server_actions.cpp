@@ -0,0 +1,101 @@
+/*
+ * Player action pipeline implementation
+ */
+
+#include "server_actions.h"
+#include "server_log.h"
+
+#include <algorithm>
+
+namespace Server {
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+void TokenBucket::Configure(double ratePerSecond, double burst, std::chrono::steady_clock::time_point now)
+{
+	m_rate = ratePerSecond;
+	m_burst = burst;
+	m_tokens = burst;
+	m_lastRefill = now;
+}
+
+bool TokenBucket::TryTake(std::chrono::steady_clock::time_point now)
+{
+	double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+	m_lastRefill = now;
+	m_tokens = std::min(m_burst, m_tokens + elapsed * m_rate);
+
+	if (m_tokens < 1.0) {
+		return false;
+	}
+	m_tokens -= 1.0;
+	return true;
+}
+
+// ============================================================================
+// ActionQueue
+// ============================================================================
+
+void ActionQueue::Push(uint32_t playerId, const Net::ActionPacket& packet)
+{
+	QueuedAction queued;
+	queued.playerId = playerId;
+	queued.sequence = m_nextSequence++;
+	queued.packet = packet;
+	queued.packet.data = {};
+	queued.dataOffset = static_cast<uint32_t>(m_data.size());
+	queued.dataLength = static_cast<uint32_t>(packet.data.size());
+	queued.targetIp = 0;
+	queued.valid = false;
+	m_actions.push_back(queued);
+	m_data.insert(m_data.end(), packet.data.begin(), packet.data.end());
+}
+
+void ActionQueue::Sort()
+{
+	// Sequence numbers are unique, so the order is total and std::sort is enough
+	std::sort(m_actions.begin(), m_actions.end(), [](const QueuedAction& a, const QueuedAction& b) {
+		return a.playerId != b.playerId ? a.playerId < b.playerId : a.sequence < b.sequence;
+	});
+}
+
+void ActionQueue::RemovePlayer(uint32_t playerId)
+{
+	m_actions.erase(std::remove_if(m_actions.begin(),
+								   m_actions.end(),
+								   [playerId](const QueuedAction& a) { return a.playerId == playerId; }),
+					m_actions.end());
+}
+
+// ============================================================================
+// ActionStats
+// ============================================================================
+
+void ActionStats::Reset()
+{
+	received = 0;
+	malformed = 0;
+	rateLimited = 0;
+	rejected = 0;
+	applied = 0;
+	largestBatch = 0;
+}
+
+void ActionStats::Print(double windowSeconds) const
+{
+	LogInfo(LogCategory::TIMING,
+			"%.0fs window | actions received %llu (%.1f/s) | applied %llu | rejected %llu"
+			" | rate limited %llu | malformed %llu | largest batch %zu",
+			windowSeconds,
+			static_cast<unsigned long long>(received),
+			windowSeconds > 0.0 ? received / windowSeconds : 0.0,
+			static_cast<unsigned long long>(applied),
+			static_cast<unsigned long long>(rejected),
+			static_cast<unsigned long long>(rateLimited),
+			static_cast<unsigned long long>(malformed),
+			largestBatch);
+}
+
+} // namespace Server
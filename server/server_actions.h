@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+ * Player action pipeline - rate limiting and the per-tick command buffer
+ *
+ * Actions don't run when their packet arrives. HandlePlayerAction charges the
+ * sender's token bucket and queues the action; once per game tick the queue is
+ * put into a deterministic order, validated as a batch against ServerWorld and
+ * applied. Outcomes are counted rather than logged and reported with the tick
+ * timing summary.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "network/protocol.h"
+
+namespace Server {
+
+// ============================================================================
+// Token Bucket
+// ============================================================================
+
+// Refills at ratePerSecond up to burst tokens; each action costs one. Actions
+// from an empty bucket are dropped, so a flooding client gets at most its
+// sustained rate into the tick no matter how much it sends.
+
+class TokenBucket {
+public:
+	TokenBucket() : m_rate(0.0), m_burst(0.0), m_tokens(0.0) { }
+
+	// Starts full
+	void Configure(double ratePerSecond, double burst, std::chrono::steady_clock::time_point now);
+
+	bool TryTake(std::chrono::steady_clock::time_point now);
+
+private:
+	double m_rate;
+	double m_burst;
+	double m_tokens;
+	std::chrono::steady_clock::time_point m_lastRefill;
+};
+
+// ============================================================================
+// Action Queue
+// ============================================================================
+
+struct QueuedAction {
+	uint32_t playerId;
+	uint32_t sequence; // Arrival order - keeps one player's actions in the order sent
+	Net::ActionPacket packet; // packet.data is not kept - see ActionQueue::GetData
+	uint32_t dataOffset; // packet.data's bytes in the queue's buffer
+	uint32_t dataLength;
+	int64_t targetIp; // Resolved during validation (ADD_BOUNCE, CONNECT_TARGET)
+	bool valid;
+};
+
+class ActionQueue {
+public:
+	ActionQueue() : m_nextSequence(0) { }
+
+	// Copies packet.data, which points into the receive buffer
+	void Push(uint32_t playerId, const Net::ActionPacket& packet);
+
+	// Apply order: player id, then arrival. Doesn't depend on the order sockets
+	// happened to be serviced in during the tick.
+	void Sort();
+
+	std::vector<QueuedAction>& GetActions() { return m_actions; }
+	size_t Size() const { return m_actions.size(); }
+	bool Empty() const { return m_actions.empty(); }
+
+	// The action's data field, valid until Clear
+	std::string_view GetData(const QueuedAction& action) const
+	{
+		return std::string_view(m_data.data() + action.dataOffset, action.dataLength);
+	}
+
+	// Keeps capacity for the next tick
+	void Clear()
+	{
+		m_actions.clear();
+		m_data.clear();
+	}
+
+	// Drop a player's unprocessed actions (their session was suspended and the
+	// client will send them again if it resumes)
+	void RemovePlayer(uint32_t playerId);
+
+private:
+	std::vector<QueuedAction> m_actions;
+	std::vector<char> m_data; // Every queued action's data, back to back
+	uint32_t m_nextSequence;
+};
+
+// ============================================================================
+// Action Stats
+// ============================================================================
+
+struct ActionStats {
+	uint64_t received = 0; // PLAYER_ACTION packets from authenticated players
+	uint64_t malformed = 0; // Not a well-formed ActionPacket
+	uint64_t rateLimited = 0; // Dropped by the sender's token bucket
+	uint64_t rejected = 0; // Failed validation (unknown target, bad amount, ...)
+	uint64_t applied = 0;
+	size_t largestBatch = 0; // Most actions processed in one tick
+
+	void Reset();
+
+	// One summary line in the TIMING log category
+	void Print(double windowSeconds) const;
+};
+
+} // namespace Server
@@ -19,16 +19,16 @@ ServerDate::ServerDate() :
 	day(1),
 	month(1),
 	year(1000),
+	pendingSeconds(0.0),
 	updateme(false)
 {
-	previousUpdate = std::chrono::steady_clock::now();
 }
 
 ServerDate::ServerDate(int newsecond, int newminute, int newhour, int newday, int newmonth, int newyear) :
+	pendingSeconds(0.0),
 	updateme(false)
 {
 	SetDate(newsecond, newminute, newhour, newday, newmonth, newyear);
-	previousUpdate = std::chrono::steady_clock::now();
 }
 
 void ServerDate::SetDate(ServerDate* copydate)
@@ -170,19 +170,18 @@ char* ServerDate::GetLongString()
 	return tempdate;
 }
 
-void ServerDate::Update()
+void ServerDate::Update(double deltaSeconds)
 {
 	if (!updateme) {
 		return;
 	}
 
-	auto now = std::chrono::steady_clock::now();
-	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - previousUpdate).count();
-
-	// Normal speed: 1 real second = 1 game second
-	if (elapsed >= 1000) {
-		AdvanceSecond(1);
-		previousUpdate = now;
+	// Keep the fractional remainder so the clock doesn't drift by a tick per second
+	pendingSeconds += deltaSeconds;
+	if (pendingSeconds >= 1.0) {
+		int whole = static_cast<int>(pendingSeconds);
+		AdvanceSecond(whole);
+		pendingSeconds -= whole;
 	}
 }
 
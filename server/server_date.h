@@ -6,7 +6,6 @@
  */
 
 #include <cstdio>
-#include <chrono>
 
 namespace Server {
 
@@ -19,7 +18,7 @@ protected:
 	int month;
 	int year;
 
-	std::chrono::steady_clock::time_point previousUpdate;
+	double pendingSeconds; // Simulated time not yet applied as whole seconds
 	bool updateme;
 
 public:
@@ -46,11 +45,13 @@ public:
 	int GetDay() const { return day; }
 	int GetMonth() const { return month; }
 	int GetYear() const { return year; }
+	int GetMillisecond() const { return static_cast<int>(pendingSeconds * 1000.0); }
 
 	static const char* GetMonthName(int month);
 	char* GetLongString();
 
-	void Update();
+	// Advance by simulated time (one fixed game tick); 1 game second per real second
+	void Update(double deltaSeconds);
 };
 
 } // namespace Server
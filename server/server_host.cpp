@@ -0,0 +1,348 @@
+/*
+ * Server host implementation
+ */
+
+#include "server_host.h"
+#include "server_log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Server {
+
+// ============================================================================
+// HomeShardTable
+// ============================================================================
+
+void HomeShardTable::Add(const std::string& handle, int shard)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [it, inserted] = m_entries.try_emplace(handle, Entry { shard, 0 });
+	if (it->second.shard != shard) {
+		it->second = { shard, 0 }; // The newest session wins
+	}
+	it->second.sessions++;
+}
+
+void HomeShardTable::Remove(const std::string& handle, int shard)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(handle);
+	if (it != m_entries.end() && it->second.shard == shard && --it->second.sessions <= 0) {
+		m_entries.erase(it);
+	}
+}
+
+int HomeShardTable::Find(const std::string& handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(handle);
+	return it != m_entries.end() ? it->second.shard : -1;
+}
+
+// ============================================================================
+// ServerHost
+// ============================================================================
+
+// Longest the accept loop sleeps in Poll, so Stop is noticed promptly
+static const uint32_t ACCEPT_POLL_MS = 100;
+
+// With several shards, everything a shard thread logs starts with "shard <n>: "
+static void LabelShardThread(const ServerConfig& config, int shardIndex)
+{
+	if (config.shards <= 1) {
+		return;
+	}
+	char label[16];
+	snprintf(label, sizeof(label), "shard %d", shardIndex);
+	Logger::SetThreadLabel(label);
+}
+
+// Handle from a HANDSHAKE packet, empty for anything else
+static std::string HandshakeHandle(const Net::PacketView& packet)
+{
+	Net::HandshakePacket handshake;
+	if (static_cast<Net::PacketType>(packet.header.type) != Net::PacketType::HANDSHAKE ||
+		!Net::DecodeMessage(packet.payload, packet.length, handshake)) {
+		return "";
+	}
+	return std::string(handshake.handle);
+}
+
+ServerHost::ServerHost() :
+	m_running(false),
+	m_initialized(false),
+	m_nextPlayerId(1)
+{
+}
+
+ServerHost::~ServerHost() { Shutdown(); }
+
+bool ServerHost::Init(const ServerConfig& config)
+{
+	m_config = config;
+
+	LogInfo(LogCategory::SERVER,
+			"Initializing on port %d (%d shard%s, max %d players each)",
+			config.port,
+			config.shards,
+			config.shards == 1 ? "" : "s",
+			config.maxPlayers);
+
+	// Initialize Supabase
+	if (!config.supabaseUrl.empty()) {
+		LogInfo(LogCategory::SERVER, "Connecting to Supabase at %s", config.supabaseUrl.c_str());
+		Net::SupabaseClient::Instance().Init(config.supabaseUrl, config.supabaseKey);
+		Net::SupabaseClient::Instance().StartWorkers(config.supabaseWorkers);
+	} else {
+		LogWarn(LogCategory::SERVER, "Supabase URL not configured, accounts are not verified");
+	}
+
+	// Initialize networking (the shared socket set holds the listen socket plus
+	// connections waiting for a handshake; each shard polls its own set)
+	Net::NetResult result = Net::NetInit(MAX_PENDING_CONNECTIONS + 1);
+	if (result != Net::NetResult::OK) {
+		LogError(LogCategory::SERVER, "Failed to initialize networking");
+		return false;
+	}
+
+	// Start listening
+	result = Net::NetworkManager::Instance().Listen(config.port);
+	if (result != Net::NetResult::OK) {
+		LogError(LogCategory::SERVER, "Failed to listen on port %d", config.port);
+		return false;
+	}
+
+	LogInfo(LogCategory::SERVER, "Listening on port %d", config.port);
+
+	m_initialized = true;
+
+	for (int i = 0; i < config.shards; i++) {
+		auto shard = std::make_unique<GameServer>();
+		LabelShardThread(config, i);
+		bool ok = shard->Init(config, i, &m_homeShards);
+		Logger::SetThreadLabel("");
+
+		if (!ok) {
+			LogError(LogCategory::SERVER, "Failed to initialize shard %d", i);
+			return false;
+		}
+		m_shards.push_back(std::move(shard));
+	}
+
+	m_running = true;
+
+	LogInfo(LogCategory::SERVER, "Initialization complete");
+	return true;
+}
+
+void ServerHost::Run()
+{
+	for (size_t i = 0; i < m_shards.size(); i++) {
+		GameServer* shard = m_shards[i].get();
+		m_threads.emplace_back([this, shard]() {
+			LabelShardThread(m_config, shard->GetIndex());
+			shard->Run();
+		});
+	}
+
+	LogInfo(LogCategory::SERVER, "Accepting connections");
+
+	while (m_running) {
+		if (Net::NetworkManager::Instance().Poll(ACCEPT_POLL_MS) > 0) {
+			AcceptConnections();
+			ReadPending();
+		}
+		ExpirePending(std::chrono::steady_clock::now());
+	}
+
+	StopShards();
+}
+
+void ServerHost::Stop() { m_running = false; }
+
+void ServerHost::StopShards()
+{
+	for (auto& shard : m_shards) {
+		shard->Stop();
+	}
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+void ServerHost::Shutdown()
+{
+	if (!m_initialized) {
+		return;
+	}
+
+	m_initialized = false;
+	m_running = false;
+
+	LogInfo(LogCategory::SERVER, "Shutting down...");
+
+	// Stop listening
+	Net::NetworkManager::Instance().StopListening();
+
+	for (auto& pending : m_pending) {
+		Net::NetworkManager::Instance().Unwatch(pending.socket);
+	}
+	m_pending.clear(); // Closes their sockets
+
+	// Shards disconnect their players and flush their worlds once their loops are done
+	StopShards();
+	for (auto& shard : m_shards) {
+		LabelShardThread(m_config, shard->GetIndex());
+		shard->Shutdown();
+		Logger::SetThreadLabel("");
+	}
+	m_shards.clear();
+
+	// Let queued Supabase writes finish; callbacks for departed players are no-ops
+	Net::SupabaseClient::Instance().StopWorkers();
+	Net::SupabaseClient::Instance().PollCompletions();
+
+	// Cleanup networking
+	Net::NetShutdown();
+
+	LogInfo(LogCategory::SERVER, "Shutdown complete");
+}
+
+void ServerHost::AcceptConnections()
+{
+	Net::Socket* newSocket = Net::NetworkManager::Instance().Accept();
+	if (!newSocket) {
+		return; // No pending connection
+	}
+
+	// Reject rather than leave the connection pending, otherwise the listen
+	// socket stays readable and Poll would return immediately forever
+	if (static_cast<int>(m_pending.size()) >= MAX_PENDING_CONNECTIONS ||
+		!Net::NetworkManager::Instance().Watch(*newSocket)) {
+		LogWarn(LogCategory::NET,
+				"REJECT: Connection from %s (too many waiting for a handshake)",
+				newSocket->GetRemoteIP().c_str());
+		newSocket->Close();
+		delete newSocket;
+		return;
+	}
+
+	PendingConnection pending;
+	pending.socket = std::move(*newSocket);
+	pending.acceptedAt = std::chrono::steady_clock::now();
+	delete newSocket;
+
+	LogDebug(LogCategory::NET, "ACCEPT: Connection from %s", pending.socket.GetRemoteIP().c_str());
+
+	m_pending.push_back(std::move(pending));
+}
+
+void ServerHost::ReadPending()
+{
+	for (auto& pending : m_pending) {
+		if (!pending.socket.IsReady()) {
+			continue;
+		}
+
+		Net::PacketFramer& stream = pending.received;
+		int received = pending.socket.Recv(stream.WriteBegin(), stream.WriteSpace(), 0);
+		if (received < 0) {
+			LogDebug(LogCategory::NET,
+					 "Connection from %s closed before its handshake",
+					 pending.socket.GetRemoteIP().c_str());
+			Net::NetworkManager::Instance().Unwatch(pending.socket);
+			pending.socket.Close();
+			continue;
+		}
+		stream.CommitWrite(static_cast<size_t>(received));
+
+		Net::PacketView first;
+		if (stream.Peek(first)) {
+			HandOver(pending, first);
+		}
+	}
+
+	// Handed over or closed
+	m_pending.erase(std::remove_if(m_pending.begin(),
+								   m_pending.end(),
+								   [](const PendingConnection& p) { return !p.socket.IsValid(); }),
+					m_pending.end());
+}
+
+void ServerHost::ExpirePending(std::chrono::steady_clock::time_point now)
+{
+	auto timeout = std::chrono::milliseconds(m_config.connectionTimeoutMs);
+
+	for (auto& pending : m_pending) {
+		if (now - pending.acceptedAt > timeout) {
+			LogInfo(LogCategory::NET,
+					"DISCONNECT: %s - no handshake",
+					pending.socket.GetRemoteIP().c_str());
+			Net::NetworkManager::Instance().Unwatch(pending.socket);
+			pending.socket.Close();
+		}
+	}
+
+	m_pending.erase(std::remove_if(m_pending.begin(),
+								   m_pending.end(),
+								   [](const PendingConnection& p) { return !p.socket.IsValid(); }),
+					m_pending.end());
+}
+
+void ServerHost::HandOver(PendingConnection& pending, const Net::PacketView& first)
+{
+	Net::NetworkManager::Instance().Unwatch(pending.socket);
+
+	// The first packet stays buffered for the shard to dispatch
+	std::string handle = HandshakeHandle(first);
+
+	int index = ChooseShard(handle);
+	if (index < 0) {
+		LogWarn(LogCategory::NET,
+				"REJECT: Connection from %s (server full)",
+				pending.socket.GetRemoteIP().c_str());
+		pending.socket.Close();
+		return;
+	}
+
+	// Ids are taken in hand-over order, so each shard receives them ascending
+	uint32_t playerId = m_nextPlayerId++;
+	LogDebug(LogCategory::NET,
+			 "ROUTE: Player #%u '%s' from %s to shard %d",
+			 playerId,
+			 handle.c_str(),
+			 pending.socket.GetRemoteIP().c_str(),
+			 index);
+
+	m_shards[index]->Adopt(playerId, std::move(pending.socket), std::move(pending.received));
+}
+
+int ServerHost::ChooseShard(const std::string& handle) const
+{
+	// Back to the shard holding this handle's session, while it has room
+	if (!handle.empty()) {
+		int index = m_homeShards.Find(handle);
+		if (index >= 0) {
+			const GameServer& home = *m_shards[index];
+			if (home.IsRunning() && home.GetLoad() < m_config.maxPlayers) {
+				return index;
+			}
+		}
+	}
+
+	// Otherwise the least loaded shard
+	int best = -1;
+	int bestLoad = m_config.maxPlayers;
+	for (const auto& shard : m_shards) {
+		int load = shard->GetLoad();
+		if (shard->IsRunning() && load < bestLoad) {
+			best = shard->GetIndex();
+			bestLoad = load;
+		}
+	}
+	return best;
+}
+
+} // namespace Server
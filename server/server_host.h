@@ -0,0 +1,96 @@
+#pragma once
+
+/*
+ * Server host - the listen socket in front of one or more world shards
+ *
+ * Every shard (GameServer) runs its own world and tick loop on its own thread,
+ * with its own players and socket set. The host thread accepts connections,
+ * holds each one until its first packet arrives and then hands it over: to the
+ * shard holding a session for the same handle, otherwise the least loaded one.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gameserver.h"
+
+namespace Server {
+
+// ============================================================================
+// Home Shards
+// ============================================================================
+
+// Handle -> shard holding its session, so a reconnect lands where it can
+// resume. Shards add a handle only once they have authenticated it and remove
+// it when the session ends, so the table never outgrows the live and suspended
+// sessions.
+
+class HomeShardTable {
+public:
+	// Any thread
+	void Add(const std::string& handle, int shard);
+	void Remove(const std::string& handle, int shard); // Ignored unless handle is on shard
+	int Find(const std::string& handle) const; // -1 = no session
+
+private:
+	struct Entry {
+		int shard;
+		int sessions; // Guests may share a handle
+	};
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, Entry> m_entries; // Guarded by m_mutex
+};
+
+// ============================================================================
+// Server Host
+// ============================================================================
+
+class ServerHost {
+public:
+	// Accepted connections still waiting for their first packet
+	static constexpr int MAX_PENDING_CONNECTIONS = 64;
+
+	ServerHost();
+	~ServerHost();
+
+	// Lifecycle
+	bool Init(const ServerConfig& config);
+	void Run(); // Starts the shard threads, then accepts on the calling thread until Stop
+	void Stop(); // Any thread
+	void Shutdown();
+
+private:
+	// Accepted, not yet handed to a shard
+	struct PendingConnection {
+		Net::Socket socket;
+		Net::PacketFramer received; // Handed over with the socket, so nothing is read twice
+		std::chrono::steady_clock::time_point acceptedAt;
+	};
+
+	void AcceptConnections();
+	void ReadPending(); // Hand over every pending connection whose first packet is complete
+	void ExpirePending(std::chrono::steady_clock::time_point now);
+	void HandOver(PendingConnection& pending, const Net::PacketView& first); // first is still buffered
+	int ChooseShard(const std::string& handle) const; // -1 = every shard is full
+	void StopShards();
+
+	ServerConfig m_config;
+	std::atomic<bool> m_running;
+	bool m_initialized;
+
+	std::vector<std::unique_ptr<GameServer>> m_shards;
+	std::vector<std::thread> m_threads; // One per shard, while Run is active
+
+	std::vector<PendingConnection> m_pending;
+	HomeShardTable m_homeShards;
+	uint32_t m_nextPlayerId; // Unique across shards
+};
+
+} // namespace Server
@@ -0,0 +1,193 @@
+#pragma once
+
+/*
+ * Entity indexes - open-addressing hash tables over ServerWorld's vectors
+ * Map a key (IP, mission id, bank account) to a position in an entity vector
+ * with one flat allocation and no per-entry nodes.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Server {
+
+// ============================================================================
+// Key Hashing
+// ============================================================================
+
+// SplitMix64 finalizer - spreads sequential ids and packed IPs over all bits
+inline uint64_t HashKey(uint64_t key)
+{
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ull;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebull;
+	key ^= key >> 31;
+	return key;
+}
+
+inline uint64_t HashKey(uint64_t key, const std::string& text)
+{
+	uint64_t hash = 14695981039346656037ull; // FNV-1a
+	for (unsigned char c : text) {
+		hash = (hash ^ c) * 1099511628211ull;
+	}
+	return HashKey(key ^ hash);
+}
+
+// ============================================================================
+// Entity Index
+// ============================================================================
+
+// Linear probing table of (hash, position) slots. Keys themselves live in the
+// entity vector: Find() takes a predicate that compares the entity at a
+// candidate position, so one index type serves any key. Erase uses backward
+// shift instead of tombstones, so lookups never slow down with churn.
+// Capacity is a power of two, kept at most 3/4 full.
+
+class EntityIndex {
+public:
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	EntityIndex() : m_count(0) { }
+
+	void Clear()
+	{
+		m_slots.clear();
+		m_count = 0;
+	}
+
+	void Reserve(size_t count)
+	{
+		size_t capacity = 16;
+		while (capacity * 3 / 4 < count) {
+			capacity *= 2;
+		}
+		if (capacity > m_slots.size()) {
+			Rehash(capacity);
+		}
+	}
+
+	size_t Size() const { return m_count; }
+
+	// Position of the first entry with this hash for which matches(position)
+	// is true, or NONE
+	template <typename Match> uint32_t Find(uint64_t hash, const Match& matches) const
+	{
+		if (m_count == 0) {
+			return NONE;
+		}
+
+		size_t mask = m_slots.size() - 1;
+		uint32_t tag = Tag(hash);
+		for (size_t i = hash & mask;; i = (i + 1) & mask) {
+			const Slot& slot = m_slots[i];
+			if (slot.position == NONE) {
+				return NONE;
+			}
+			if (slot.tag == tag && matches(slot.position)) {
+				return slot.position;
+			}
+		}
+	}
+
+	// Caller guarantees the key isn't indexed yet
+	void Insert(uint64_t hash, uint32_t position)
+	{
+		if ((m_count + 1) * 4 > m_slots.size() * 3) {
+			Rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+		}
+		Place(Slot { Tag(hash), position }, hash);
+		m_count++;
+	}
+
+	// Remove the entry for position; false if it wasn't indexed under hash
+	bool Erase(uint64_t hash, uint32_t position)
+	{
+		size_t i;
+		if (!Locate(hash, position, i)) {
+			return false;
+		}
+
+		// Backward shift: pull later entries of the probe run into the hole
+		size_t mask = m_slots.size() - 1;
+		size_t hole = i;
+		for (size_t j = (i + 1) & mask; m_slots[j].position != NONE; j = (j + 1) & mask) {
+			size_t home = m_slots[j].home & mask;
+			if (((j - home) & mask) >= ((j - hole) & mask)) {
+				m_slots[hole] = m_slots[j];
+				hole = j;
+			}
+		}
+		m_slots[hole] = Slot {};
+		m_count--;
+		return true;
+	}
+
+	// An entity moved within its vector (e.g. swap-and-pop removal)
+	bool Move(uint64_t hash, uint32_t from, uint32_t to)
+	{
+		size_t i;
+		if (!Locate(hash, from, i)) {
+			return false;
+		}
+		m_slots[i].position = to;
+		return true;
+	}
+
+private:
+	struct Slot {
+		uint32_t tag = 0; // High hash bits - skips most predicate calls
+		uint32_t position = NONE; // NONE = empty
+		uint32_t home = 0; // Low hash bits - the slot this entry probes from
+	};
+
+	static uint32_t Tag(uint64_t hash) { return static_cast<uint32_t>(hash >> 32); }
+
+	bool Locate(uint64_t hash, uint32_t position, size_t& out) const
+	{
+		if (m_count == 0) {
+			return false;
+		}
+
+		size_t mask = m_slots.size() - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask) {
+			if (m_slots[i].position == NONE) {
+				return false;
+			}
+			if (m_slots[i].position == position) {
+				out = i;
+				return true;
+			}
+		}
+	}
+
+	void Place(Slot slot, uint64_t hash)
+	{
+		slot.home = static_cast<uint32_t>(hash);
+		size_t mask = m_slots.size() - 1;
+		size_t i = hash & mask;
+		while (m_slots[i].position != NONE) {
+			i = (i + 1) & mask;
+		}
+		m_slots[i] = slot;
+	}
+
+	void Rehash(size_t capacity)
+	{
+		std::vector<Slot> old;
+		old.swap(m_slots);
+		m_slots.resize(capacity);
+		for (const Slot& slot : old) {
+			if (slot.position != NONE) {
+				Place(slot, (static_cast<uint64_t>(slot.tag) << 32) | slot.home);
+			}
+		}
+	}
+
+	std::vector<Slot> m_slots;
+	size_t m_count;
+};
+
+} // namespace Server
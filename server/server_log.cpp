@@ -0,0 +1,359 @@
+/*
+ * Server logging implementation
+ */
+
+#include "server_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace Server {
+
+// ============================================================================
+// Levels and Categories
+// ============================================================================
+
+static const char* const LEVEL_NAMES[] = { "debug", "info", "warn", "error", "off" };
+
+static const char* const CATEGORY_NAMES[] = {
+	"server", "net", "auth", "chat", "action", "world", "npc", "economy", "store", "timing",
+};
+
+static_assert(sizeof(CATEGORY_NAMES) / sizeof(CATEGORY_NAMES[0]) == static_cast<size_t>(LogCategory::COUNT),
+			  "CATEGORY_NAMES out of step with LogCategory");
+
+const char* LogLevelName(LogLevel level) { return LEVEL_NAMES[static_cast<size_t>(level)]; }
+
+const char* LogCategoryName(LogCategory category) { return CATEGORY_NAMES[static_cast<size_t>(category)]; }
+
+bool ParseLogLevel(const char* text, LogLevel& out)
+{
+	for (size_t i = 0; i < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]); i++) {
+		if (strcmp(text, LEVEL_NAMES[i]) == 0) {
+			out = static_cast<LogLevel>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ParseLogCategory(const char* text, LogCategory& out)
+{
+	for (size_t i = 0; i < static_cast<size_t>(LogCategory::COUNT); i++) {
+		if (strcmp(text, CATEGORY_NAMES[i]) == 0) {
+			out = static_cast<LogCategory>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+// ============================================================================
+// Logger
+// ============================================================================
+
+// Set by SetThreadLabel (shard threads)
+static thread_local char t_threadLabel[16];
+
+static int64_t NowMicros()
+{
+	auto now = std::chrono::system_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+Logger& Logger::Instance()
+{
+	static Logger instance;
+	return instance;
+}
+
+Logger::Logger() :
+	m_mask(0),
+	m_enqueuePos(0),
+	m_dequeuePos(0),
+	m_running(false),
+	m_dropped(0),
+	m_reportedDropped(0),
+	m_json(nullptr)
+{
+	SetLevel(LogLevel::INFO);
+}
+
+Logger::~Logger() { Stop(); }
+
+bool Logger::Start(const std::string& jsonPath, size_t capacity)
+{
+	if (m_running) {
+		return true;
+	}
+
+	if (!jsonPath.empty()) {
+		m_json = fopen(jsonPath.c_str(), "ab");
+		if (!m_json) {
+			LogError(LogCategory::SERVER, "Cannot open log file %s", jsonPath.c_str());
+			return false;
+		}
+	}
+
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+	m_slots.reset(new Slot[size]);
+	m_mask = size - 1;
+	for (size_t i = 0; i < size; i++) {
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	m_enqueuePos.store(0, std::memory_order_relaxed);
+	m_dequeuePos = 0;
+
+	m_running = true;
+	m_writer = std::thread(&Logger::WriterLoop, this);
+	return true;
+}
+
+void Logger::Stop()
+{
+	if (!m_running) {
+		return;
+	}
+
+	m_running = false;
+	if (m_writer.joinable()) {
+		m_writer.join();
+	}
+	Drain(); // Anything published while the writer was finishing up
+
+	fflush(stdout);
+	if (m_json) {
+		fclose(m_json);
+		m_json = nullptr;
+	}
+}
+
+void Logger::SetThreadLabel(const char* label)
+{
+	snprintf(t_threadLabel, sizeof(t_threadLabel), "%s", label ? label : "");
+}
+
+void Logger::SetLevel(LogLevel level)
+{
+	for (auto& categoryLevel : m_levels) {
+		categoryLevel.store(level, std::memory_order_relaxed);
+	}
+}
+
+void Logger::SetLevel(LogCategory category, LogLevel level)
+{
+	m_levels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::Format(Record& record, LogCategory category, LogLevel level, const char* format, va_list args)
+{
+	record.timeMicros = NowMicros();
+	record.category = category;
+	record.level = level;
+
+	size_t prefix = 0;
+	if (t_threadLabel[0] != '\0') {
+		prefix = static_cast<size_t>(snprintf(record.text, sizeof(record.text), "%s: ", t_threadLabel));
+	}
+
+	int length = vsnprintf(record.text + prefix, sizeof(record.text) - prefix, format, args);
+	size_t size = prefix + (length < 0 ? 0 : static_cast<size_t>(length));
+	size = std::min(size, sizeof(record.text) - 1);
+	while (size > 0 && record.text[size - 1] == '\n') {
+		size--;
+	}
+	record.length = static_cast<uint16_t>(size);
+}
+
+void Logger::Write(LogCategory category, LogLevel level, const char* format, va_list args)
+{
+	if (!m_running.load(std::memory_order_acquire)) {
+		Record record;
+		Format(record, category, level, format, args);
+		Emit(record);
+		return;
+	}
+
+	// Claim a slot (Vyukov bounded queue): the slot for pos is free once its
+	// sequence has caught up with pos
+	size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	for (;;) {
+		slot = &m_slots[pos & m_mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+		if (diff == 0) {
+			if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			m_dropped.fetch_add(1, std::memory_order_relaxed); // Full - the writer is behind
+			return;
+		} else {
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	Format(slot->record, category, level, format, args);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Logger::WriterLoop()
+{
+	while (m_running.load(std::memory_order_acquire)) {
+		if (Drain() == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+	Drain();
+}
+
+size_t Logger::Drain()
+{
+	size_t count = 0;
+	for (;;) {
+		Slot& slot = m_slots[m_dequeuePos & m_mask];
+		if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+			break; // Empty, or the next record is still being formatted
+		}
+		Emit(slot.record);
+		slot.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+		m_dequeuePos++;
+		count++;
+	}
+
+	uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+	if (dropped != m_reportedDropped) {
+		Record record;
+		record.timeMicros = NowMicros();
+		record.category = LogCategory::SERVER;
+		record.level = LogLevel::WARN;
+		int length = snprintf(record.text,
+							  sizeof(record.text),
+							  "Log buffer full, dropped %llu messages",
+							  static_cast<unsigned long long>(dropped - m_reportedDropped));
+		record.length = static_cast<uint16_t>(length);
+		Emit(record);
+		m_reportedDropped = dropped;
+		count++;
+	}
+
+	// One flush per batch instead of one per line
+	if (count > 0) {
+		fflush(stdout);
+		if (m_json) {
+			fflush(m_json);
+		}
+	}
+	return count;
+}
+
+void Logger::Emit(const Record& record)
+{
+	time_t seconds = static_cast<time_t>(record.timeMicros / 1000000);
+	int millis = static_cast<int>((record.timeMicros / 1000) % 1000);
+	struct tm local;
+#ifdef _WIN32
+	localtime_s(&local, &seconds);
+#else
+	localtime_r(&seconds, &local);
+#endif
+
+	// Console: "[14:02:11.250] info  net     CONNECT: ..."
+	char clock[16];
+	strftime(clock, sizeof(clock), "%H:%M:%S", &local);
+	fprintf(stdout,
+			"[%s.%03d] %-5s %-7s %.*s\n",
+			clock,
+			millis,
+			LogLevelName(record.level),
+			LogCategoryName(record.category),
+			static_cast<int>(record.length),
+			record.text);
+
+	if (!m_json) {
+		return;
+	}
+
+	// JSON Lines: {"ts_us":...,"level":"info","category":"net","msg":"..."}
+	char escaped[MAX_MESSAGE * 6 + 1];
+	size_t out = 0;
+	for (size_t i = 0; i < record.length; i++) {
+		unsigned char c = static_cast<unsigned char>(record.text[i]);
+		if (c == '"' || c == '\\') {
+			escaped[out++] = '\\';
+			escaped[out++] = static_cast<char>(c);
+		} else if (c < 0x20) {
+			out += snprintf(escaped + out, sizeof(escaped) - out, "\\u%04x", c);
+		} else {
+			escaped[out++] = static_cast<char>(c);
+		}
+	}
+	escaped[out] = '\0';
+
+	fprintf(m_json,
+			"{\"ts_us\":%lld,\"level\":\"%s\",\"category\":\"%s\",\"msg\":\"%s\"}\n",
+			static_cast<long long>(record.timeMicros),
+			LogLevelName(record.level),
+			LogCategoryName(record.category),
+			escaped);
+}
+
+// ============================================================================
+// Logging Functions
+// ============================================================================
+
+void LogDebug(LogCategory category, const char* format, ...)
+{
+	Logger& logger = Logger::Instance();
+	if (!logger.IsEnabled(category, LogLevel::DEBUG)) {
+		return; // Filtered before any formatting
+	}
+	va_list args;
+	va_start(args, format);
+	logger.Write(category, LogLevel::DEBUG, format, args);
+	va_end(args);
+}
+
+void LogInfo(LogCategory category, const char* format, ...)
+{
+	Logger& logger = Logger::Instance();
+	if (!logger.IsEnabled(category, LogLevel::INFO)) {
+		return; // Filtered before any formatting
+	}
+	va_list args;
+	va_start(args, format);
+	logger.Write(category, LogLevel::INFO, format, args);
+	va_end(args);
+}
+
+void LogWarn(LogCategory category, const char* format, ...)
+{
+	Logger& logger = Logger::Instance();
+	if (!logger.IsEnabled(category, LogLevel::WARN)) {
+		return; // Filtered before any formatting
+	}
+	va_list args;
+	va_start(args, format);
+	logger.Write(category, LogLevel::WARN, format, args);
+	va_end(args);
+}
+
+void LogError(LogCategory category, const char* format, ...)
+{
+	Logger& logger = Logger::Instance();
+	if (!logger.IsEnabled(category, LogLevel::ERR)) {
+		return; // Filtered before any formatting
+	}
+	va_list args;
+	va_start(args, format);
+	logger.Write(category, LogLevel::ERR, format, args);
+	va_end(args);
+}
+
+} // namespace Server
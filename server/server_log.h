@@ -0,0 +1,137 @@
+#pragma once
+
+/*
+ * Server logging - leveled, per-subsystem, written off the tick thread
+ *
+ * Log calls format into a slot of a fixed-size lock-free ring and return; a
+ * background thread drains the ring to stdout and, optionally, a JSON Lines
+ * file. When the ring is full the message is dropped and counted rather than
+ * stalling the caller. Before Start() (and after Stop()) messages are written
+ * synchronously, so startup and shutdown output is never lost.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SERVER_LOG_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define SERVER_LOG_FORMAT(fmtIndex, argIndex)
+#endif
+
+namespace Server {
+
+// ============================================================================
+// Levels and Categories
+// ============================================================================
+
+// ERR rather than ERROR - windows.h defines ERROR as a macro
+enum class LogLevel : uint8_t { DEBUG, INFO, WARN, ERR, OFF };
+
+enum class LogCategory : uint8_t {
+	SERVER, // Lifecycle and configuration
+	NET, // Connections and packets
+	AUTH, // Handshakes and profiles
+	CHAT,
+	ACTION, // Player actions and their world effects
+	WORLD, // World loading and missions
+	NPC, // NPC agent AI
+	ECONOMY, // Hourly tick, mission spawning
+	STORE, // Journal, persister and world stores
+	TIMING, // Periodic tick and action summaries
+	COUNT
+};
+
+const char* LogLevelName(LogLevel level);
+const char* LogCategoryName(LogCategory category);
+bool ParseLogLevel(const char* text, LogLevel& out);
+bool ParseLogCategory(const char* text, LogCategory& out);
+
+// ============================================================================
+// Logger
+// ============================================================================
+
+class Logger {
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 8192; // Messages, rounded up to a power of two
+	static constexpr size_t MAX_MESSAGE = 240; // Longer messages are truncated
+
+	static Logger& Instance();
+
+	~Logger();
+
+	// Start the writer thread. jsonPath (optional) receives one JSON object per
+	// line in addition to the console output.
+	bool Start(const std::string& jsonPath = "", size_t capacity = DEFAULT_CAPACITY);
+	// Write out everything queued and join the writer thread
+	void Stop();
+
+	// Prefix every message logged from the calling thread with "label: "
+	static void SetThreadLabel(const char* label);
+
+	void SetLevel(LogLevel level); // All categories
+	void SetLevel(LogCategory category, LogLevel level);
+	bool IsEnabled(LogCategory category, LogLevel level) const
+	{
+		return level >= m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+	}
+
+	void Write(LogCategory category, LogLevel level, const char* format, va_list args);
+
+	uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+	struct Record {
+		int64_t timeMicros; // Wall clock, microseconds since the epoch
+		LogCategory category;
+		LogLevel level;
+		uint16_t length;
+		char text[MAX_MESSAGE];
+	};
+
+	// One ring slot. sequence == position: free for the producer claiming
+	// position; sequence == position + 1: holds that position's record.
+	struct alignas(64) Slot {
+		std::atomic<size_t> sequence;
+		Record record;
+	};
+
+	Logger();
+
+	static void Format(
+		Record& record, LogCategory category, LogLevel level, const char* format, va_list args);
+	void WriterLoop();
+	size_t Drain(); // Write out every published record, returns how many
+	void Emit(const Record& record);
+
+	std::array<std::atomic<LogLevel>, static_cast<size_t>(LogCategory::COUNT)> m_levels;
+
+	// Bounded multi-producer ring, one consumer (the writer thread)
+	std::unique_ptr<Slot[]> m_slots;
+	size_t m_mask;
+	alignas(64) std::atomic<size_t> m_enqueuePos;
+	alignas(64) size_t m_dequeuePos;
+
+	std::atomic<bool> m_running;
+	std::atomic<uint64_t> m_dropped;
+	uint64_t m_reportedDropped; // Writer thread only
+	std::thread m_writer;
+	FILE* m_json;
+};
+
+// ============================================================================
+// Logging Functions
+// ============================================================================
+
+void LogDebug(LogCategory category, const char* format, ...) SERVER_LOG_FORMAT(2, 3);
+void LogInfo(LogCategory category, const char* format, ...) SERVER_LOG_FORMAT(2, 3);
+void LogWarn(LogCategory category, const char* format, ...) SERVER_LOG_FORMAT(2, 3);
+void LogError(LogCategory category, const char* format, ...) SERVER_LOG_FORMAT(2, 3);
+
+} // namespace Server
@@ -0,0 +1,563 @@
+/*
+ * World persistence implementation
+ */
+
+#include "server_persistence.h"
+#include "server_log.h"
+#include "server_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Server {
+
+static const uint8_t JOURNAL_VERSION = 1;
+
+// Record header: payload length + FNV-1a checksum of the payload
+static const size_t RECORD_HEADER_SIZE = 8;
+
+uint32_t RecordChecksum(const uint8_t* data, size_t length)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static void PutU32(uint8_t* out, uint32_t value)
+{
+	out[0] = static_cast<uint8_t>(value);
+	out[1] = static_cast<uint8_t>(value >> 8);
+	out[2] = static_cast<uint8_t>(value >> 16);
+	out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static uint32_t GetU32(const uint8_t* in)
+{
+	return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+bool SyncDescriptor(int fd)
+{
+	if (fd < 0) {
+		return false;
+	}
+#ifdef _WIN32
+	return _commit(fd) == 0;
+#else
+	return fsync(fd) == 0;
+#endif
+}
+
+static int FileDescriptor(FILE* file)
+{
+#ifdef _WIN32
+	return _fileno(file);
+#else
+	return fileno(file);
+#endif
+}
+
+// ============================================================================
+// Change Set Encoding
+// ============================================================================
+
+static void WriteI32(Net::DeltaBuffer& out, int32_t value) { out.WriteVarint(Net::EncodeZigZag(value)); }
+
+static void WriteI64(Net::DeltaBuffer& out, int64_t value)
+{
+	out.WriteU32(static_cast<uint32_t>(value));
+	out.WriteU32(static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+}
+
+static bool ReadI32(Net::DeltaReader& in, int32_t& value)
+{
+	uint32_t raw;
+	if (!in.ReadVarint(raw)) {
+		return false;
+	}
+	value = Net::DecodeZigZag(raw);
+	return true;
+}
+
+static bool ReadI16(Net::DeltaReader& in, int16_t& value)
+{
+	int32_t wide;
+	if (!ReadI32(in, wide)) {
+		return false;
+	}
+	value = static_cast<int16_t>(wide);
+	return true;
+}
+
+static bool ReadI64(Net::DeltaReader& in, int64_t& value)
+{
+	uint32_t low, high;
+	if (!in.ReadU32(low) || !in.ReadU32(high)) {
+		return false;
+	}
+	value = static_cast<int64_t>((static_cast<uint64_t>(high) << 32) | low);
+	return true;
+}
+
+void WorldJournal::Encode(const WorldChangeSet& changes, Net::DeltaBuffer& out)
+{
+	out.WriteU8(JOURNAL_VERSION);
+
+	out.WriteVarint(static_cast<uint32_t>(changes.computers.size()));
+	for (const auto& c : changes.computers) {
+		WriteI32(out, c.id);
+		WriteI64(out, c.ip);
+		out.WriteString(c.ipString);
+		out.WriteString(c.name);
+		WriteI32(out, c.type);
+		WriteI32(out, c.securityLevel);
+		out.WriteU8(static_cast<uint8_t>((c.running ? 1 : 0) | (c.proxyBypassed ? 2 : 0) |
+										 (c.firewallBypassed ? 4 : 0) | (c.monitorDisabled ? 8 : 0)));
+	}
+
+	out.WriteVarint(static_cast<uint32_t>(changes.missions.size()));
+	for (const auto& m : changes.missions) {
+		WriteI32(out, m.id);
+		WriteI32(out, m.type);
+		WriteI64(out, m.targetIp);
+		out.WriteString(m.description);
+		WriteI32(out, m.payment);
+		WriteI32(out, m.difficulty);
+		WriteI32(out, m.claimedBy);
+		out.WriteU8(m.completed ? 1 : 0);
+	}
+
+	out.WriteVarint(static_cast<uint32_t>(changes.accounts.size()));
+	for (const auto& a : changes.accounts) {
+		WriteI32(out, a.id);
+		WriteI64(out, a.bankIp);
+		out.WriteString(a.accountNumber);
+		out.WriteString(a.accountName);
+		WriteI32(out, a.balance);
+		WriteI32(out, a.ownerPlayerId);
+		WriteI32(out, a.regenRate);
+	}
+}
+
+bool WorldJournal::Decode(const uint8_t* data, size_t length, WorldChangeSet& out)
+{
+	out.Clear();
+	Net::DeltaReader in(data, length);
+
+	uint8_t version;
+	if (!in.ReadU8(version) || version != JOURNAL_VERSION) {
+		return false;
+	}
+
+	uint32_t count;
+	if (!in.ReadVarint(count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		ServerComputer c {};
+		uint8_t flags;
+		if (!ReadI32(in, c.id) || !ReadI64(in, c.ip) || !in.ReadString(c.ipString) ||
+			!in.ReadString(c.name) || !ReadI16(in, c.type) || !ReadI16(in, c.securityLevel) ||
+			!in.ReadU8(flags)) {
+			return false;
+		}
+		c.running = (flags & 1) != 0;
+		c.proxyBypassed = (flags & 2) != 0;
+		c.firewallBypassed = (flags & 4) != 0;
+		c.monitorDisabled = (flags & 8) != 0;
+		out.computers.push_back(std::move(c));
+	}
+
+	if (!in.ReadVarint(count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		ServerMission m {};
+		uint8_t completed;
+		if (!ReadI32(in, m.id) || !ReadI16(in, m.type) || !ReadI64(in, m.targetIp) ||
+			!in.ReadString(m.description) || !ReadI32(in, m.payment) || !ReadI16(in, m.difficulty) ||
+			!ReadI32(in, m.claimedBy) || !in.ReadU8(completed)) {
+			return false;
+		}
+		m.completed = completed != 0;
+		out.missions.push_back(std::move(m));
+	}
+
+	if (!in.ReadVarint(count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		ServerBankAccount a {};
+		if (!ReadI32(in, a.id) || !ReadI64(in, a.bankIp) || !in.ReadString(a.accountNumber) ||
+			!in.ReadString(a.accountName) || !ReadI32(in, a.balance) || !ReadI32(in, a.ownerPlayerId) ||
+			!ReadI32(in, a.regenRate)) {
+			return false;
+		}
+		out.accounts.push_back(std::move(a));
+	}
+
+	return true;
+}
+
+// ============================================================================
+// WorldJournal
+// ============================================================================
+
+WorldJournal::WorldJournal() : m_file(nullptr), m_sealedFile(nullptr), m_segment(0), m_segmentBytes(0) { }
+
+WorldJournal::~WorldJournal() { Close(); }
+
+std::string WorldJournal::SegmentPath(uint32_t segment) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "journal.%06u.log", segment);
+	return (std::filesystem::path(m_directory) / name).string();
+}
+
+std::vector<uint32_t> WorldJournal::ListSegments() const
+{
+	std::vector<uint32_t> segments;
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+		unsigned int segment;
+		char tail;
+		std::string name = entry.path().filename().string();
+		if (sscanf(name.c_str(), "journal.%u.lo%c", &segment, &tail) == 2 && tail == 'g') {
+			segments.push_back(segment);
+		}
+	}
+	std::sort(segments.begin(), segments.end());
+	return segments;
+}
+
+bool WorldJournal::OpenSegment(uint32_t segment)
+{
+	m_file = fopen(SegmentPath(segment).c_str(), "ab");
+	if (!m_file) {
+		LogError(LogCategory::STORE, "Journal: Cannot open %s", SegmentPath(segment).c_str());
+		return false;
+	}
+	m_segment = segment;
+	m_segmentBytes = 0;
+	return true;
+}
+
+bool WorldJournal::Open(const std::string& directory)
+{
+	Close();
+	m_directory = directory;
+
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+
+	m_recovered = ListSegments();
+	uint32_t next = m_recovered.empty() ? 1 : m_recovered.back() + 1;
+	return OpenSegment(next);
+}
+
+void WorldJournal::Close()
+{
+	CloseSealed();
+	if (m_file) {
+		fflush(m_file);
+		SyncDescriptor(FileDescriptor(m_file));
+		fclose(m_file);
+		m_file = nullptr;
+
+		// An empty segment carries nothing worth replaying
+		if (m_segmentBytes == 0) {
+			std::error_code ec;
+			std::filesystem::remove(SegmentPath(m_segment), ec);
+		}
+	}
+}
+
+size_t WorldJournal::Replay(const std::function<void(const WorldChangeSet&)>& apply) const
+{
+	size_t records = 0;
+	WorldChangeSet changes;
+	std::vector<uint8_t> payload;
+
+	for (uint32_t segment : m_recovered) {
+		FILE* file = fopen(SegmentPath(segment).c_str(), "rb");
+		if (!file) {
+			continue;
+		}
+
+		uint8_t header[RECORD_HEADER_SIZE];
+		while (fread(header, 1, sizeof(header), file) == sizeof(header)) {
+			uint32_t length = GetU32(header);
+			payload.resize(length);
+			if (fread(payload.data(), 1, length, file) != length ||
+				RecordChecksum(payload.data(), length) != GetU32(header + 4) ||
+				!Decode(payload.data(), length, changes)) {
+				LogWarn(LogCategory::STORE, "Journal: Torn record in segment %u, ignoring the rest", segment);
+				break;
+			}
+			apply(changes);
+			records++;
+		}
+		fclose(file);
+	}
+
+	return records;
+}
+
+bool WorldJournal::Append(const WorldChangeSet& changes)
+{
+	if (!m_file) {
+		return false;
+	}
+
+	m_scratch.Clear();
+	Encode(changes, m_scratch);
+
+	uint8_t header[RECORD_HEADER_SIZE];
+	PutU32(header, static_cast<uint32_t>(m_scratch.Size()));
+	PutU32(header + 4, RecordChecksum(m_scratch.Data(), m_scratch.Size()));
+
+	bool ok = fwrite(header, 1, sizeof(header), m_file) == sizeof(header) &&
+			  fwrite(m_scratch.Data(), 1, m_scratch.Size(), m_file) == m_scratch.Size() &&
+			  fflush(m_file) == 0;
+	m_segmentBytes += sizeof(header) + m_scratch.Size();
+	return ok;
+}
+
+uint32_t WorldJournal::Rotate()
+{
+	if (!m_file || m_segmentBytes == 0) {
+		return m_segment - 1; // Nothing new - every earlier segment is already sealed
+	}
+
+	CloseSealed();
+	m_sealedFile = m_file;
+	uint32_t sealed = m_segment;
+
+	if (!OpenSegment(sealed + 1)) {
+		// Keep appending to the old segment rather than dropping writes
+		m_file = m_sealedFile;
+		m_sealedFile = nullptr;
+		return sealed - 1;
+	}
+	return sealed;
+}
+
+int WorldJournal::GetDescriptor() const { return m_file ? FileDescriptor(m_file) : -1; }
+
+void WorldJournal::CloseSealed()
+{
+	if (m_sealedFile) {
+		SyncDescriptor(FileDescriptor(m_sealedFile));
+		fclose(m_sealedFile);
+		m_sealedFile = nullptr;
+	}
+}
+
+void WorldJournal::DropThrough(uint32_t segment) const
+{
+	for (uint32_t existing : ListSegments()) {
+		if (existing <= segment) {
+			std::error_code ec;
+			std::filesystem::remove(SegmentPath(existing), ec);
+		}
+	}
+}
+
+// ============================================================================
+// WorldPersister
+// ============================================================================
+
+WorldPersister::WorldPersister() :
+	m_store(nullptr),
+	m_stopping(false),
+	m_flushRequested(false),
+	m_flushInterval(30)
+{
+}
+
+WorldPersister::~WorldPersister() { Stop(); }
+
+bool WorldPersister::Start(ServerWorld& world,
+						   WorldStore& store,
+						   const std::string& journalDir,
+						   int flushIntervalSec)
+{
+	if (IsRunning()) {
+		return true;
+	}
+
+	if (!m_journal.Open(journalDir)) {
+		return false;
+	}
+
+	m_store = &store;
+
+	// Changes journaled by a previous run but never confirmed by the store
+	size_t records = m_journal.Replay([&](const WorldChangeSet& changes) {
+		world.ApplyChanges(changes);
+		MergePending(changes);
+	});
+	if (records > 0) {
+		LogInfo(LogCategory::STORE,
+				"Persist: Recovered %zu journal records (%zu computers, %zu missions, %zu accounts)",
+				records,
+				m_pendingComputers.size(),
+				m_pendingMissions.size(),
+				m_pendingAccounts.size());
+	}
+
+	m_flushInterval = std::chrono::seconds(flushIntervalSec > 0 ? flushIntervalSec : 1);
+	m_stopping = false;
+	m_flushRequested = records > 0; // Push recovered state out straight away
+	m_thread = std::thread(&WorldPersister::ThreadLoop, this);
+	return true;
+}
+
+void WorldPersister::Stop()
+{
+	if (!IsRunning()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+
+	m_journal.Close();
+}
+
+void WorldPersister::Submit(const WorldChangeSet& changes)
+{
+	if (changes.Empty()) {
+		return;
+	}
+
+	// Journal and queue under one lock, so every record in a sealed segment
+	// is also in the batch that flush takes
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_journal.Append(changes)) {
+		LogWarn(LogCategory::STORE, "Persist: Journal write failed, changes are only in memory");
+	}
+	m_incoming.push_back(changes);
+}
+
+void WorldPersister::RequestFlush()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_flushRequested = true;
+	}
+	m_wake.notify_one();
+}
+
+void WorldPersister::ThreadLoop()
+{
+	using Clock = std::chrono::steady_clock;
+
+	// fsync cadence for the open segment - bounds what a power loss can take
+	const auto syncInterval = std::chrono::seconds(1);
+	auto nextFlush = Clock::now() + m_flushInterval;
+
+	for (;;) {
+		std::vector<WorldChangeSet> incoming;
+		uint32_t sealed = 0;
+		int descriptor = -1;
+		bool stopping;
+		bool flushDue;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait_until(lock, std::min(Clock::now() + syncInterval, nextFlush), [this] {
+				return m_stopping || m_flushRequested;
+			});
+
+			stopping = m_stopping;
+			flushDue = stopping || m_flushRequested || Clock::now() >= nextFlush;
+			m_flushRequested = false;
+
+			incoming.swap(m_incoming);
+			if (flushDue) {
+				sealed = m_journal.Rotate();
+			}
+			descriptor = m_journal.GetDescriptor();
+		}
+
+		for (const auto& changes : incoming) {
+			MergePending(changes);
+		}
+
+		// Only this thread rotates or closes segments, so the descriptor stays valid
+		SyncDescriptor(descriptor);
+		m_journal.CloseSealed();
+
+		if (flushDue) {
+			bool empty = m_pendingComputers.empty() && m_pendingMissions.empty() && m_pendingAccounts.empty();
+			if (empty || FlushPending()) {
+				m_journal.DropThrough(sealed);
+			}
+			nextFlush = Clock::now() + m_flushInterval;
+		}
+
+		if (stopping) {
+			break;
+		}
+	}
+}
+
+void WorldPersister::MergePending(const WorldChangeSet& changes)
+{
+	// Later records carry newer full state, so last write wins
+	for (const auto& c : changes.computers) {
+		m_pendingComputers[c.id] = c;
+	}
+	for (const auto& m : changes.missions) {
+		m_pendingMissions[m.id] = m;
+	}
+	for (const auto& a : changes.accounts) {
+		m_pendingAccounts[a.id] = a;
+	}
+}
+
+bool WorldPersister::FlushPending()
+{
+	WorldChangeSet batch;
+	batch.computers.reserve(m_pendingComputers.size());
+	for (const auto& [id, c] : m_pendingComputers) {
+		batch.computers.push_back(c);
+	}
+	batch.missions.reserve(m_pendingMissions.size());
+	for (const auto& [id, m] : m_pendingMissions) {
+		batch.missions.push_back(m);
+	}
+	batch.accounts.reserve(m_pendingAccounts.size());
+	for (const auto& [id, a] : m_pendingAccounts) {
+		batch.accounts.push_back(a);
+	}
+
+	// Writes carry full entity state, so a failed batch is simply retried whole
+	if (!m_store->Write(batch)) {
+		LogWarn(LogCategory::STORE,
+				"Persist: Flush to %s failed, keeping journal and retrying next interval",
+				m_store->GetName());
+		return false;
+	}
+
+	m_pendingComputers.clear();
+	m_pendingMissions.clear();
+	m_pendingAccounts.clear();
+	return true;
+}
+
+} // namespace Server
@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+ * World persistence - write-ahead journal and write-behind flushing
+ *
+ * The tick thread hands every WorldChangeSet to WorldPersister::Submit, which
+ * appends it to the current journal segment (a buffered write, no fsync) and
+ * queues it in memory. A background thread fsyncs the journal about once a
+ * second and periodically writes everything pending to the WorldStore in one
+ * bulk call. Segments are only deleted once that write succeeds, so a crash at
+ * any point is recovered by replaying the journal on the next start.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "network/deltaencoder.h"
+#include "server_world.h"
+
+namespace Server {
+
+class WorldStore;
+
+// ============================================================================
+// World Journal
+// ============================================================================
+
+// Numbered segment files (journal.000001.log, ...) of length-prefixed,
+// checksummed WorldChangeSet records. Appends go to the newest segment;
+// Rotate() seals it so a flush can later drop everything up to that point.
+// Not thread-safe: WorldPersister holds its lock for Append and Rotate, and
+// only its flush thread calls CloseSealed and DropThrough.
+
+class WorldJournal {
+public:
+	WorldJournal();
+	~WorldJournal();
+
+	WorldJournal(const WorldJournal&) = delete;
+	WorldJournal& operator=(const WorldJournal&) = delete;
+
+	// Scan directory for existing segments and open a new one after them
+	bool Open(const std::string& directory);
+	void Close();
+	bool IsOpen() const { return m_file != nullptr; }
+
+	// Feed every record in existing segments, oldest first. A torn record at the
+	// end of a segment (crash mid-write) ends that segment.
+	size_t Replay(const std::function<void(const WorldChangeSet&)>& apply) const;
+
+	// Buffered write + fflush: survives a process crash, not a power loss
+	bool Append(const WorldChangeSet& changes);
+
+	// Seal the current segment (if it holds anything) and start a new one.
+	// Returns the newest sealed segment number, 0 if there is none.
+	uint32_t Rotate();
+
+	// Descriptor of the current segment, for fsync outside the journal lock
+	int GetDescriptor() const;
+	size_t GetSegmentBytes() const { return m_segmentBytes; }
+
+	// fsync and close the segment sealed by the last Rotate()
+	void CloseSealed();
+
+	// Delete sealed segments up to and including segment
+	void DropThrough(uint32_t segment) const;
+
+	static void Encode(const WorldChangeSet& changes, Net::DeltaBuffer& out);
+	static bool Decode(const uint8_t* data, size_t length, WorldChangeSet& out);
+
+private:
+	std::string SegmentPath(uint32_t segment) const;
+	std::vector<uint32_t> ListSegments() const;
+	bool OpenSegment(uint32_t segment);
+
+	std::string m_directory;
+	FILE* m_file;
+	FILE* m_sealedFile;
+	uint32_t m_segment;
+	size_t m_segmentBytes;
+	std::vector<uint32_t> m_recovered; // Segments left by a previous run
+	Net::DeltaBuffer m_scratch;
+};
+
+// Flush the OS buffers of a file descriptor to disk
+bool SyncDescriptor(int fd);
+
+// FNV-1a over a journal or snapshot payload
+uint32_t RecordChecksum(const uint8_t* data, size_t length);
+
+// ============================================================================
+// World Persister
+// ============================================================================
+
+class WorldPersister {
+public:
+	WorldPersister();
+	~WorldPersister();
+
+	// Open the journal, replay unflushed changes onto world, start the flush thread.
+	// store must outlive the persister (or the next Stop).
+	bool Start(ServerWorld& world, WorldStore& store, const std::string& journalDir, int flushIntervalSec);
+
+	// Flush whatever is pending one last time and join the thread
+	void Stop();
+
+	bool IsRunning() const { return m_thread.joinable(); }
+
+	// Tick thread: journal the changes and queue them for the next bulk upsert
+	void Submit(const WorldChangeSet& changes);
+
+	// Wake the flush thread now instead of at the next interval
+	void RequestFlush();
+
+private:
+	void ThreadLoop();
+	void MergePending(const WorldChangeSet& changes);
+	bool FlushPending(); // Bulk write; true if everything reached the store
+
+	WorldJournal m_journal;
+	WorldStore* m_store;
+
+	std::mutex m_mutex; // Guards m_journal appends/rotation and m_incoming
+	std::condition_variable m_wake;
+	std::vector<WorldChangeSet> m_incoming;
+	bool m_stopping;
+	bool m_flushRequested;
+	std::thread m_thread;
+	std::chrono::seconds m_flushInterval;
+
+	// Flush thread only: latest state per entity id awaiting upsert
+	std::unordered_map<int32_t, ServerComputer> m_pendingComputers;
+	std::unordered_map<int32_t, ServerMission> m_pendingMissions;
+	std::unordered_map<int32_t, ServerBankAccount> m_pendingAccounts;
+};
+
+} // namespace Server
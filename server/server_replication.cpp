@@ -0,0 +1,220 @@
+/*
+ * WorldReplicator implementation
+ */
+
+#include "server_replication.h"
+#include "server_world.h"
+
+namespace Server {
+
+WorldReplicator::WorldReplicator() : m_tick(0) { }
+
+// ============================================================================
+// Capture
+// ============================================================================
+
+void WorldReplicator::Capture(const ServerWorld& world)
+{
+	m_tick++;
+	m_changed.clear();
+	m_removed.clear();
+
+	for (const auto& c : world.GetComputers()) {
+		Net::EntityState state;
+		state.SetString(Net::COMPUTER_IP, c.ipString);
+		state.SetString(Net::COMPUTER_NAME, c.name);
+		state.SetSigned(Net::COMPUTER_TYPE, c.type);
+		state.SetSigned(Net::COMPUTER_SECURITY_LEVEL, c.securityLevel);
+		state.SetNumber(Net::COMPUTER_RUNNING, c.running);
+		state.SetNumber(Net::COMPUTER_PROXY_BYPASSED, c.proxyBypassed);
+		state.SetNumber(Net::COMPUTER_FIREWALL_BYPASSED, c.firewallBypassed);
+		state.SetNumber(Net::COMPUTER_MONITOR_DISABLED, c.monitorDisabled);
+		Track(Net::MakeEntityKey(Net::EntityKind::COMPUTER, static_cast<uint32_t>(c.id)), state);
+	}
+
+	for (const auto& m : world.GetMissions()) {
+		Net::EntityState state;
+		state.SetSigned(Net::MISSION_TYPE, m.type);
+		state.SetNumber(Net::MISSION_TARGET_IP, static_cast<uint32_t>(m.targetIp));
+		state.SetString(Net::MISSION_DESCRIPTION, m.description);
+		state.SetSigned(Net::MISSION_PAYMENT, m.payment);
+		state.SetSigned(Net::MISSION_DIFFICULTY, m.difficulty);
+		state.SetSigned(Net::MISSION_CLAIMED_BY, m.claimedBy);
+		state.SetNumber(Net::MISSION_COMPLETED, m.completed);
+		Track(Net::MakeEntityKey(Net::EntityKind::MISSION, static_cast<uint32_t>(m.id)), state);
+	}
+
+	for (const auto& a : world.GetAgents()) {
+		Net::EntityState state;
+		state.SetString(Net::AGENT_HANDLE, a.handle);
+		state.SetNumber(Net::AGENT_IS_NPC, a.isNPC);
+		state.SetNumber(Net::AGENT_PLAYER_ID, a.playerId);
+		state.SetSigned(Net::AGENT_UPLINK_RATING, a.uplinkRating);
+		state.SetSigned(Net::AGENT_NEUROMANCER_RATING, a.neuromancerRating);
+		state.SetSigned(Net::AGENT_CREDITS, a.credits);
+		state.SetNumber(Net::AGENT_CONNECTED_TO_IP, static_cast<uint32_t>(a.connectedToIp));
+		state.SetSigned(Net::AGENT_CURRENT_MISSION, a.currentMissionId);
+		Track(Net::MakeEntityKey(Net::EntityKind::AGENT, static_cast<uint32_t>(a.id)), state);
+	}
+
+	// Anything not seen this capture has left the world
+	for (auto it = m_entities.begin(); it != m_entities.end();) {
+		if (it->second.seenTick != m_tick) {
+			m_removed.push_back(it->first);
+			it = m_entities.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void WorldReplicator::Track(uint64_t key, const Net::EntityState& state)
+{
+	auto [it, inserted] = m_entities.try_emplace(key);
+	ReplicatedEntity& entity = it->second;
+	entity.seenTick = m_tick;
+
+	bool changed = inserted;
+	for (size_t id = 1; id < Net::MAX_ENTITY_FIELDS; ++id) {
+		if (inserted || entity.state.fields[id] != state.fields[id]) {
+			entity.state.fields[id] = state.fields[id];
+			entity.fieldTicks[id] = m_tick;
+			changed = true;
+		}
+	}
+
+	if (changed) {
+		entity.changedTick = m_tick;
+		m_changed.push_back(key);
+	}
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+void WorldReplicator::WriteFull(
+	Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const
+{
+	baseline.known.clear();
+
+	out.WriteVarint(m_tick);
+	for (const auto& [key, entity] : m_entities) {
+		if (interest.Contains(key)) {
+			Net::WriteEntityFull(out, key, entity.state);
+			baseline.known[key] = m_tick;
+		}
+	}
+
+	baseline.tick = m_tick;
+	baseline.hasSnapshot = true;
+}
+
+void WorldReplicator::WriteChanges(Net::DeltaBuffer& out,
+								   uint64_t key,
+								   const ReplicatedEntity& entity,
+								   ClientBaseline& baseline) const
+{
+	auto known = baseline.known.find(key);
+
+	if (known == baseline.known.end()) {
+		// New to this client - send everything
+		Net::WriteEntityFull(out, key, entity.state);
+		baseline.known.emplace(key, m_tick);
+		return;
+	}
+
+	// Only fields that changed after the client's copy
+	Net::WriteEntityHeader(out, key, Net::ENTITY_UPDATE);
+	for (uint8_t id = 1; id < Net::MAX_ENTITY_FIELDS; ++id) {
+		if (entity.fieldTicks[id] > known->second && entity.state.fields[id].type != Net::FIELD_END) {
+			Net::WriteFieldValue(out, id, entity.state.fields[id]);
+		}
+	}
+	out.WriteFieldStart(0, Net::FIELD_END);
+	known->second = m_tick;
+}
+
+bool WorldReplicator::WriteCatchUp(
+	Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const
+{
+	bool wrote = false;
+
+	// m_changed and m_removed only cover the last capture, so compare the
+	// whole world against the baseline's ticks
+	for (const auto& [key, entity] : m_entities) {
+		if (!interest.Contains(key)) {
+			continue; // Leaving interest is handled by WriteDelta
+		}
+		auto known = baseline.known.find(key);
+		if (known == baseline.known.end() || entity.changedTick > known->second) {
+			WriteChanges(out, key, entity, baseline);
+			wrote = true;
+		}
+	}
+
+	for (auto it = baseline.known.begin(); it != baseline.known.end();) {
+		if (m_entities.count(it->first) == 0) {
+			Net::WriteEntityRemove(out, it->first);
+			it = baseline.known.erase(it);
+			wrote = true;
+		} else {
+			++it;
+		}
+	}
+
+	return wrote;
+}
+
+bool WorldReplicator::WriteDelta(
+	Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const
+{
+	out.WriteVarint(m_tick);
+	bool wrote = false;
+
+	if (baseline.tick + 1 < m_tick) {
+		wrote = WriteCatchUp(out, baseline, interest);
+	} else {
+		for (uint64_t key : m_changed) {
+			if (!interest.Contains(key)) {
+				continue; // Leaving interest is handled below
+			}
+			WriteChanges(out, key, m_entities.at(key), baseline);
+			wrote = true;
+		}
+
+		for (uint64_t key : m_removed) {
+			if (baseline.known.erase(key) > 0) {
+				Net::WriteEntityRemove(out, key);
+				wrote = true;
+			}
+		}
+	}
+	baseline.tick = m_tick;
+
+	// Unchanged computers that just entered interest (new link, bounce or connection)
+	for (int32_t id : interest.computers) {
+		uint64_t key = Net::MakeEntityKey(Net::EntityKind::COMPUTER, static_cast<uint32_t>(id));
+		auto entity = m_entities.find(key);
+		if (entity != m_entities.end() && baseline.known.emplace(key, m_tick).second) {
+			Net::WriteEntityFull(out, key, entity->second.state);
+			wrote = true;
+		}
+	}
+
+	// Entities that dropped out of interest. The client forgets them, so
+	// re-entering later starts from a full record again.
+	for (auto it = baseline.known.begin(); it != baseline.known.end();) {
+		if (!interest.Contains(it->first)) {
+			Net::WriteEntityRemove(out, it->first);
+			it = baseline.known.erase(it);
+			wrote = true;
+		} else {
+			++it;
+		}
+	}
+
+	return wrote;
+}
+
+} // namespace Server
@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+ * WorldReplicator - Turns ServerWorld state into WORLD_FULL / WORLD_DELTA payloads
+ * Tracks which fields changed on which capture so each client only receives
+ * what it hasn't seen yet
+ */
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "network/deltaencoder.h"
+#include "network/worldreplication.h"
+
+namespace Server {
+
+class ServerWorld;
+
+// ============================================================================
+// Client Baseline
+// ============================================================================
+
+// What one client already holds: entity key -> capture tick it was last synced at.
+// World messages go on the reliable stream, which a resumed session replays, so
+// anything queued counts as acknowledged; a new session starts over with a full
+// snapshot.
+
+struct ClientBaseline {
+	std::unordered_map<uint64_t, uint32_t> known;
+	uint32_t tick = 0; // Capture the client was last written at
+	bool hasSnapshot = false;
+
+	void Reset()
+	{
+		known.clear();
+		tick = 0;
+		hasSnapshot = false;
+	}
+};
+
+// ============================================================================
+// Interest Set
+// ============================================================================
+
+// Entities one client can currently see. Computers are filtered to the
+// player's links, bounce path and current connection (ServerWorld::
+// GetVisibleComputers); missions and agents are global boards and always pass.
+
+struct InterestSet {
+	std::unordered_set<int32_t> computers;
+
+	bool Contains(uint64_t key) const
+	{
+		if (Net::GetEntityKind(key) != Net::EntityKind::COMPUTER) {
+			return true;
+		}
+		return computers.count(static_cast<int32_t>(Net::GetEntityId(key))) > 0;
+	}
+};
+
+// ============================================================================
+// World Replicator
+// ============================================================================
+
+class WorldReplicator {
+public:
+	WorldReplicator();
+
+	// Snapshot the world into wire form, recording which fields changed since the
+	// previous capture. Call once per network tick before writing any client.
+	void Capture(const ServerWorld& world);
+
+	// Every entity the client can see, for a client joining (or rejoining)
+	void WriteFull(Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const;
+
+	// Visible entities changed since the client's baseline, full records for
+	// entities entering interest and removes for those leaving it (or the world).
+	// A baseline that missed captures (a resumed session) is caught up from the
+	// per-field ticks instead of the last capture's change lists.
+	// Returns false if there is nothing to send
+	bool WriteDelta(Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const;
+
+	uint32_t GetTick() const { return m_tick; }
+	size_t GetEntityCount() const { return m_entities.size(); }
+
+private:
+	struct ReplicatedEntity {
+		Net::EntityState state;
+		std::array<uint32_t, Net::MAX_ENTITY_FIELDS> fieldTicks {}; // Capture each field last changed on
+		uint32_t changedTick = 0; // Latest of fieldTicks
+		uint32_t seenTick = 0; // Last capture that found this entity
+	};
+
+	void Track(uint64_t key, const Net::EntityState& state);
+	void WriteChanges(Net::DeltaBuffer& out,
+					  uint64_t key,
+					  const ReplicatedEntity& entity,
+					  ClientBaseline& baseline) const;
+	bool WriteCatchUp(Net::DeltaBuffer& out, ClientBaseline& baseline, const InterestSet& interest) const;
+
+	std::unordered_map<uint64_t, ReplicatedEntity> m_entities;
+	std::vector<uint64_t> m_changed; // Keys changed in the last capture
+	std::vector<uint64_t> m_removed; // Keys removed in the last capture
+	uint32_t m_tick;
+};
+
+} // namespace Server
@@ -0,0 +1,449 @@
+/*
+ * World store implementations
+ */
+
+#include "server_store.h"
+#include "server_log.h"
+#include "network/ipaddress.h"
+#include "network/supabase_client.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Server {
+
+// ============================================================================
+// SupabaseWorldStore
+// ============================================================================
+
+bool SupabaseWorldStore::Load(WorldChangeSet& out)
+{
+	auto& supabase = Net::SupabaseClient::Instance();
+	out.Clear();
+
+	for (const auto& c : supabase.GetAllComputers()) {
+		ServerComputer sc;
+		sc.id = c.id;
+		sc.ip = c.ip; // Stored packed, see Net::ParseIP
+		sc.ipString = Net::FormatIP(c.ip);
+		sc.name = c.name;
+		sc.securityLevel = c.security_level;
+		sc.running = c.is_running;
+		sc.type = 0;
+		sc.proxyBypassed = false;
+		sc.firewallBypassed = false;
+		sc.monitorDisabled = false;
+		out.computers.push_back(sc);
+	}
+
+	for (const auto& m : supabase.GetAllMissions()) {
+		ServerMission sm;
+		sm.id = m.id;
+		sm.type = m.mission_type;
+		sm.targetIp = m.target_ip;
+		sm.payment = m.payment;
+		sm.difficulty = m.difficulty;
+		sm.claimedBy = m.claimed_by;
+		sm.completed = m.completed;
+		out.missions.push_back(sm);
+	}
+
+	for (const auto& a : supabase.GetAllBankAccounts()) {
+		ServerBankAccount sa;
+		sa.id = a.id;
+		sa.bankIp = a.bank_ip;
+		sa.accountNumber = a.account_number;
+		sa.accountName = a.account_name;
+		sa.balance = a.balance;
+		sa.ownerPlayerId = a.owner_player_id;
+		sa.regenRate = a.regen_rate;
+		out.accounts.push_back(sa);
+	}
+
+	return true;
+}
+
+bool SupabaseWorldStore::Write(const WorldChangeSet& changes)
+{
+	auto& supabase = Net::SupabaseClient::Instance();
+	bool ok = true;
+
+	if (!changes.computers.empty()) {
+		std::vector<Net::Computer> rows;
+		rows.reserve(changes.computers.size());
+		for (const auto& c : changes.computers) {
+			Net::Computer row {};
+			row.id = c.id;
+			row.ip = c.ip;
+			row.name = c.name;
+			row.computer_type = c.type;
+			row.security_level = c.securityLevel;
+			row.is_running = c.running;
+			rows.push_back(std::move(row));
+		}
+		ok = supabase.UpsertComputers(rows) && ok;
+	}
+
+	if (!changes.missions.empty()) {
+		std::vector<Net::Mission> rows;
+		rows.reserve(changes.missions.size());
+		for (const auto& m : changes.missions) {
+			Net::Mission row {};
+			row.id = m.id;
+			row.mission_type = m.type;
+			row.target_ip = m.targetIp;
+			row.description = m.description;
+			row.payment = m.payment;
+			row.difficulty = m.difficulty;
+			row.claimed_by = m.claimedBy;
+			row.completed = m.completed;
+			rows.push_back(std::move(row));
+		}
+		ok = supabase.UpsertMissions(rows) && ok;
+	}
+
+	if (!changes.accounts.empty()) {
+		std::vector<Net::BankAccount> rows;
+		rows.reserve(changes.accounts.size());
+		for (const auto& a : changes.accounts) {
+			Net::BankAccount row {};
+			row.id = a.id;
+			row.bank_ip = a.bankIp;
+			row.account_number = a.accountNumber;
+			row.account_name = a.accountName;
+			row.balance = a.balance;
+			row.owner_player_id = a.ownerPlayerId;
+			row.regen_rate = a.regenRate;
+			rows.push_back(std::move(row));
+		}
+		ok = supabase.UpsertBankAccounts(rows) && ok;
+	}
+
+	return ok;
+}
+
+// ============================================================================
+// Mapped File
+// ============================================================================
+
+// Read-only view of a whole file. The snapshot is decoded straight out of the
+// page cache instead of being copied into a buffer first.
+
+class MappedFile {
+public:
+	MappedFile() : m_data(nullptr), m_size(0) { }
+	~MappedFile() { Unmap(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Map(const std::string& path)
+	{
+		Unmap();
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(),
+								  GENERIC_READ,
+								  FILE_SHARE_READ,
+								  nullptr,
+								  OPEN_EXISTING,
+								  FILE_ATTRIBUTE_NORMAL,
+								  nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER size;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		if (mapping) {
+			m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			m_size = m_data ? static_cast<size_t>(size.QuadPart) : 0;
+			CloseHandle(mapping); // The view keeps the mapping alive
+		}
+		CloseHandle(file);
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				m_data = static_cast<const uint8_t*>(data);
+				m_size = static_cast<size_t>(info.st_size);
+			}
+		}
+		close(fd);
+#endif
+		return m_data != nullptr;
+	}
+
+	void Unmap()
+	{
+		if (m_data) {
+#ifdef _WIN32
+			UnmapViewOfFile(m_data);
+#else
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+		}
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	const uint8_t* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+};
+
+// ============================================================================
+// LocalWorldStore
+// ============================================================================
+
+// Snapshot header: magic, payload length, payload checksum
+static const uint32_t SNAPSHOT_MAGIC = 0x53574C43; // "CLWS"
+static const size_t SNAPSHOT_HEADER_SIZE = 12;
+
+template <typename T>
+static void CollectById(const std::unordered_map<int32_t, T>& entities, std::vector<T>& out)
+{
+	out.clear();
+	out.reserve(entities.size());
+	for (const auto& [id, entity] : entities) {
+		out.push_back(entity);
+	}
+	std::sort(out.begin(), out.end(), [](const T& a, const T& b) { return a.id < b.id; });
+}
+
+LocalWorldStore::LocalWorldStore(const std::string& directory, size_t compactBytes) :
+	m_directory(directory),
+	m_compactBytes(compactBytes)
+{
+}
+
+std::string LocalWorldStore::SnapshotPath() const
+{
+	return (std::filesystem::path(m_directory) / "world.snapshot").string();
+}
+
+void LocalWorldStore::Merge(const WorldChangeSet& changes)
+{
+	for (const auto& c : changes.computers) {
+		m_computers[c.id] = c;
+	}
+	for (const auto& m : changes.missions) {
+		m_missions[m.id] = m;
+	}
+	for (const auto& a : changes.accounts) {
+		m_accounts[a.id] = a;
+	}
+}
+
+bool LocalWorldStore::LoadSnapshot()
+{
+	if (!std::filesystem::exists(SnapshotPath())) {
+		return true; // First run - empty world
+	}
+
+	MappedFile file;
+	if (!file.Map(SnapshotPath())) {
+		LogError(LogCategory::STORE, "LocalStore: Cannot map %s", SnapshotPath().c_str());
+		return false;
+	}
+
+	Net::DeltaReader header(file.Data(), file.Size());
+	uint32_t magic, length, checksum;
+	if (!header.ReadU32(magic) || !header.ReadU32(length) || !header.ReadU32(checksum) ||
+		magic != SNAPSHOT_MAGIC || length > file.Size() - SNAPSHOT_HEADER_SIZE) {
+		LogError(LogCategory::STORE, "LocalStore: %s is not a world snapshot", SnapshotPath().c_str());
+		return false;
+	}
+
+	const uint8_t* payload = file.Data() + SNAPSHOT_HEADER_SIZE;
+	WorldChangeSet state;
+	if (RecordChecksum(payload, length) != checksum || !WorldJournal::Decode(payload, length, state)) {
+		LogError(LogCategory::STORE, "LocalStore: %s is corrupt", SnapshotPath().c_str());
+		return false;
+	}
+
+	Merge(state);
+	return true;
+}
+
+bool LocalWorldStore::Load(WorldChangeSet& out)
+{
+	out.Clear();
+	m_computers.clear();
+	m_missions.clear();
+	m_accounts.clear();
+
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+
+	if (!LoadSnapshot()) {
+		return false;
+	}
+
+	// Writes since the last snapshot. Replayed segments are dropped by the next
+	// compaction, but don't count towards triggering it.
+	if (!m_log.Open((std::filesystem::path(m_directory) / "log").string())) {
+		return false;
+	}
+	size_t records = m_log.Replay([this](const WorldChangeSet& changes) { Merge(changes); });
+
+	CollectById(m_computers, out.computers);
+	CollectById(m_missions, out.missions);
+	CollectById(m_accounts, out.accounts);
+
+	LogInfo(LogCategory::STORE,
+			"LocalStore: Loaded %s (%zu log records replayed)",
+			m_directory.c_str(),
+			records);
+	return true;
+}
+
+bool LocalWorldStore::Import(WorldStore& source)
+{
+	WorldChangeSet state;
+	if (!source.Load(state)) {
+		LogError(LogCategory::STORE, "LocalStore: Cannot read the %s store", source.GetName());
+		return false;
+	}
+
+	// A failed or unreachable source reads as an empty world, which must not
+	// replace a real one
+	if (state.computers.empty()) {
+		LogError(LogCategory::STORE,
+				 "LocalStore: The %s store holds no computers, not importing",
+				 source.GetName());
+		return false;
+	}
+
+	// Load opens the log, so Compact can drop whatever it held along with the old snapshot
+	WorldChangeSet previous;
+	if (!Load(previous)) {
+		return false;
+	}
+	m_computers.clear();
+	m_missions.clear();
+	m_accounts.clear();
+	Merge(state);
+
+	if (!Compact()) {
+		return false; // The old snapshot and log are untouched
+	}
+
+	LogInfo(LogCategory::STORE,
+			"LocalStore: Imported %zu computers, %zu missions and %zu accounts from %s",
+			state.computers.size(),
+			state.missions.size(),
+			state.accounts.size(),
+			source.GetName());
+	return true;
+}
+
+bool LocalWorldStore::Write(const WorldChangeSet& changes)
+{
+	if (!m_log.IsOpen()) {
+		return false; // Load() opens the log
+	}
+
+	if (!m_log.Append(changes) || !SyncDescriptor(m_log.GetDescriptor())) {
+		return false;
+	}
+	Merge(changes);
+
+	// The write is already durable in the log, so a failed compaction only
+	// means the log keeps growing until the next attempt
+	if (m_log.GetSegmentBytes() >= m_compactBytes) {
+		Compact();
+	}
+	return true;
+}
+
+bool LocalWorldStore::Compact()
+{
+	if (!m_log.IsOpen()) {
+		return false;
+	}
+
+	// Everything merged so far is in this or an earlier segment
+	uint32_t sealed = m_log.Rotate();
+	m_log.CloseSealed();
+
+	if (!WriteSnapshot()) {
+		return false; // Old segments stay and are replayed on top of the old snapshot
+	}
+	m_log.DropThrough(sealed);
+	return true;
+}
+
+bool LocalWorldStore::WriteSnapshot()
+{
+	WorldChangeSet state;
+	CollectById(m_computers, state.computers);
+	CollectById(m_missions, state.missions);
+	CollectById(m_accounts, state.accounts);
+
+	Net::DeltaBuffer payload;
+	WorldJournal::Encode(state, payload);
+
+	Net::DeltaBuffer header;
+	header.WriteU32(SNAPSHOT_MAGIC);
+	header.WriteU32(static_cast<uint32_t>(payload.Size()));
+	header.WriteU32(RecordChecksum(payload.Data(), payload.Size()));
+
+	// Write beside the old snapshot and rename over it, so a crash leaves one
+	// complete snapshot or the other
+	std::string tempPath = SnapshotPath() + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (!file) {
+		LogError(LogCategory::STORE, "LocalStore: Cannot create %s", tempPath.c_str());
+		return false;
+	}
+
+	bool ok = fwrite(header.Data(), 1, header.Size(), file) == header.Size() &&
+			  fwrite(payload.Data(), 1, payload.Size(), file) == payload.Size() && fflush(file) == 0;
+#ifdef _WIN32
+	ok = ok && SyncDescriptor(_fileno(file));
+#else
+	ok = ok && SyncDescriptor(fileno(file));
+#endif
+	fclose(file);
+
+	std::error_code ec;
+	if (ok) {
+		std::filesystem::rename(tempPath, SnapshotPath(), ec);
+	}
+	if (!ok || ec) {
+		LogError(LogCategory::STORE, "LocalStore: Snapshot write failed");
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+
+	LogInfo(LogCategory::STORE,
+			"LocalStore: Snapshot written (%zu computers, %zu missions, %zu accounts, %zu bytes)",
+			state.computers.size(),
+			state.missions.size(),
+			state.accounts.size(),
+			payload.Size());
+	return true;
+}
+
+} // namespace Server
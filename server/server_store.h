@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+ * World stores - pluggable backends for the persistent world
+ *
+ * ServerWorld::Load reads the whole world from a store at startup, and
+ * WorldPersister writes batches of changed entities back to it. Two backends:
+ *   SupabaseWorldStore - the shared remote database (REST bulk upserts)
+ *   LocalWorldStore    - snapshot + append-only log on local disk, for
+ *                        offline servers, CI and load testing
+ *
+ * A local store starts out empty; LocalWorldStore::Import seeds it with a copy
+ * of another store's world (--import supabase).
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "server_persistence.h"
+#include "server_world.h"
+
+namespace Server {
+
+// ============================================================================
+// World Store Interface
+// ============================================================================
+
+class WorldStore {
+public:
+	virtual ~WorldStore() = default;
+
+	virtual const char* GetName() const = 0;
+
+	// Read every persisted entity into out. False if the store is unreadable;
+	// an empty store is not an error.
+	virtual bool Load(WorldChangeSet& out) = 0;
+
+	// Insert or replace every entity in changes. Called from the persister
+	// thread only; must not touch ServerWorld.
+	virtual bool Write(const WorldChangeSet& changes) = 0;
+};
+
+// ============================================================================
+// Supabase Store
+// ============================================================================
+
+class SupabaseWorldStore : public WorldStore {
+public:
+	const char* GetName() const override { return "supabase"; }
+	bool Load(WorldChangeSet& out) override;
+	bool Write(const WorldChangeSet& changes) override;
+};
+
+// ============================================================================
+// Local Store
+// ============================================================================
+
+// <directory>/world.snapshot holds the full world as one checksummed record
+// and is memory-mapped on load. Writes append to a WorldJournal in
+// <directory>/log and fsync; once the log passes compactBytes the merged state
+// is written to a new snapshot (temp file + rename) and the log is dropped.
+
+class LocalWorldStore : public WorldStore {
+public:
+	static constexpr size_t DEFAULT_COMPACT_BYTES = 16 * 1024 * 1024;
+
+	explicit LocalWorldStore(const std::string& directory, size_t compactBytes = DEFAULT_COMPACT_BYTES);
+
+	const char* GetName() const override { return "local"; }
+	bool Load(WorldChangeSet& out) override;
+	bool Write(const WorldChangeSet& changes) override;
+
+	// Write a fresh snapshot and drop the log now
+	bool Compact();
+
+	// Replace the stored world with everything source holds, written straight
+	// to a new snapshot. False, leaving the store as it was, if source is
+	// unreadable or empty.
+	bool Import(WorldStore& source);
+
+private:
+	std::string SnapshotPath() const;
+	bool LoadSnapshot();
+	bool WriteSnapshot();
+	void Merge(const WorldChangeSet& changes);
+
+	std::string m_directory;
+	size_t m_compactBytes; // Log segment size that triggers a new snapshot
+	WorldJournal m_log;
+
+	// Full world as of the last write, kept for compaction
+	std::unordered_map<int32_t, ServerComputer> m_computers;
+	std::unordered_map<int32_t, ServerMission> m_missions;
+	std::unordered_map<int32_t, ServerBankAccount> m_accounts;
+};
+
+} // namespace Server
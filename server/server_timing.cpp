@@ -0,0 +1,121 @@
+/*
+ * Server tick timing implementation
+ */
+
+#include "server_timing.h"
+#include "server_log.h"
+
+#include <bit>
+
+namespace Server {
+
+// ============================================================================
+// TickHistogram
+// ============================================================================
+
+TickHistogram::TickHistogram() { Reset(); }
+
+void TickHistogram::Reset()
+{
+	m_buckets.fill(0);
+	m_count = 0;
+	m_totalMs = 0.0;
+	m_maxMs = 0.0;
+}
+
+int TickHistogram::BucketIndex(uint64_t micros)
+{
+	if (micros < SUB_BUCKETS) {
+		return static_cast<int>(micros);
+	}
+
+	int exponent = static_cast<int>(std::bit_width(micros)) - 1;
+	int mantissa = static_cast<int>((micros >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+	int index = (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + mantissa;
+	return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+uint64_t TickHistogram::BucketUpperBound(int index)
+{
+	if (index < SUB_BUCKETS) {
+		return static_cast<uint64_t>(index) + 1;
+	}
+
+	int shift = index / SUB_BUCKETS - 1;
+	uint64_t mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+	return (mantissa + 1) << shift;
+}
+
+void TickHistogram::Record(double milliseconds)
+{
+	if (milliseconds < 0.0) {
+		milliseconds = 0.0;
+	}
+
+	m_buckets[BucketIndex(static_cast<uint64_t>(milliseconds * 1000.0))]++;
+	m_count++;
+	m_totalMs += milliseconds;
+	if (milliseconds > m_maxMs) {
+		m_maxMs = milliseconds;
+	}
+}
+
+double TickHistogram::Percentile(double percentile) const
+{
+	if (m_count == 0) {
+		return 0.0;
+	}
+
+	// Rank of the sample we want, 1-based
+	uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * m_count + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; i++) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			double bound = BucketUpperBound(i) / 1000.0;
+			return bound < m_maxMs ? bound : m_maxMs;
+		}
+	}
+	return m_maxMs;
+}
+
+// ============================================================================
+// ServerTimingStats
+// ============================================================================
+
+void ServerTimingStats::Reset()
+{
+	gameTick.Reset();
+	networkTick.Reset();
+	gameOverruns = 0;
+	networkOverruns = 0;
+	droppedGameTicks = 0;
+	droppedNetworkTicks = 0;
+}
+
+void ServerTimingStats::Print(double windowSeconds) const
+{
+	LogInfo(LogCategory::TIMING,
+			"%.0fs window | game %llu ticks p50=%.3fms p99=%.3fms max=%.3fms"
+			" | net %llu ticks p50=%.3fms p99=%.3fms max=%.3fms"
+			" | overruns game=%llu net=%llu | dropped game=%llu net=%llu",
+			windowSeconds,
+			static_cast<unsigned long long>(gameTick.GetCount()),
+			gameTick.Percentile(50.0),
+			gameTick.Percentile(99.0),
+			gameTick.GetMax(),
+			static_cast<unsigned long long>(networkTick.GetCount()),
+			networkTick.Percentile(50.0),
+			networkTick.Percentile(99.0),
+			networkTick.GetMax(),
+			static_cast<unsigned long long>(gameOverruns),
+			static_cast<unsigned long long>(networkOverruns),
+			static_cast<unsigned long long>(droppedGameTicks),
+			static_cast<unsigned long long>(droppedNetworkTicks));
+}
+
+} // namespace Server
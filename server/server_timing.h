@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+ * Server tick timing - latency histograms for capacity planning
+ * Fixed log-linear buckets, so recording is O(1) and allocation free
+ */
+
+#include <array>
+#include <cstdint>
+
+namespace Server {
+
+// ============================================================================
+// Tick Histogram
+// ============================================================================
+
+// Durations are bucketed in microseconds: exact below 8us, then 8 sub-buckets
+// per power of two (~12% resolution) up to several hours.
+
+class TickHistogram {
+public:
+	TickHistogram();
+
+	void Record(double milliseconds);
+	void Reset();
+
+	// Upper bound of the bucket holding the given percentile (0-100), in ms
+	double Percentile(double percentile) const;
+
+	uint64_t GetCount() const { return m_count; }
+	double GetMax() const { return m_maxMs; }
+	double GetMean() const { return m_count ? m_totalMs / m_count : 0.0; }
+
+private:
+	static constexpr int SUB_BUCKET_BITS = 3;
+	static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static constexpr int BUCKET_COUNT = 32 * SUB_BUCKETS;
+
+	static int BucketIndex(uint64_t micros);
+	static uint64_t BucketUpperBound(int index);
+
+	std::array<uint64_t, BUCKET_COUNT> m_buckets;
+	uint64_t m_count;
+	double m_totalMs;
+	double m_maxMs;
+};
+
+// ============================================================================
+// Server Timing Stats
+// ============================================================================
+
+struct ServerTimingStats {
+	TickHistogram gameTick; // GameTick() duration
+	TickHistogram networkTick; // NetworkTick() duration
+	uint64_t gameOverruns = 0; // Game ticks that took longer than their interval
+	uint64_t networkOverruns = 0; // Network ticks that took longer than their interval
+	uint64_t droppedGameTicks = 0; // Skipped by the catch-up limit
+	uint64_t droppedNetworkTicks = 0; // Network ticks merged into a later one
+
+	void Reset();
+
+	// One summary line in the TIMING log category
+	void Print(double windowSeconds) const;
+};
+
+} // namespace Server
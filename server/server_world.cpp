@@ -4,7 +4,9 @@
  */
 
 #include "server_world.h"
-#include "network/supabase_client.h"
+#include "server_log.h"
+#include "server_store.h"
+#include "network/ipaddress.h"
 #include <cstdio>
 #include <algorithm>
 
@@ -15,7 +17,6 @@ namespace Server {
 // ============================================================================
 
 ServerWorld::ServerWorld() :
-	m_dirty(false),
 	m_nextAgentId(1000),
 	m_nextMissionId(1),
 	m_hourlyTimer(0.0f),
@@ -23,115 +24,249 @@ ServerWorld::ServerWorld() :
 {
 }
 
-ServerWorld::~ServerWorld()
+ServerWorld::~ServerWorld() { }
+
+// ============================================================================
+// Data Loading/Saving
+// ============================================================================
+
+bool ServerWorld::Load(WorldStore& store)
 {
-	if (m_dirty) {
-		SaveDirtyState();
+	LogInfo(LogCategory::WORLD, "Loading world state from %s store...", store.GetName());
+
+	WorldChangeSet state;
+	if (!store.Load(state)) {
+		LogError(LogCategory::WORLD, "Could not read the %s store", store.GetName());
+		return false;
+	}
+
+	m_computers = std::move(state.computers);
+	LogInfo(LogCategory::WORLD, "Loaded %zu computers", m_computers.size());
+
+	m_missions = std::move(state.missions);
+	for (const auto& m : m_missions) {
+		// Spawned missions must not reuse a stored id
+		m_nextMissionId = std::max(m_nextMissionId, m.id + 1);
 	}
+
+	LogInfo(LogCategory::WORLD, "Loaded %zu missions", m_missions.size());
+
+	m_bankAccounts = std::move(state.accounts);
+
+	RebuildIndexes();
+
+	m_dirtyComputers.clear();
+	m_dirtyMissions.clear();
+	m_dirtyAccounts.clear();
+	return true;
 }
 
 // ============================================================================
-// Data Loading/Saving
+// Dirty Tracking
 // ============================================================================
 
-void ServerWorld::LoadFromSupabase()
+void ServerWorld::MarkDirty(const ServerComputer& computer)
 {
-	printf("[ServerWorld] Loading world state from Supabase...\n");
+	m_dirtyComputers.insert(&computer - m_computers.data());
+}
 
-	// Load computers
-	auto computers = Net::SupabaseClient::Instance().GetAllComputers();
-	m_computers.clear();
-	m_computerByIp.clear();
+void ServerWorld::MarkDirty(const ServerMission& mission)
+{
+	m_dirtyMissions.insert(&mission - m_missions.data());
+}
+
+void ServerWorld::MarkDirty(const ServerBankAccount& account)
+{
+	m_dirtyAccounts.insert(&account - m_bankAccounts.data());
+}
+
+bool ServerWorld::HasChanges() const
+{
+	return !m_dirtyComputers.empty() || !m_dirtyMissions.empty() || !m_dirtyAccounts.empty();
+}
+
+bool ServerWorld::CollectChanges(WorldChangeSet& out)
+{
+	out.Clear();
+	if (!HasChanges()) {
+		return false;
+	}
+
+	for (size_t index : m_dirtyComputers) {
+		if (index < m_computers.size()) {
+			out.computers.push_back(m_computers[index]);
+			out.computers.back().connectedPlayers.clear(); // Runtime only
+		}
+	}
+	for (size_t index : m_dirtyMissions) {
+		if (index < m_missions.size()) {
+			out.missions.push_back(m_missions[index]);
+		}
+	}
+	for (size_t index : m_dirtyAccounts) {
+		if (index < m_bankAccounts.size()) {
+			out.accounts.push_back(m_bankAccounts[index]);
+		}
+	}
 
-	for (const auto& c : computers) {
-		ServerComputer sc;
-		sc.id = c.id;
-		sc.ipString = c.ip;
-		sc.ip = 0; // TODO: Parse IP string to int
-		sc.name = c.name;
-		sc.securityLevel = c.security_level;
-		sc.running = c.is_running;
-		sc.type = 0;
-		sc.proxyBypassed = false;
-		sc.firewallBypassed = false;
-		sc.monitorDisabled = false;
+	m_dirtyComputers.clear();
+	m_dirtyMissions.clear();
+	m_dirtyAccounts.clear();
+	return !out.Empty();
+}
 
-		m_computerByIp[sc.ip] = m_computers.size();
-		m_computers.push_back(sc);
+void ServerWorld::ApplyChanges(const WorldChangeSet& changes)
+{
+	// Nothing is marked dirty: the persister already holds these changes.
+	// IPs, mission ids and account keys never change once created, so the
+	// indexes find the same entity the journal recorded.
+	for (const auto& c : changes.computers) {
+		ServerComputer* target = FindComputerByIP(c.ip);
+		if (!target || target->id != c.id) {
+			continue; // Computers aren't created at runtime
+		}
+		target->securityLevel = c.securityLevel;
+		target->running = c.running;
+		target->proxyBypassed = c.proxyBypassed;
+		target->firewallBypassed = c.firewallBypassed;
+		target->monitorDisabled = c.monitorDisabled;
+	}
+
+	for (const auto& m : changes.missions) {
+		if (ServerMission* target = FindMission(m.id)) {
+			*target = m;
+		} else {
+			AddMission(m); // Spawned after the last load
+		}
 	}
 
-	printf("[ServerWorld] Loaded %zu computers\n", m_computers.size());
+	for (const auto& a : changes.accounts) {
+		ServerBankAccount* target = FindAccount(a.bankIp, a.accountNumber);
+		if (target && target->id == a.id) {
+			*target = a;
+		} else if (!target) {
+			AddAccount(a);
+		}
+	}
+}
 
-	// Load missions
-	auto missions = Net::SupabaseClient::Instance().GetAllMissions();
-	m_missions.clear();
+// ============================================================================
+// Indexes
+// ============================================================================
 
-	for (const auto& m : missions) {
-		ServerMission sm;
-		sm.id = m.id;
-		sm.type = m.mission_type;
-		sm.targetIp = 0; // TODO: Parse
-		sm.payment = m.payment;
-		sm.difficulty = m.difficulty;
-		sm.claimedBy = m.claimed_by;
-		sm.completed = m.completed;
+uint64_t ServerWorld::AccountHash(int64_t bankIp, const std::string& accountNumber)
+{
+	return HashKey(static_cast<uint64_t>(bankIp), accountNumber);
+}
 
-		m_missions.push_back(sm);
+bool ServerWorld::IndexComputer(size_t position)
+{
+	const ServerComputer& computer = m_computers[position];
+	if (FindComputerByIP(computer.ip)) {
+		return false;
 	}
+	m_computerByIp.Insert(HashKey(static_cast<uint64_t>(computer.ip)), static_cast<uint32_t>(position));
+	return true;
+}
 
-	printf("[ServerWorld] Loaded %zu missions\n", m_missions.size());
+bool ServerWorld::IndexMission(size_t position)
+{
+	const ServerMission& mission = m_missions[position];
+	if (FindMission(mission.id)) {
+		return false;
+	}
+	m_missionById.Insert(HashKey(static_cast<uint32_t>(mission.id)), static_cast<uint32_t>(position));
+	return true;
+}
 
-	m_dirty = false;
+bool ServerWorld::IndexAccount(size_t position)
+{
+	const ServerBankAccount& account = m_bankAccounts[position];
+	if (FindAccount(account.bankIp, account.accountNumber)) {
+		return false;
+	}
+	uint64_t hash = AccountHash(account.bankIp, account.accountNumber);
+	m_accountByKey.Insert(hash, static_cast<uint32_t>(position));
+	return true;
 }
 
-void ServerWorld::SaveDirtyState()
+void ServerWorld::RebuildIndexes()
 {
-	if (!m_dirty) {
-		return;
+	m_computerByIp.Clear();
+	m_missionById.Clear();
+	m_accountByKey.Clear();
+	m_computerByIp.Reserve(m_computers.size());
+	m_missionById.Reserve(m_missions.size());
+	m_accountByKey.Reserve(m_bankAccounts.size());
+
+	// First entity with a key wins; later duplicates stay in the vectors (and
+	// are still persisted) but can't be looked up
+	size_t duplicates = 0;
+	for (size_t i = 0; i < m_computers.size(); i++) {
+		duplicates += IndexComputer(i) ? 0 : 1;
+	}
+	for (size_t i = 0; i < m_missions.size(); i++) {
+		duplicates += IndexMission(i) ? 0 : 1;
+	}
+	for (size_t i = 0; i < m_bankAccounts.size(); i++) {
+		duplicates += IndexAccount(i) ? 0 : 1;
 	}
 
-	printf("[ServerWorld] Saving dirty state...\n");
+	if (duplicates > 0) {
+		LogWarn(LogCategory::WORLD, "%zu entities share an IP, mission id or account key", duplicates);
+	}
+}
 
-	// TODO: Iterate and save only changed entities
+ServerMission& ServerWorld::AddMission(const ServerMission& mission)
+{
+	m_missions.push_back(mission);
+	IndexMission(m_missions.size() - 1);
+	m_nextMissionId = std::max(m_nextMissionId, mission.id + 1);
+	return m_missions.back();
+}
 
-	m_dirty = false;
+ServerBankAccount& ServerWorld::AddAccount(const ServerBankAccount& account)
+{
+	m_bankAccounts.push_back(account);
+	IndexAccount(m_bankAccounts.size() - 1);
+	return m_bankAccounts.back();
 }
 
 // ============================================================================
 // Computer Management
 // ============================================================================
 
+const ServerComputer* ServerWorld::FindComputerByIP(int64_t ip) const
+{
+	uint32_t position = m_computerByIp.Find(HashKey(static_cast<uint64_t>(ip)),
+											[&](uint32_t i) { return m_computers[i].ip == ip; });
+	return position != EntityIndex::NONE ? &m_computers[position] : nullptr;
+}
+
 ServerComputer* ServerWorld::FindComputerByIP(int64_t ip)
 {
-	auto it = m_computerByIp.find(ip);
-	if (it != m_computerByIp.end() && it->second < m_computers.size()) {
-		return &m_computers[it->second];
-	}
-	return nullptr;
+	return const_cast<ServerComputer*>(static_cast<const ServerWorld*>(this)->FindComputerByIP(ip));
 }
 
 ServerComputer* ServerWorld::FindComputerByIPString(const char* ipString)
 {
-	for (auto& c : m_computers) {
-		if (c.ipString == ipString) {
-			return &c;
-		}
-	}
-	return nullptr;
+	int64_t ip;
+	return Net::ParseIP(ipString, ip) ? FindComputerByIP(ip) : nullptr;
 }
 
 bool ServerWorld::PlayerConnect(uint32_t playerId, int64_t targetIp)
 {
 	ServerComputer* computer = FindComputerByIP(targetIp);
 	if (!computer) {
-		printf("[ServerWorld] REJECT: Player %u tried to connect to unknown IP\n", playerId);
+		LogDebug(LogCategory::ACTION, "REJECT: Player %u tried to connect to unknown IP", playerId);
 		return false;
 	}
 
 	if (!computer->running) {
-		printf("[ServerWorld] REJECT: Player %u tried to connect to offline computer %s\n",
-			   playerId,
-			   computer->name.c_str());
+		LogDebug(LogCategory::ACTION,
+				 "REJECT: Player %u tried to connect to offline computer %s",
+				 playerId,
+				 computer->name.c_str());
 		return false;
 	}
 
@@ -141,13 +276,21 @@ bool ServerWorld::PlayerConnect(uint32_t playerId, int64_t targetIp)
 		connected.push_back(playerId);
 	}
 
-	printf("[ServerWorld] Player %u connected to %s\n", playerId, computer->name.c_str());
-	m_dirty = true;
+	if (ServerAgent* agent = FindPlayerAgent(playerId)) {
+		agent->connectedToIp = targetIp;
+		AddKnownLink(*agent, targetIp);
+	}
+
 	return true;
 }
 
 void ServerWorld::PlayerDisconnect(uint32_t playerId, int64_t fromIp)
 {
+	ServerAgent* agent = FindPlayerAgent(playerId);
+	if (agent && agent->connectedToIp == fromIp) {
+		agent->connectedToIp = 0;
+	}
+
 	ServerComputer* computer = FindComputerByIP(fromIp);
 	if (!computer) {
 		return;
@@ -159,7 +302,7 @@ void ServerWorld::PlayerDisconnect(uint32_t playerId, int64_t fromIp)
 	// Reset bypass states for this player
 	// Note: In full implementation, track per-player bypass state
 
-	printf("[ServerWorld] Player %u disconnected from %s\n", playerId, computer->name.c_str());
+	LogDebug(LogCategory::ACTION, "Player %u disconnected from %s", playerId, computer->name.c_str());
 }
 
 // ============================================================================
@@ -176,15 +319,16 @@ bool ServerWorld::TryBypassProxy(uint32_t playerId, int64_t targetIp, int16_t pl
 	// Simple check: player rating must be >= security level
 	if (playerRating >= computer->securityLevel) {
 		computer->proxyBypassed = true;
-		m_dirty = true;
-		printf("[ServerWorld] Player %u bypassed proxy on %s\n", playerId, computer->name.c_str());
+		MarkDirty(*computer);
+		LogDebug(LogCategory::ACTION, "Player %u bypassed proxy on %s", playerId, computer->name.c_str());
 		return true;
 	}
 
-	printf("[ServerWorld] REJECT: Player %u failed to bypass proxy (rating %d < security %d)\n",
-		   playerId,
-		   playerRating,
-		   computer->securityLevel);
+	LogDebug(LogCategory::ACTION,
+			 "REJECT: Player %u failed to bypass proxy (rating %d < security %d)",
+			 playerId,
+			 playerRating,
+			 computer->securityLevel);
 	return false;
 }
 
@@ -197,8 +341,8 @@ bool ServerWorld::TryBypassFirewall(uint32_t playerId, int64_t targetIp, int16_t
 
 	if (playerRating >= computer->securityLevel) {
 		computer->firewallBypassed = true;
-		m_dirty = true;
-		printf("[ServerWorld] Player %u bypassed firewall on %s\n", playerId, computer->name.c_str());
+		MarkDirty(*computer);
+		LogDebug(LogCategory::ACTION, "Player %u bypassed firewall on %s", playerId, computer->name.c_str());
 		return true;
 	}
 
@@ -214,8 +358,8 @@ bool ServerWorld::TryDisableMonitor(uint32_t playerId, int64_t targetIp, int16_t
 
 	if (playerRating >= computer->securityLevel) {
 		computer->monitorDisabled = true;
-		m_dirty = true;
-		printf("[ServerWorld] Player %u disabled monitor on %s\n", playerId, computer->name.c_str());
+		MarkDirty(*computer);
+		LogDebug(LogCategory::ACTION, "Player %u disabled monitor on %s", playerId, computer->name.c_str());
 		return true;
 	}
 
@@ -228,12 +372,10 @@ bool ServerWorld::TryDisableMonitor(uint32_t playerId, int64_t targetIp, int16_t
 
 ServerBankAccount* ServerWorld::FindAccount(int64_t bankIp, const std::string& accountNumber)
 {
-	for (auto& acc : m_bankAccounts) {
-		if (acc.bankIp == bankIp && acc.accountNumber == accountNumber) {
-			return &acc;
-		}
-	}
-	return nullptr;
+	uint32_t position = m_accountByKey.Find(AccountHash(bankIp, accountNumber), [&](uint32_t i) {
+		return m_bankAccounts[i].bankIp == bankIp && m_bankAccounts[i].accountNumber == accountNumber;
+	});
+	return position != EntityIndex::NONE ? &m_bankAccounts[position] : nullptr;
 }
 
 bool ServerWorld::TransferMoney(int64_t srcBankIp,
@@ -250,22 +392,28 @@ bool ServerWorld::TransferMoney(int64_t srcBankIp,
 	ServerBankAccount* dst = FindAccount(dstBankIp, dstAccount);
 
 	if (!src || !dst) {
-		printf("[ServerWorld] REJECT: Transfer failed - account not found\n");
+		LogDebug(LogCategory::ACTION, "REJECT: Transfer failed - account not found");
 		return false;
 	}
 
 	if (src->balance < amount) {
-		printf(
-			"[ServerWorld] REJECT: Transfer failed - insufficient funds (%d < %d)\n", src->balance, amount);
+		LogDebug(LogCategory::ACTION,
+				 "REJECT: Transfer failed - insufficient funds (%d < %d)",
+				 src->balance,
+				 amount);
 		return false;
 	}
 
 	src->balance -= amount;
 	dst->balance += amount;
-	m_dirty = true;
+	MarkDirty(*src);
+	MarkDirty(*dst);
 
-	printf(
-		"[ServerWorld] Transferred %d credits: %s -> %s\n", amount, srcAccount.c_str(), dstAccount.c_str());
+	LogDebug(LogCategory::ACTION,
+			 "Transferred %d credits: %s -> %s",
+			 amount,
+			 srcAccount.c_str(),
+			 dstAccount.c_str());
 
 	return true;
 }
@@ -276,12 +424,9 @@ bool ServerWorld::TransferMoney(int64_t srcBankIp,
 
 ServerMission* ServerWorld::FindMission(int32_t missionId)
 {
-	for (auto& m : m_missions) {
-		if (m.id == missionId) {
-			return &m;
-		}
-	}
-	return nullptr;
+	uint32_t position = m_missionById.Find(HashKey(static_cast<uint32_t>(missionId)),
+										   [&](uint32_t i) { return m_missions[i].id == missionId; });
+	return position != EntityIndex::NONE ? &m_missions[position] : nullptr;
 }
 
 bool ServerWorld::ClaimMission(int32_t missionId, uint32_t playerId)
@@ -292,15 +437,17 @@ bool ServerWorld::ClaimMission(int32_t missionId, uint32_t playerId)
 	}
 
 	if (mission->claimedBy != 0) {
-		printf(
-			"[ServerWorld] REJECT: Mission %d already claimed by player %d\n", missionId, mission->claimedBy);
+		LogDebug(LogCategory::ACTION,
+				 "REJECT: Mission %d already claimed by player %d",
+				 missionId,
+				 mission->claimedBy);
 		return false;
 	}
 
 	mission->claimedBy = playerId;
-	m_dirty = true;
+	MarkDirty(*mission);
 
-	printf("[ServerWorld] Player %u claimed mission %d\n", playerId, missionId);
+	LogInfo(LogCategory::ACTION, "Player %u claimed mission %d", playerId, missionId);
 	return true;
 }
 
@@ -312,18 +459,21 @@ bool ServerWorld::CompleteMission(int32_t missionId, uint32_t playerId)
 	}
 
 	if (mission->claimedBy != static_cast<int32_t>(playerId)) {
-		printf(
-			"[ServerWorld] REJECT: Player %u tried to complete mission %d not theirs\n", playerId, missionId);
+		LogDebug(LogCategory::ACTION,
+				 "REJECT: Player %u tried to complete mission %d not theirs",
+				 playerId,
+				 missionId);
 		return false;
 	}
 
 	mission->completed = true;
-	m_dirty = true;
+	MarkDirty(*mission);
 
-	printf("[ServerWorld] Player %u completed mission %d (payment: %d)\n",
-		   playerId,
-		   missionId,
-		   mission->payment);
+	LogInfo(LogCategory::ACTION,
+			"Player %u completed mission %d (payment: %d)",
+			playerId,
+			missionId,
+			mission->payment);
 
 	return true;
 }
@@ -341,7 +491,130 @@ void ServerWorld::LogAccess(int32_t computerId, int64_t accessorIp, const std::s
 	log.timestamp = 0; // TODO: Get current time
 
 	m_accessLogs.push_back(log);
-	m_dirty = true;
+}
+
+// ============================================================================
+// Player Agents
+// ============================================================================
+
+ServerAgent* ServerWorld::CreatePlayerAgent(
+	uint32_t playerId, const std::string& handle, int16_t rating, int32_t credits)
+{
+	if (ServerAgent* existing = FindPlayerAgent(playerId)) {
+		return existing;
+	}
+
+	ServerAgent agent;
+	agent.id = m_nextAgentId++;
+	agent.handle = handle;
+	agent.isNPC = false;
+	agent.playerId = playerId;
+	agent.uplinkRating = rating;
+	agent.neuromancerRating = 0;
+	agent.credits = credits;
+	agent.connectedToIp = 0;
+	agent.currentMissionId = 0;
+	agent.aiThinkTimer = 0.0f;
+
+	m_agentByPlayer[playerId] = m_agents.size();
+	m_agents.push_back(agent);
+	return &m_agents.back();
+}
+
+void ServerWorld::RemovePlayerAgent(uint32_t playerId)
+{
+	auto it = m_agentByPlayer.find(playerId);
+	if (it == m_agentByPlayer.end()) {
+		return;
+	}
+
+	ServerAgent& agent = m_agents[it->second];
+	if (agent.connectedToIp != 0) {
+		PlayerDisconnect(playerId, agent.connectedToIp);
+	}
+
+	m_agents.erase(m_agents.begin() + it->second);
+	RebuildAgentIndex();
+}
+
+ServerAgent* ServerWorld::FindPlayerAgent(uint32_t playerId)
+{
+	auto it = m_agentByPlayer.find(playerId);
+	return it != m_agentByPlayer.end() ? &m_agents[it->second] : nullptr;
+}
+
+const ServerAgent* ServerWorld::FindPlayerAgent(uint32_t playerId) const
+{
+	auto it = m_agentByPlayer.find(playerId);
+	return it != m_agentByPlayer.end() ? &m_agents[it->second] : nullptr;
+}
+
+bool ServerWorld::AddBounce(uint32_t playerId, int64_t ip)
+{
+	ServerAgent* agent = FindPlayerAgent(playerId);
+	ServerComputer* computer = FindComputerByIP(ip);
+	if (!agent || !computer) {
+		return false;
+	}
+
+	agent->bouncePath.push_back(computer->ip);
+	AddKnownLink(*agent, computer->ip);
+	return true;
+}
+
+void ServerWorld::ClearBounces(uint32_t playerId)
+{
+	if (ServerAgent* agent = FindPlayerAgent(playerId)) {
+		agent->bouncePath.clear();
+	}
+}
+
+void ServerWorld::AddKnownLink(ServerAgent& agent, int64_t ip)
+{
+	auto& links = agent.knownLinks;
+	if (std::find(links.begin(), links.end(), ip) == links.end()) {
+		links.push_back(ip);
+	}
+}
+
+void ServerWorld::RebuildAgentIndex()
+{
+	m_agentByPlayer.clear();
+	for (size_t i = 0; i < m_agents.size(); i++) {
+		if (!m_agents[i].isNPC) {
+			m_agentByPlayer[m_agents[i].playerId] = i;
+		}
+	}
+}
+
+// ============================================================================
+// Interest Management
+// ============================================================================
+
+void ServerWorld::GetVisibleComputers(uint32_t playerId, std::unordered_set<int32_t>& outComputerIds) const
+{
+	outComputerIds.clear();
+
+	const ServerAgent* agent = FindPlayerAgent(playerId);
+	if (!agent) {
+		return;
+	}
+
+	auto addIp = [&](int64_t ip) {
+		if (const ServerComputer* computer = FindComputerByIP(ip)) {
+			outComputerIds.insert(computer->id);
+		}
+	};
+
+	for (int64_t ip : agent->knownLinks) {
+		addIp(ip);
+	}
+	for (int64_t ip : agent->bouncePath) {
+		addIp(ip);
+	}
+	if (agent->connectedToIp != 0) {
+		addIp(agent->connectedToIp);
+	}
 }
 
 // ============================================================================
@@ -350,7 +623,7 @@ void ServerWorld::LogAccess(int32_t computerId, int64_t accessorIp, const std::s
 
 void ServerWorld::SpawnNPCs(int count)
 {
-	printf("[ServerWorld] Spawning %d NPCs...\n", count);
+	LogInfo(LogCategory::NPC, "Spawning %d NPCs...", count);
 
 	static const char* npcNames[] = { "Scarab", "Serpent", "Phoenix", "Raven",	 "Falcon",
 									  "Shadow", "Ghost",   "Phantom", "Specter", "Wraith" };
@@ -369,7 +642,7 @@ void ServerWorld::SpawnNPCs(int count)
 		npc.aiThinkTimer = 5.0f + (i * 2.0f); // Stagger AI ticks
 
 		m_agents.push_back(npc);
-		printf("[ServerWorld] Created NPC: %s (rating %d)\n", npc.handle.c_str(), npc.uplinkRating);
+		LogInfo(LogCategory::NPC, "Created NPC: %s (rating %d)", npc.handle.c_str(), npc.uplinkRating);
 	}
 }
 
@@ -415,8 +688,8 @@ void ServerWorld::UpdateNPCAgent(ServerAgent& npc, float deltaTime)
 			if (m.claimedBy == 0 && !m.completed && m.difficulty <= npc.uplinkRating) {
 				npc.currentMissionId = m.id;
 				m.claimedBy = npc.id; // Use agent ID for NPCs
-				m_dirty = true;
-				printf("[NPC AI] %s claimed mission %d\n", npc.handle.c_str(), m.id);
+				MarkDirty(m);
+				LogDebug(LogCategory::NPC, "%s claimed mission %d", npc.handle.c_str(), m.id);
 				break;
 			}
 		}
@@ -442,28 +715,32 @@ void ServerWorld::NPCAttemptMission(ServerAgent& npc)
 		// Success!
 		mission->completed = true;
 		npc.credits += mission->payment;
-		m_dirty = true;
+		MarkDirty(*mission);
 
-		printf("[NPC AI] %s COMPLETED mission %d, earned %d credits\n",
-			   npc.handle.c_str(),
-			   mission->id,
-			   mission->payment);
+		LogDebug(LogCategory::NPC,
+				 "%s COMPLETED mission %d, earned %d credits",
+				 npc.handle.c_str(),
+				 mission->id,
+				 mission->payment);
 
 		// Increase rating occasionally
 		if (rand() % 3 == 0) {
 			npc.uplinkRating++;
-			printf("[NPC AI] %s rating increased to %d\n", npc.handle.c_str(), npc.uplinkRating);
+			LogDebug(LogCategory::NPC, "%s rating increased to %d", npc.handle.c_str(), npc.uplinkRating);
 		}
 
 		npc.currentMissionId = 0;
 	} else {
 		// Failed - may get traced
-		printf("[NPC AI] %s failed mission %d attempt\n", npc.handle.c_str(), mission->id);
+		LogDebug(LogCategory::NPC, "%s failed mission %d attempt", npc.handle.c_str(), mission->id);
 
 		// 10% chance of getting caught
 		if (rand() % 10 == 0) {
 			npc.uplinkRating = std::max(0, npc.uplinkRating - 1);
-			printf("[NPC AI] %s TRACED! Rating dropped to %d\n", npc.handle.c_str(), npc.uplinkRating);
+			LogDebug(LogCategory::NPC,
+					 "%s TRACED! Rating dropped to %d",
+					 npc.handle.c_str(),
+					 npc.uplinkRating);
 		}
 	}
 }
@@ -474,12 +751,12 @@ void ServerWorld::NPCAttemptMission(ServerAgent& npc)
 
 void ServerWorld::HourlyTick()
 {
-	printf("[ServerWorld] Hourly tick - regenerating bank accounts\n");
+	LogInfo(LogCategory::ECONOMY, "Hourly tick - regenerating bank accounts");
 
 	for (auto& acc : m_bankAccounts) {
 		if (acc.regenRate > 0) {
 			acc.balance += acc.regenRate;
-			m_dirty = true;
+			MarkDirty(acc);
 		}
 	}
 }
@@ -500,13 +777,13 @@ void ServerWorld::SpawnMissions()
 		int toSpawn = (rand() % 5) + 3; // 3-7 new missions
 		for (int i = 0; i < toSpawn && m_missions.size() < MAX_MISSIONS; i++) {
 			ServerMission newMission = CreateRandomMission();
-			m_missions.push_back(newMission);
-			printf("[Economy] Spawned mission %d (difficulty %d, payment %d)\n",
-				   newMission.id,
-				   newMission.difficulty,
-				   newMission.payment);
+			MarkDirty(AddMission(newMission));
+			LogDebug(LogCategory::ECONOMY,
+					 "Spawned mission %d (difficulty %d, payment %d)",
+					 newMission.id,
+					 newMission.difficulty,
+					 newMission.payment);
 		}
-		m_dirty = true;
 	}
 }
 
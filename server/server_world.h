@@ -9,10 +9,15 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdint>
 
+#include "server_index.h"
+
 namespace Server {
 
+class WorldStore;
+
 // ============================================================================
 // Server-side Computer State
 // ============================================================================
@@ -93,12 +98,35 @@ struct ServerAgent {
 	// Current state
 	int64_t connectedToIp; // 0 = not connected
 	std::vector<int64_t> bouncePath;
+	std::vector<int64_t> knownLinks; // IPs this agent has bounced through or connected to
 
 	// AI state (for NPCs)
 	int32_t currentMissionId;
 	float aiThinkTimer;
 };
 
+// ============================================================================
+// World Change Set
+// ============================================================================
+
+// Copies of every entity modified since the last CollectChanges(), handed to
+// the persister. Entries carry full state, so applying one is idempotent.
+
+struct WorldChangeSet {
+	std::vector<ServerComputer> computers;
+	std::vector<ServerMission> missions;
+	std::vector<ServerBankAccount> accounts;
+
+	bool Empty() const { return computers.empty() && missions.empty() && accounts.empty(); }
+
+	void Clear()
+	{
+		computers.clear();
+		missions.clear();
+		accounts.clear();
+	}
+};
+
 // ============================================================================
 // ServerWorld - The authoritative game state
 // ============================================================================
@@ -108,13 +136,21 @@ public:
 	ServerWorld();
 	~ServerWorld();
 
-	// Initialization
-	void LoadFromSupabase();
-	void SaveDirtyState();
+	// Initialization - replace the world with everything in store
+	bool Load(WorldStore& store);
+
+	// Persistence - per-entity dirty tracking
+	bool HasChanges() const;
+	// Copy dirty entities into out (replacing its contents) and clear the dirty sets.
+	// Returns false if nothing changed.
+	bool CollectChanges(WorldChangeSet& out);
+	// Overwrite entities with previously collected state (journal recovery)
+	void ApplyChanges(const WorldChangeSet& changes);
 
 	// Computer management
 	ServerComputer* FindComputerByIP(int64_t ip);
-	ServerComputer* FindComputerByIPString(const char* ipString);
+	const ServerComputer* FindComputerByIP(int64_t ip) const;
+	ServerComputer* FindComputerByIPString(const char* ipString); // "a.b.c.d", see Net::ParseIP
 	bool PlayerConnect(uint32_t playerId, int64_t targetIp);
 	void PlayerDisconnect(uint32_t playerId, int64_t fromIp);
 
@@ -139,6 +175,19 @@ public:
 	// Access logging
 	void LogAccess(int32_t computerId, int64_t accessorIp, const std::string& action);
 
+	// Player agents (one per authenticated connection)
+	ServerAgent* CreatePlayerAgent(
+		uint32_t playerId, const std::string& handle, int16_t rating, int32_t credits);
+	void RemovePlayerAgent(uint32_t playerId);
+	ServerAgent* FindPlayerAgent(uint32_t playerId);
+	const ServerAgent* FindPlayerAgent(uint32_t playerId) const;
+	bool AddBounce(uint32_t playerId, int64_t ip);
+	void ClearBounces(uint32_t playerId);
+
+	// Interest management - computers a player can currently see
+	// (known links, bounce path and the computer they are connected to)
+	void GetVisibleComputers(uint32_t playerId, std::unordered_set<int32_t>& outComputerIds) const;
+
 	// Getters
 	const std::vector<ServerComputer>& GetComputers() const { return m_computers; }
 	const std::vector<ServerMission>& GetMissions() const { return m_missions; }
@@ -163,10 +212,33 @@ private:
 	std::vector<ServerAccessLog> m_accessLogs;
 	std::vector<ServerAgent> m_agents; // NPCs and player agents
 
-	// Fast lookup maps
-	std::unordered_map<int64_t, size_t> m_computerByIp; // ip -> index
+	void AddKnownLink(ServerAgent& agent, int64_t ip);
+	void RebuildAgentIndex();
+
+	// Every insert goes through these so the indexes stay in step with the vectors
+	ServerMission& AddMission(const ServerMission& mission);
+	ServerBankAccount& AddAccount(const ServerBankAccount& account);
+	bool IndexComputer(size_t position); // false if the key is already taken
+	bool IndexMission(size_t position);
+	bool IndexAccount(size_t position);
+	void RebuildIndexes();
+	static uint64_t AccountHash(int64_t bankIp, const std::string& accountNumber);
+
+	void MarkDirty(const ServerComputer& computer);
+	void MarkDirty(const ServerMission& mission);
+	void MarkDirty(const ServerBankAccount& account);
+
+	// Dirty entities as indices into the vectors above (entities are only ever appended)
+	std::unordered_set<size_t> m_dirtyComputers;
+	std::unordered_set<size_t> m_dirtyMissions;
+	std::unordered_set<size_t> m_dirtyAccounts;
+
+	// Fast lookup maps (positions in the vectors above)
+	EntityIndex m_computerByIp;
+	EntityIndex m_missionById;
+	EntityIndex m_accountByKey; // bankIp + accountNumber
+	std::unordered_map<uint32_t, size_t> m_agentByPlayer; // playerId -> index into m_agents
 
-	bool m_dirty; // needs saving
 	int32_t m_nextAgentId;
 	int32_t m_nextMissionId;
 
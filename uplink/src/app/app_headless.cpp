@@ -0,0 +1,218 @@
+// -*- tab-width:4 c-file-style:"cc-mode" -*-
+
+/*
+	App object for uplink-core
+
+	Replaces app/app.cpp in the uplink-core library. Keeps the paths and
+	Options the world module reads, but has no main menu, client network,
+	phone dialler or saved profiles. Those members stay NULL and their
+	accessors are left undefined, so any world code that reaches for them
+	fails to link rather than failing at runtime.
+
+  */
+
+#include "stdafx.h"
+
+#include "redshirt.h"
+
+#include "app/app.h"
+#include "app/app_headless.h"
+#include "app/globals.h"
+#include "app/miscutils.h"
+
+#include "options/options.h"
+
+#include "game/game.h"
+
+// Everything the world generators read - the other archives are graphics, sound and fonts
+static const char* const CORE_ARCHIVES[] = { "data.dat", "patch.dat", "patch2.dat", "patch3.dat" };
+
+bool CoreInitialise(const char* apppath)
+{
+
+	UplinkAssert(!app);
+	UplinkAssert(!game);
+
+	app = new App();
+	char currenttime[SIZE_APP_DATE];
+	UplinkSnprintf(currenttime, sizeof(currenttime), "%s at %s", __DATE__, __TIME__);
+	app->Set(apppath, VERSION_NUMBER, VERSION_NAME, currenttime, "Uplink");
+
+	RsInitialise(app->path);
+
+	for (const char* archive : CORE_ARCHIVES) {
+		if (!RsLoadArchive(archive)) {
+			printf("CoreInitialise : Failed loading '%s%s'\n", app->path, archive);
+			CoreShutdown();
+			return false;
+		}
+	}
+
+	app->Initialise();
+
+	// Initialise the random number generator
+	srand((unsigned int)time(NULL));
+
+	game = new Game();
+	return true;
+}
+
+void CoreShutdown()
+{
+
+	if (app) {
+		delete app; // Deletes game
+		app = NULL;
+	}
+}
+
+App::App()
+{
+
+	UplinkStrncpy(path, "./", sizeof(path));
+	UplinkStrncpy(userpath, path, sizeof(userpath));
+	UplinkStrncpy(usertmppath, path, sizeof(usertmppath));
+	UplinkStrncpy(userretirepath, path, sizeof(userretirepath));
+	UplinkStrncpy(version, "1.31c", sizeof(version));
+	UplinkStrncpy(type, "RELEASE", sizeof(type));
+	UplinkStrncpy(date, "01/01/97", sizeof(date));
+	UplinkStrncpy(title, "NewApp", sizeof(title));
+	UplinkStrncpy(release, "Version 1.0 (RELEASE), Compiled on 01/01/97", sizeof(release));
+
+	starttime = 0;
+
+	options = NULL;
+	network = NULL;
+	mainmenu = NULL;
+	phoneDial = NULL;
+
+	nextLoadGame = NULL;
+
+	closed = false;
+	askCodeCard = false;
+}
+
+App ::~App()
+{
+
+	if (!Closed()) {
+		Close();
+	}
+}
+
+void App::Initialise()
+{
+
+	// Defaults only - the options file in userpath belongs to a client install
+
+	options = new Options();
+	options->CreateDefaultOptions();
+
+	starttime = (int)GetAccurateTime();
+}
+
+void App::Set(const char* newpath,
+			  const char* newversion,
+			  const char* newtype,
+			  const char* newdate,
+			  const char* newtitle)
+{
+
+	UplinkAssert(strlen(newpath) < SIZE_APP_PATH);
+	UplinkAssert(strlen(newversion) < SIZE_APP_VERSION);
+	UplinkAssert(strlen(newtype) < SIZE_APP_TYPE);
+	UplinkAssert(strlen(newdate) < SIZE_APP_DATE);
+	UplinkAssert(strlen(newtitle) < SIZE_APP_TITLE);
+
+	UplinkStrncpy(path, newpath, sizeof(path));
+	UplinkStrncpy(version, newversion, sizeof(version));
+	UplinkStrncpy(type, newtype, sizeof(type));
+	UplinkStrncpy(date, newdate, sizeof(date));
+	UplinkStrncpy(title, newtitle, sizeof(title));
+	UplinkSnprintf(release, sizeof(release), "Version %s (%s)\nCompiled on %s\n", version, type, date);
+
+	// Nothing is saved to the user paths, but keep them pointing somewhere sensible
+
+	UplinkSnprintf(userpath, sizeof(userpath), "%susers/", path);
+	UplinkSnprintf(usertmppath, sizeof(usertmppath), "%suserstmp/", path);
+	UplinkSnprintf(userretirepath, sizeof(userretirepath), "%susersold/", path);
+}
+
+void App::Close()
+{
+
+	UplinkAssert(!closed);
+
+	closed = true;
+
+	if (game) {
+		delete game;
+		game = NULL;
+	}
+
+	if (options) {
+		delete options;
+		options = NULL;
+	}
+
+	RsCleanUp();
+}
+
+bool App::Closed() { return closed; }
+
+Options* App::GetOptions()
+{
+
+	UplinkAssert(options);
+	return options;
+}
+
+DArray<char*>* App::ListExistingGames()
+{
+
+	// No saved profiles in uplink-core
+
+	return new DArray<char*>();
+}
+
+bool App::Load(FILE* file) { return true; }
+
+void App::Save(FILE* file) { }
+
+void App::CoreDump()
+{
+
+	printf("============== B E G I N  C O R E  D U M P =================\n");
+	PrintStackTrace();
+	printf("============== E N D  C O R E  D U M P =====================\n");
+}
+
+void App::Print()
+{
+
+	printf("============== A P P =======================================\n");
+
+	if (game) {
+		game->Print();
+	} else {
+		printf("game == NULL\n");
+	}
+	if (options) {
+		options->Print();
+	} else {
+		printf("options == NULL\n");
+	}
+
+	printf("============== E N D  O F  A P P ===========================\n");
+}
+
+void App::Update()
+{
+
+	// Nothing to run - the host process calls game->Update () itself and
+	// decides what a game over means for it
+}
+
+std::string App::GetID() { return "APP"; }
+
+App* app = NULL;
@@ -0,0 +1,21 @@
+/*
+	uplink-core start up and shut down
+
+	For processes that run the world simulation without the client - only
+	built into the uplink-core library (UPLINK_HEADLESS), where
+	app/app_headless.cpp stands in for app/app.cpp
+
+  */
+
+#ifndef _included_app_headless_h
+#define _included_app_headless_h
+
+// Creates app and game and loads the data archives from apppath (which ends in a slash).
+// Returns false, leaving nothing created, if an archive is missing.
+// Follow with game->NewGame () or game->LoadGame (), then game->Update () once per tick.
+bool CoreInitialise(const char* apppath);
+
+// Deletes game and app
+void CoreShutdown();
+
+#endif
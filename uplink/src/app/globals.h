@@ -13,7 +13,12 @@
 // My very own, special assertion function
 //
 
-#include "gucci.h"
+#ifndef UPLINK_HEADLESS
+	#include "gucci.h"
+	#define UplinkRestoreScreen() GciRestoreScreenSize()
+#else
+	#define UplinkRestoreScreen() // No screen mode to restore in uplink-core
+#endif
 
 #include <cstddef>
 
@@ -36,7 +41,7 @@
 					   #x,                                                                                   \
 					   __FILE__,                                                                             \
 					   __LINE__);                                                                            \
-				GciRestoreScreenSize();                                                                      \
+				UplinkRestoreScreen();                                                                       \
 				abort();                                                                                     \
 			}                                                                                                \
 		}
@@ -86,7 +91,7 @@
 				   msg,                                                                                      \
 				   __FILE__,                                                                                 \
 				   __LINE__);                                                                                \
-			GciRestoreScreenSize();                                                                          \
+			UplinkRestoreScreen();                                                                           \
 			/*throw;*/                                                                                       \
 			abort();                                                                                         \
 		}
@@ -102,7 +107,7 @@
 				   " Location  : %s, line %d\n",                                                             \
 				   __FILE__,                                                                                 \
 				   __LINE__);                                                                                \
-			GciRestoreScreenSize();                                                                          \
+			UplinkRestoreScreen();                                                                           \
 			/*throw;*/                                                                                       \
 			abort();                                                                                         \
 		}
@@ -200,7 +205,7 @@
 						   bufsize,                                                                          \
 						   format,                                                                           \
 						   buf);                                                                             \
-					GciRestoreScreenSize();                                                                  \
+					UplinkRestoreScreen();                                                                   \
 					abort();                                                                                 \
 				}                                                                                            \
 			}                                                                                                \
@@ -260,7 +265,7 @@
 						   count,                                                                            \
 						   _1377819_retCount,                                                                \
 						   strSource);                                                                       \
-					GciRestoreScreenSize();                                                                  \
+					UplinkRestoreScreen();                                                                   \
 					abort();                                                                                 \
 				}                                                                                            \
 				strncpy(strDest, strSource, count);                                                          \
@@ -330,7 +335,7 @@
 						   _1377819_strSourceSize,                                                           \
 						   strDest,                                                                          \
 						   strSource);                                                                       \
-					GciRestoreScreenSize();                                                                  \
+					UplinkRestoreScreen();                                                                   \
 					abort();                                                                                 \
 				}                                                                                            \
 				size_t _1377819_copyLen =                                                                    \
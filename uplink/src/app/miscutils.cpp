@@ -2,15 +2,21 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <string>
 
-#include "gl.h"
+#ifndef UPLINK_HEADLESS
+	#include "gl.h"
+#endif
 
 #include "stdafx.h"
 
 #include "redshirt.h"
 
-#include "gucci.h"
+#ifndef UPLINK_HEADLESS
+	#include "eclipse.h"
+	#include "gucci.h"
+#endif
 
 #include <cppfs/FileHandle.h>
 #include <cppfs/FileIterator.h>
@@ -286,6 +292,8 @@ std::vector<std::string> ListSubdirs(std::string directory)
 	return result;
 }
 
+#ifndef UPLINK_HEADLESS
+
 void SetColour(const char* colourName)
 {
 
@@ -304,6 +312,18 @@ void SetColour(const char* colourName)
 // calls glColour3f
 void SetColour(std::string colourName) { SetColour(colourName.c_str()); }
 
+#endif
+
+double GetAccurateTime()
+{
+#ifndef UPLINK_HEADLESS
+	return EclGetAccurateTime();
+#else
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+#endif
+}
+
 void PrintStackTrace() { cpptrace::generate_trace().print(); }
 
 std::vector<std::string> ConsumeToStringVector(DArray<char*>* sourceArray)
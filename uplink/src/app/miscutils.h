@@ -35,8 +35,12 @@ DArray<char*>* ListDirectory(const char* directory, const char* filter);
 std::vector<std::string> ListDirectoryVector(std::string directory, std::string filter);
 std::vector<std::string> ListSubdirs(std::string directory);
 
+#ifndef UPLINK_HEADLESS
 void SetColour(const char* colourName); // calls glColour3f
 void SetColour(std::string colourName);
+#endif
+
+double GetAccurateTime(); // Milliseconds since first called - EclGetAccurateTime in the game
 
 void PrintStackTrace();
 
@@ -1,8 +1,6 @@
 
 #include "stdafx.h"
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -56,60 +54,27 @@
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
-void SaveBTree(BTree<UplinkObject*>* btree, FILE* file)
+// One entry of a tree of UplinkObjects - the id, then the object
+static void SaveTreeEntry(const char* id, UplinkObject* uo, FILE* file)
 {
 
-	UplinkAssert(btree);
+	UplinkAssert(uo);
 
-	DArray<UplinkObject*>* uo = btree->ConvertToDArray();
-	DArray<char*>* uo_id = btree->ConvertIndexToDArray();
+	SaveDynamicString(id, file);
 
-	int size = uo->Size();
-
-	int nbitem = 0;
-	for (int i = 0; i < size; ++i) {
-		if (uo->ValidIndex(i)) {
-			nbitem++;
-		}
-	}
+	int OBJECTID = uo->GetOBJECTID();
+	UplinkAssert(OBJECTID != 0);
+	fwrite(&OBJECTID, sizeof(int), 1, file);
 
-	if (nbitem > MAX_ITEMS_DATA_STRUCTURE) {
-		UplinkPrintAbortArgs("WARNING: SaveBTree, number of items appears to be too big, size=%d, maxsize=%d",
-							 nbitem,
-							 MAX_ITEMS_DATA_STRUCTURE);
-		nbitem = MAX_ITEMS_DATA_STRUCTURE;
-	}
-
-	fwrite(&nbitem, sizeof(nbitem), 1, file);
-
-	nbitem = 0;
-	for (int i = 0; i < size && nbitem < MAX_ITEMS_DATA_STRUCTURE; ++i) {
-		if (uo->ValidIndex(i)) {
-
-			UplinkAssert(uo_id->ValidIndex(i));
-			UplinkAssert(uo->GetData(i));
-
-			SaveDynamicString(uo_id->GetData(i), file);
-
-			int OBJECTID = uo->GetData(i)->GetOBJECTID();
-			UplinkAssert(OBJECTID != 0);
-			fwrite(&OBJECTID, sizeof(int), 1, file);
-
-			uo->GetData(i)->Save(file);
-
-			nbitem++;
-		}
-	}
-
-	delete uo;
-	delete uo_id;
+	uo->Save(file);
 }
 
-bool LoadBTree(BTree<UplinkObject*>* btree, FILE* file)
+// Reads what SaveBTree wrote, into either kind of tree
+template <class Tree> static bool LoadTreeEntries(Tree* tree, FILE* file)
 {
 
-	if (!btree) {
-		UplinkPrintAssert(btree);
+	if (!tree) {
+		UplinkPrintAssert(tree);
 		return false;
 	}
 
@@ -148,7 +113,7 @@ bool LoadBTree(BTree<UplinkObject*>* btree, FILE* file)
 			return false;
 		}
 
-		btree->PutData(id, uo);
+		tree->PutData(id, uo);
 
 		delete[] id;
 	}
@@ -156,32 +121,49 @@ bool LoadBTree(BTree<UplinkObject*>* btree, FILE* file)
 	return true;
 }
 
-void PrintBTree(BTree<UplinkObject*>* btree)
+void SaveBTree(BTree<UplinkObject*>* btree, FILE* file)
 {
 
 	UplinkAssert(btree);
 
-	DArray<UplinkObject*>* uo = btree->ConvertToDArray();
-	DArray<char*>* uo_id = btree->ConvertIndexToDArray();
+	int nbitem = btree->Size();
+
+	if (nbitem > MAX_ITEMS_DATA_STRUCTURE) {
+		UplinkPrintAbortArgs("WARNING: SaveBTree, number of items appears to be too big, size=%d, maxsize=%d",
+							 nbitem,
+							 MAX_ITEMS_DATA_STRUCTURE);
+		nbitem = MAX_ITEMS_DATA_STRUCTURE;
+	}
 
-	for (int i = 0; i < uo->Size(); ++i) {
-		if (uo->ValidIndex(i)) {
+	fwrite(&nbitem, sizeof(nbitem), 1, file);
 
-			UplinkAssert(uo_id->ValidIndex(i));
-			printf("Index = %s\n", uo_id->GetData(i));
+	int saved = 0;
+	btree->ForEach([&](const char* id, UplinkObject* uo) {
+		if (saved < nbitem) {
+			SaveTreeEntry(id, uo, file);
+			saved++;
+		}
+	});
+}
 
-			if (uo->GetData(i)) {
-				uo->GetData(i)->Print();
-			}
+bool LoadBTree(BTree<UplinkObject*>* btree, FILE* file) { return LoadTreeEntries(btree, file); }
 
-			else {
-				printf("NULL\n");
-			}
+void PrintBTree(BTree<UplinkObject*>* btree)
+{
+
+	UplinkAssert(btree);
+
+	btree->ForEach([](const char* id, UplinkObject* uo) {
+		printf("Index = %s\n", id);
+
+		if (uo) {
+			uo->Print();
 		}
-	}
 
-	delete uo;
-	delete uo_id;
+		else {
+			printf("NULL\n");
+		}
+	});
 }
 
 void UpdateBTree(BTree<UplinkObject*>* btree)
@@ -189,17 +171,11 @@ void UpdateBTree(BTree<UplinkObject*>* btree)
 
 	UplinkAssert(btree);
 
-	DArray<UplinkObject*>* uo = btree->ConvertToDArray();
-
-	for (int i = 0; i < uo->Size(); ++i) {
-		if (uo->ValidIndex(i)) {
-			if (uo->GetData(i)) {
-				uo->GetData(i)->Update();
-			}
+	btree->ForEach([](const char* id, UplinkObject* uo) {
+		if (uo) {
+			uo->Update();
 		}
-	}
-
-	delete uo;
+	});
 }
 
 void DeleteBTreeData(BTree<UplinkObject*>* btree)
@@ -207,17 +183,11 @@ void DeleteBTreeData(BTree<UplinkObject*>* btree)
 
 	UplinkAssert(btree);
 
-	DArray<UplinkObject*>* uo = btree->ConvertToDArray();
-
-	for (int i = 0; i < uo->Size(); ++i) {
-		if (uo->ValidIndex(i)) {
-			if (uo->GetData(i)) {
-				delete uo->GetData(i);
-			}
+	btree->ForEach([](const char* id, UplinkObject* uo) {
+		if (uo) {
+			delete uo;
 		}
-	}
-
-	delete uo;
+	});
 }
 
 void SaveBTree(BTree<char*>* btree, FILE* file)
@@ -225,17 +195,7 @@ void SaveBTree(BTree<char*>* btree, FILE* file)
 
 	UplinkAssert(btree);
 
-	DArray<char*>* uo = btree->ConvertToDArray();
-	DArray<char*>* uo_id = btree->ConvertIndexToDArray();
-
-	int size = uo->Size();
-
-	int nbitem = 0;
-	for (int i = 0; i < size; ++i) {
-		if (uo->ValidIndex(i)) {
-			nbitem++;
-		}
-	}
+	int nbitem = btree->Size();
 
 	if (nbitem > MAX_ITEMS_DATA_STRUCTURE) {
 		UplinkPrintAbortArgs("WARNING: SaveBTree, number of items appears to be too big, size=%d, maxsize=%d",
@@ -246,21 +206,14 @@ void SaveBTree(BTree<char*>* btree, FILE* file)
 
 	fwrite(&nbitem, sizeof(nbitem), 1, file);
 
-	nbitem = 0;
-	for (int i = 0; i < size && nbitem < MAX_ITEMS_DATA_STRUCTURE; ++i) {
-		if (uo->ValidIndex(i)) {
-
-			UplinkAssert(uo_id->ValidIndex(i));
-
-			SaveDynamicString(uo_id->GetData(i), file);
-			SaveDynamicString(uo->GetData(i), file);
-
-			nbitem++;
+	int saved = 0;
+	btree->ForEach([&](const char* id, char* data) {
+		if (saved < nbitem) {
+			SaveDynamicString(id, file);
+			SaveDynamicString(data, file);
+			saved++;
 		}
-	}
-
-	delete uo;
-	delete uo_id;
+	});
 }
 
 bool LoadBTree(BTree<char*>* btree, FILE* file)
@@ -310,47 +263,100 @@ void PrintBTree(BTree<char*>* btree)
 
 	UplinkAssert(btree);
 
-	DArray<char*>* uo = btree->ConvertToDArray();
-	DArray<char*>* uo_id = btree->ConvertIndexToDArray();
+	btree->ForEach([](const char* id, char* data) {
+		printf("Index = %s\n", id);
 
-	for (int i = 0; i < uo->Size(); ++i) {
-		if (uo->ValidIndex(i)) {
+		if (data) {
+			printf("%s\n", data);
+		}
 
-			UplinkAssert(uo_id->ValidIndex(i));
-			printf("Index = %s\n", uo_id->GetData(i));
+		else {
+			printf("NULL\n");
+		}
+	});
+}
 
-			if (uo->GetData(i)) {
-				printf("%s\n", uo->GetData(i));
-			}
+void DeleteBTreeData(BTree<char*>* btree)
+{
 
-			else {
-				printf("NULL\n");
-			}
+	UplinkAssert(btree);
+
+	btree->ForEach([](const char* id, char* data) {
+		// Even zero length string need to be deleted
+		if (data) {
+			delete[] data;
 		}
+	});
+}
+
+void SaveBTree(SortedTree<UplinkObject*>* tree, FILE* file)
+{
+
+	UplinkAssert(tree);
+
+	int nbitem = tree->Size();
+
+	if (nbitem > MAX_ITEMS_DATA_STRUCTURE) {
+		UplinkPrintAbortArgs("WARNING: SaveBTree, number of items appears to be too big, size=%d, maxsize=%d",
+							 nbitem,
+							 MAX_ITEMS_DATA_STRUCTURE);
+		nbitem = MAX_ITEMS_DATA_STRUCTURE;
 	}
 
-	delete uo;
-	delete uo_id;
+	fwrite(&nbitem, sizeof(nbitem), 1, file);
+
+	int saved = 0;
+	for (SortedTree<UplinkObject*>::iterator it = tree->begin(); it != tree->end() && saved < nbitem; ++it) {
+		SaveTreeEntry(it.Id(), *it, file);
+		saved++;
+	}
 }
 
-void DeleteBTreeData(BTree<char*>* btree)
+bool LoadBTree(SortedTree<UplinkObject*>* tree, FILE* file) { return LoadTreeEntries(tree, file); }
+
+void PrintBTree(SortedTree<UplinkObject*>* tree)
 {
 
-	UplinkAssert(btree);
+	UplinkAssert(tree);
 
-	DArray<char*>* uo = btree->ConvertToDArray();
+	for (SortedTree<UplinkObject*>::iterator it = tree->begin(); it != tree->end(); ++it) {
+		printf("Index = %s\n", it.Id());
 
-	for (int i = 0; i < uo->Size(); ++i) {
-		if (uo->ValidIndex(i)) {
-			if (uo->GetData(i)) {
-				// Even zero length string need to be deleted
-				// if ( strcmp ( uo->GetData (i), "" ) != 0 )
-				delete[] uo->GetData(i);
-			}
+		if (*it) {
+			(*it)->Print();
+		}
+
+		else {
+			printf("NULL\n");
 		}
 	}
+}
+
+void UpdateBTree(SortedTree<UplinkObject*>* tree)
+{
+
+	UplinkAssert(tree);
 
-	delete uo;
+	// Updates can create world objects, which join the walk if they sort after
+	// the current one - the walk itself never visits an entry twice
+
+	tree->ForEach([](const char* id, UplinkObject* uo) {
+		if (uo) {
+			uo->Update();
+		}
+	});
+}
+
+void DeleteBTreeData(SortedTree<UplinkObject*>* tree)
+{
+
+	UplinkAssert(tree);
+
+	tree->ForEach([](const char* id, UplinkObject* uo) {
+		if (uo) {
+			delete uo;
+		}
+	});
 }
 
 void SaveLList(LList<UplinkObject*>* llist, FILE* file)
@@ -43,6 +43,12 @@ bool LoadBTree(BTree<char*>* btree, FILE* file);
 void PrintBTree(BTree<char*>* btree);
 void DeleteBTreeData(BTree<char*>* btree);
 
+void SaveBTree(SortedTree<UplinkObject*>* tree, FILE* file);
+bool LoadBTree(SortedTree<UplinkObject*>* tree, FILE* file);
+void PrintBTree(SortedTree<UplinkObject*>* tree);
+void UpdateBTree(SortedTree<UplinkObject*>* tree);
+void DeleteBTreeData(SortedTree<UplinkObject*>* tree);
+
 void SaveLList(LList<UplinkObject*>* llist, FILE* file);
 bool LoadLList(LList<UplinkObject*>* llist, FILE* file);
 void PrintLList(LList<UplinkObject*>* llist);
@@ -19,7 +19,7 @@ struct path_point {
 	}
 };
 
-void BestPathGenerator::CreatePath(Game* game, BTree<VLocation*> location)
+void BestPathGenerator::CreatePath(Game* game, const SortedTree<VLocation*>& location)
 {
 	auto arr = location.ConvertToDArray();
 	int firstIndex = -1;
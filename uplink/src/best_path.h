@@ -5,5 +5,5 @@
 
 class BestPathGenerator {
 public:
-	static void CreatePath(Game* game, BTree<VLocation*>);
+	static void CreatePath(Game* game, const SortedTree<VLocation*>& location);
 };
\ No newline at end of file
@@ -1,8 +1,6 @@
 
 #include "stdafx.h"
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "game/data/data.h"
@@ -1,15 +1,10 @@
 
 #include "stdafx.h"
 
-#include "eclipse.h"
-#include "gucci.h"
 #include "redshirt.h"
-#include "soundgarden.h"
 
 #include "app/app.h"
 #include "app/globals.h"
-#include "app/opengl.h"
-#include "app/opengl_interface.h"
 #include "app/serialise.h"
 
 #include "options/options.h"
@@ -18,11 +13,20 @@
 #include "game/game.h"
 #include "game/gameobituary.h"
 
-#include "mainmenu/mainmenu.h"
+#ifndef UPLINK_HEADLESS
+	#include "eclipse.h"
+	#include "gucci.h"
+	#include "soundgarden.h"
 
-#include "view/view.h"
+	#include "app/opengl.h"
+	#include "app/opengl_interface.h"
 
-#include "interface/interface.h"
+	#include "mainmenu/mainmenu.h"
+
+	#include "view/view.h"
+
+	#include "interface/interface.h"
+#endif
 
 #include "world/generator/numbergenerator.h"
 #include "world/generator/plotgenerator.h"
@@ -57,12 +61,14 @@ Game::Game()
 Game::~Game()
 {
 
+#ifndef UPLINK_HEADLESS
 	if (ui) {
 		delete ui;
 	}
 	if (view) {
 		delete view;
 	}
+#endif
 	if (world) {
 		delete world;
 	}
@@ -90,12 +96,14 @@ Game::~Game()
 void Game::NewGame()
 {
 
+#ifndef UPLINK_HEADLESS
 	if (ui) {
 		delete ui;
 	}
 	if (view) {
 		delete view;
 	}
+#endif
 	if (world) {
 		delete world;
 	}
@@ -133,6 +141,7 @@ void Game::NewGame()
 	world->plotgenerator.Initialise();
 	world->demoplotgenerator.Initialise();
 
+#ifndef UPLINK_HEADLESS
 	SgPlaySound(RsArchiveFileOpen("sounds/ringout.wav"), "sounds/ringout.wav", false);
 
 	// Initialise the view
@@ -142,6 +151,7 @@ void Game::NewGame()
 	// Initialise the interface
 	ui = new Interface();
 	GetInterface()->Create();
+#endif
 
 	// Start the game running
 	gamespeed = GAMESPEED_NORMAL;
@@ -169,7 +179,12 @@ void Game::NewGame()
 	} while (GetWorld()->date.Before(&gamestart));
 }
 
-void Game::ExitGame() { opengl_close(); }
+void Game::ExitGame()
+{
+#ifndef UPLINK_HEADLESS
+	opengl_close();
+#endif
+}
 
 void Game::SetGameSpeed(int newspeed) { gamespeed = newspeed; }
 
@@ -270,6 +285,7 @@ bool Game::LoadGame(FILE* file)
 
 		// UplinkAbort ( "This save game file is from an older version of Uplink" );
 
+#ifndef UPLINK_HEADLESS
 		EclReset(app->GetOptions()->GetOptionValue("graphics_screenwidth"),
 				 app->GetOptions()->GetOptionValue("graphics_screenheight"));
 		app->GetMainMenu()->RunScreen(MAINMENU_LOGIN);
@@ -285,12 +301,14 @@ bool Game::LoadGame(FILE* file)
 					   SAVEFILE_VERSION_MIN,
 					   SAVEFILE_VERSION);
 		create_msgbox("Error", message);
+#endif
 
 		return false;
 	}
 
 	if (!Load(file)) {
 
+#ifndef UPLINK_HEADLESS
 		EclReset(app->GetOptions()->GetOptionValue("graphics_screenwidth"),
 				 app->GetOptions()->GetOptionValue("graphics_screenheight"));
 		app->GetMainMenu()->RunScreen(MAINMENU_LOGIN);
@@ -300,6 +318,7 @@ bool Game::LoadGame(FILE* file)
 					  "The save file is either\n"
 					  "not compatible or\n"
 					  "corrupted");
+#endif
 
 		return false;
 	}
@@ -314,12 +333,14 @@ bool Game::Load(FILE* file)
 
 	// Reset currently running game
 
+#ifndef UPLINK_HEADLESS
 	if (ui) {
 		delete ui;
 	}
 	if (view) {
 		delete view;
 	}
+#endif
 	if (world) {
 		delete world;
 	}
@@ -327,8 +348,10 @@ bool Game::Load(FILE* file)
 		delete gob;
 	}
 
+#ifndef UPLINK_HEADLESS
 	ui = new Interface();
 	view = new View();
+#endif
 	world = new World();
 	gob = NULL;
 	WorldGenerator::LoadDynamicsGatewayDefs();
@@ -359,12 +382,14 @@ bool Game::Load(FILE* file)
 		if (!GetWorld()->Load(file)) {
 			return false;
 		}
+#ifndef UPLINK_HEADLESS
 		if (!GetInterface()->Load(file)) {
 			return false;
 		}
 		if (!GetView()->Load(file)) {
 			return false;
 		}
+#endif
 
 	} else {
 
@@ -407,8 +432,10 @@ void Game::Save(FILE* file)
 
 		SaveID(file);
 
+#ifndef UPLINK_HEADLESS
 		UplinkAssert(ui);
 		UplinkAssert(view);
+#endif
 		UplinkAssert(world);
 
 		fwrite(SAVEFILE_VERSION, sizeof(SAVEFILE_VERSION), 1, file);
@@ -419,9 +446,12 @@ void Game::Save(FILE* file)
 
 		if (!(gamespeed == GAMESPEED_GAMEOVER)) {
 
+			// Without the interface and view an uplink-core save only loads back into uplink-core
 			GetWorld()->Save(file);
+#ifndef UPLINK_HEADLESS
 			GetInterface()->Save(file);
 			GetView()->Save(file);
+#endif
 
 		} else {
 
@@ -447,6 +477,7 @@ void Game::Print()
 
 	printf("Game speed = %d\n", gamespeed);
 
+#ifndef UPLINK_HEADLESS
 	if (ui) {
 		ui->Print();
 	} else {
@@ -457,6 +488,7 @@ void Game::Print()
 	} else {
 		printf("View is NULL\n");
 	}
+#endif
 	if (world) {
 		world->Print();
 	} else {
@@ -478,10 +510,13 @@ void Game::Update()
 	if (gamespeed > GAMESPEED_PAUSED) {
 
 		GetWorld()->Update();
+#ifndef UPLINK_HEADLESS
 		GetView()->Update();
 		GetInterface()->Update();
+#endif
 	}
 
+#ifndef UPLINK_HEADLESS
 	//
 	// Autosave every minute
 	//
@@ -491,6 +526,7 @@ void Game::Update()
 		app->SaveGame(GetWorld()->GetPlayer()->handle);
 		lastsave = time(NULL);
 	}
+#endif
 }
 
 const char* Game::GetLoadedSavefileVer() const
@@ -71,7 +71,7 @@ void OnlineHUDInterface::PlayerListDraw(Button* button, bool highlighted, bool c
 	// Draw player list
 	NetworkClient* client = app->GetNetwork()->GetClient();
 	if (client && client->IsConnected()) {
-		const std::vector<Net::PlayerListEntry>& players = client->GetOnlinePlayers();
+		const std::vector<OnlinePlayer>& players = client->GetOnlinePlayers();
 
 		SetColour("DefaultText");
 		int y = button->y + 5;
@@ -80,7 +80,7 @@ void OnlineHUDInterface::PlayerListDraw(Button* button, bool highlighted, bool c
 		for (size_t i = playerScrollOffset; i < players.size() && (int)(i - playerScrollOffset) < maxVisible;
 			 ++i) {
 			char line[64];
-			UplinkSnprintf(line, sizeof(line), "%s [%d]", players[i].handle, players[i].rating);
+			UplinkSnprintf(line, sizeof(line), "%s [%d]", players[i].handle.c_str(), players[i].rating);
 			GciDrawText(button->x + 5, y + 12, line, HELVETICA_10);
 			y += 15;
 		}
@@ -227,7 +227,7 @@ void OnlineHUDInterface::PlayerScrollDownClick(Button* button)
 #if ENABLE_NETWORK
 	NetworkClient* client = app->GetNetwork()->GetClient();
 	if (client) {
-		const std::vector<Net::PlayerListEntry>& players = client->GetOnlinePlayers();
+		const std::vector<OnlinePlayer>& players = client->GetOnlinePlayers();
 		if (playerScrollOffset < (int)players.size() - 3) {
 			playerScrollOffset++;
 			EclDirtyButton("online_playerlist");
@@ -113,41 +113,35 @@ void RankingScreenInterface::Create(ComputerScreen* newcs)
 		// Build a list of agents sorted on rating order
 		//
 
-		DArray<Person*>* allpeople = game->GetWorld()->people.ConvertToDArray();
 		LList<Person*> sorted;
 
-		for (int ip = 0; ip < allpeople->Size(); ++ip) {
-			if (allpeople->ValidIndex(ip)) {
+		for (Person* p : game->GetWorld()->people) {
 
-				Person* p = allpeople->GetData(ip);
-				UplinkAssert(p);
+			UplinkAssert(p);
 
-				if (p->GetOBJECTID() == OID_AGENT || p->GetOBJECTID() == OID_PLAYER) {
+			if (p->GetOBJECTID() == OID_AGENT || p->GetOBJECTID() == OID_PLAYER) {
 
-					bool inserted = false;
+				bool inserted = false;
 
-					for (int is = 0; is < sorted.Size(); ++is) {
+				for (int is = 0; is < sorted.Size(); ++is) {
 
-						Person* s = sorted.GetData(is);
-						UplinkAssert(s);
+					Person* s = sorted.GetData(is);
+					UplinkAssert(s);
 
-						if (p->rating.uplinkscore >= s->rating.uplinkscore) {
+					if (p->rating.uplinkscore >= s->rating.uplinkscore) {
 
-							sorted.PutDataAtIndex(p, is);
-							inserted = true;
-							break;
-						}
+						sorted.PutDataAtIndex(p, is);
+						inserted = true;
+						break;
 					}
+				}
 
-					if (!inserted) {
-						sorted.PutDataAtEnd(p);
-					}
+				if (!inserted) {
+					sorted.PutDataAtEnd(p);
 				}
 			}
 		}
 
-		delete allpeople;
-
 		//
 		// Find the players rank
 		//
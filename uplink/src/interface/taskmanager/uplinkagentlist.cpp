@@ -191,41 +191,35 @@ void UplinkAgentList::UpdateLists()
 	// Build a list of agents sorted in handle alphabetical order
 	//
 
-	DArray<Person*>* allpeople = game->GetWorld()->people.ConvertToDArray();
 	LList<Person*> sorted;
 
-	for (int ip = 0; ip < allpeople->Size(); ++ip) {
-		if (allpeople->ValidIndex(ip)) {
+	for (Person* p : game->GetWorld()->people) {
 
-			Person* p = allpeople->GetData(ip);
-			UplinkAssert(p);
+		UplinkAssert(p);
 
-			if (p->GetOBJECTID() == OID_AGENT || p->GetOBJECTID() == OID_PLAYER) {
+		if (p->GetOBJECTID() == OID_AGENT || p->GetOBJECTID() == OID_PLAYER) {
 
-				bool inserted = false;
+			bool inserted = false;
 
-				for (int is = 0; is < sorted.Size(); ++is) {
+			for (int is = 0; is < sorted.Size(); ++is) {
 
-					Person* s = sorted.GetData(is);
-					UplinkAssert(s);
+				Person* s = sorted.GetData(is);
+				UplinkAssert(s);
 
-					if (strcmp(((Agent*)p)->handle, ((Agent*)s)->handle) <= 0) {
+				if (strcmp(((Agent*)p)->handle, ((Agent*)s)->handle) <= 0) {
 
-						sorted.PutDataAtIndex(p, is);
-						inserted = true;
-						break;
-					}
+					sorted.PutDataAtIndex(p, is);
+					inserted = true;
+					break;
 				}
+			}
 
-				if (!inserted) {
-					sorted.PutDataAtEnd(p);
-				}
+			if (!inserted) {
+				sorted.PutDataAtEnd(p);
 			}
 		}
 	}
 
-	delete allpeople;
-
 	//
 	// How much data does the player have
 
@@ -0,0 +1,199 @@
+/*
+ * Cybrelink Client Clock Model implementation
+ */
+
+#include "clockmodel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Net {
+
+// ============================================================================
+// ServerClock
+// ============================================================================
+
+// A sample this far (game seconds) from the model means the server's clock
+// was set, not that it drifted - start the window again
+static const double RESYNC_SECONDS = 5.0;
+
+// Below this much local time between the oldest and newest samples the fitted
+// drift is mostly jitter, so the clocks are taken to run at the same rate
+static const double MIN_FIT_SPAN = 1.0;
+
+// Largest clock drift the fit may report (seconds per second). Real clocks stay
+// well inside this; anything more is jitter the window did not filter out
+static const double MAX_DRIFT = 0.001;
+
+ServerClock::ServerClock() { Reset(); }
+
+void ServerClock::Reset()
+{
+	m_count = 0;
+	m_next = 0;
+	m_speed = 1.0;
+	m_serverBase = 0;
+	m_origin = 0.0;
+	m_offset = 0.0;
+	m_rate = 1.0;
+	m_displaying = false;
+	m_display = 0.0;
+	m_displayLocal = 0.0;
+}
+
+void ServerClock::AddSample(double gameSeconds, double speed, uint32_t serverTimeMs, double localSeconds)
+{
+	// Speed changes and clock jumps invalidate the window. The displayed clock
+	// is kept and slews (or snaps) to the new estimate.
+	if (m_count > 0 &&
+		(speed != m_speed || std::fabs(gameSeconds - EstimateSeconds(localSeconds)) > RESYNC_SECONDS)) {
+		m_count = 0;
+		m_next = 0;
+	}
+
+	if (m_count == 0) {
+		m_speed = speed;
+		m_serverBase = serverTimeMs;
+	}
+
+	// Unsigned difference, so the 32 bit server clock may wrap while connected
+	double serverSeconds = static_cast<uint32_t>(serverTimeMs - m_serverBase) / 1000.0;
+
+	Sample& sample = m_samples[m_next];
+	sample.gameSeconds = gameSeconds;
+	sample.serverSeconds = serverSeconds;
+	sample.localSeconds = localSeconds;
+
+	m_next = (m_next + 1) % WINDOW;
+	m_count = std::min(m_count + 1, WINDOW);
+
+	Fit();
+}
+
+void ServerClock::Fit()
+{
+	// Measured from the newest arrival to keep the doubles well conditioned
+	m_origin = m_samples[(m_next + WINDOW - 1) % WINDOW].localSeconds;
+
+	double lMin = m_origin;
+	for (size_t i = 0; i < m_count; i++) {
+		lMin = std::min(lMin, m_samples[i].localSeconds);
+	}
+
+	// Drift: slope between the fastest sample of the older and of the newer half
+	// of the window. Queueing only ever adds transit time, so the fastest
+	// samples lie on the true transit line and the rest can be ignored.
+	double drift = 0.0;
+	if (m_count >= 4 && m_origin - lMin >= MIN_FIT_SPAN) {
+		double middle = (lMin + m_origin) / 2;
+		const Sample* fastest[2] = { nullptr, nullptr };
+		for (size_t i = 0; i < m_count; i++) {
+			const Sample& sample = m_samples[i];
+			int half = sample.localSeconds < middle ? 0 : 1;
+			if (!fastest[half] || sample.localSeconds - sample.serverSeconds <
+									  fastest[half]->localSeconds - fastest[half]->serverSeconds) {
+				fastest[half] = &sample;
+			}
+		}
+
+		if (fastest[0] && fastest[1]) {
+			double dl = fastest[1]->localSeconds - fastest[0]->localSeconds;
+			double dt = (fastest[1]->localSeconds - fastest[1]->serverSeconds) -
+						(fastest[0]->localSeconds - fastest[0]->serverSeconds);
+			if (dl >= MIN_FIT_SPAN / 2) {
+				drift = std::clamp(dt / dl, -MAX_DRIFT, MAX_DRIFT);
+			}
+		}
+	}
+
+	// Least transit at m_origin, i.e. the transit line through the fastest sample
+	double transit = 0.0;
+	double gameAtServerZero = 0.0;
+	for (size_t i = 0; i < m_count; i++) {
+		const Sample& sample = m_samples[i];
+		double t = sample.localSeconds - sample.serverSeconds - drift * (sample.localSeconds - m_origin);
+		transit = (i == 0) ? t : std::min(transit, t);
+		gameAtServerZero += sample.gameSeconds - m_speed * sample.serverSeconds;
+	}
+	gameAtServerZero /= m_count;
+
+	// Server time at local time l is l - (transit + drift * (l - m_origin))
+	m_offset = gameAtServerZero + m_speed * (m_origin - transit);
+	m_rate = m_speed * (1.0 - drift);
+}
+
+double ServerClock::EstimateSeconds(double localSeconds) const
+{
+	return m_offset + m_rate * (localSeconds - m_origin);
+}
+
+double ServerClock::DisplaySeconds(double localSeconds)
+{
+	if (m_count == 0 && !m_displaying) {
+		return 0.0;
+	}
+
+	double target = EstimateSeconds(localSeconds);
+	double elapsed = std::max(0.0, localSeconds - m_displayLocal);
+	double advanced = m_display + m_rate * elapsed;
+	double error = target - advanced;
+
+	if (!m_displaying || std::fabs(error) > SNAP_SECONDS) {
+		m_display = target;
+		m_displaying = true;
+	} else {
+		// Work the error off over SLEW_SECONDS, but never run backwards
+		double correction = error * std::min(1.0, elapsed / SLEW_SECONDS);
+		m_display = std::max(m_display, advanced + correction);
+	}
+
+	m_displayLocal = localSeconds;
+	return m_display;
+}
+
+// ============================================================================
+// TracePredictor
+// ============================================================================
+
+TracePredictor::TracePredictor() { Reset(); }
+
+void TracePredictor::Reset()
+{
+	m_active = false;
+	m_progress = 0.0f;
+	m_rate = 0.0f;
+	m_totalLinks = 0;
+	m_updateLocal = 0.0;
+	m_shown = 0.0f;
+}
+
+void TracePredictor::AddUpdate(
+	bool active, float progress, float linksPerSecond, uint8_t totalLinks, double localSeconds)
+{
+	// A new trace, or the last one ended - either way progress starts over
+	if (!active || !m_active || totalLinks != m_totalLinks) {
+		m_shown = 0.0f;
+	}
+
+	m_active = active;
+	m_progress = active ? progress : 0.0f;
+	m_rate = active ? linksPerSecond : 0.0f;
+	m_totalLinks = active ? totalLinks : 0;
+	m_updateLocal = localSeconds;
+}
+
+float TracePredictor::GetProgress(double localSeconds)
+{
+	if (!m_active) {
+		return 0.0f;
+	}
+
+	double elapsed = std::max(0.0, localSeconds - m_updateLocal);
+	float predicted = m_progress + static_cast<float>(m_rate * elapsed);
+	predicted = std::min(predicted, static_cast<float>(m_totalLinks));
+
+	m_shown = std::max(m_shown, predicted);
+	return m_shown;
+}
+
+} // namespace Net
@@ -0,0 +1,112 @@
+#pragma once
+
+/*
+ * Cybrelink Client Clock Model
+ * Predicts server-driven state between updates so it can be sent rarely
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Net {
+
+// ============================================================================
+// Server Clock
+// ============================================================================
+
+// Estimates the server's game clock from TIME_SYNC samples. Each sample carries
+// the server's send time as well as its game time, so the model has two parts:
+//   - game time from server time, which is exact (the server's game clock runs
+//     at its stated speed against its own steady clock)
+//   - server time from local time, through the transit time (arrival minus
+//     send) of the last WINDOW samples. Queueing only ever adds to it, so the
+//     fastest samples mark the true line; its slope is the drift between the
+//     two machines' clocks.
+//
+// DisplaySeconds() is the clock to show: it runs at the estimated rate and
+// slews towards the estimate instead of jumping, and never runs backwards.
+
+class ServerClock {
+public:
+	static constexpr size_t WINDOW = 16; // Samples in the fit (8 seconds at 2Hz)
+	static constexpr double SLEW_SECONDS = 1.0; // Real time to work off a display error
+	static constexpr double SNAP_SECONDS = 30.0; // Larger game time errors jump instead
+
+	ServerClock();
+
+	void Reset();
+
+	// One TIME_SYNC: server game time (fractional Date seconds), its game speed (game
+	// seconds per real second), the server's send clock in ms, and the local
+	// clock in seconds when it arrived
+	void AddSample(double gameSeconds, double speed, uint32_t serverTimeMs, double localSeconds);
+
+	bool HasEstimate() const { return m_count > 0; }
+
+	// Model game time at a local time
+	double EstimateSeconds(double localSeconds) const;
+
+	// Smoothed game time for display; call once per frame with the local time
+	double DisplaySeconds(double localSeconds);
+
+	double GetRate() const { return m_rate; } // Game seconds per local second
+
+private:
+	struct Sample {
+		double gameSeconds;
+		double serverSeconds; // Send time, from the window's first sample
+		double localSeconds; // Arrival time
+	};
+
+	void Fit();
+
+	Sample m_samples[WINDOW];
+	size_t m_count; // Valid samples, up to WINDOW
+	size_t m_next; // Ring position for the next sample
+	double m_speed; // Server game speed of the samples in the window
+	uint32_t m_serverBase; // Server send clock of the window's first sample
+
+	// Model: gameSeconds = m_offset + m_rate * (localSeconds - m_origin)
+	double m_origin;
+	double m_offset;
+	double m_rate;
+
+	bool m_displaying;
+	double m_display;
+	double m_displayLocal; // Local time m_display was last advanced to
+};
+
+// ============================================================================
+// Trace Predictor
+// ============================================================================
+
+// Extrapolates a trace between TRACE_UPDATEs from the progress and speed the
+// server last reported. Progress only moves forward during one trace: an
+// update behind the prediction holds it rather than winding it back.
+
+class TracePredictor {
+public:
+	TracePredictor();
+
+	void Reset();
+
+	// One TRACE_UPDATE, and the local clock in seconds when it arrived
+	void AddUpdate(
+		bool active, float progress, float linksPerSecond, uint8_t totalLinks, double localSeconds);
+
+	bool IsActive() const { return m_active; }
+	int GetTotalLinks() const { return m_totalLinks; }
+
+	// Links traced so far (fractional), 0 when no trace is running
+	float GetProgress(double localSeconds);
+
+private:
+	bool m_active;
+	float m_progress; // As of m_updateLocal
+	float m_rate; // Links per second
+	int m_totalLinks;
+	double m_updateLocal;
+	float m_shown; // Highest progress returned for this trace
+};
+
+} // namespace Net
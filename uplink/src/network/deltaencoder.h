@@ -44,6 +44,15 @@ inline size_t DecodeVarint(const uint8_t* buffer, size_t maxLen, uint32_t& outVa
     return 0; // Error: incomplete or too long
 }
 
+// ZigZag maps signed values onto unsigned so small negatives stay short varints
+inline uint32_t EncodeZigZag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t DecodeZigZag(uint32_t value) {
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
 // ============================================================================
 // String Encoding
 // ============================================================================
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ * Cybrelink IP Addresses
+ * Packed integer form of in-game IP strings, shared by server and database
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Net {
+
+// ============================================================================
+// Packed IP
+// ============================================================================
+
+// Game IPs are four dot-separated numbers of 0-999 each (WorldGenerator uses
+// RandomNumber(1000) per octet), so they don't fit IPv4's 8 bits per part.
+// They are packed base 1000 instead: "123.456.789.12" -> 123456789012, which
+// needs 40 bits, keeps the numeric order and reads back at a glance.
+
+constexpr int64_t IP_OCTET_RANGE = 1000;
+
+// Strict parse of "a.b.c.d": exactly four groups of 1-3 digits and nothing
+// after the last one. Returns false (out untouched) on anything else.
+inline bool ParseIP(const char* text, int64_t& out)
+{
+	if (!text) {
+		return false;
+	}
+
+	int64_t packed = 0;
+	for (int part = 0; part < 4; part++) {
+		if (part > 0 && *text++ != '.') {
+			return false;
+		}
+
+		int digits = 0;
+		int64_t value = 0;
+		while (*text >= '0' && *text <= '9') {
+			if (++digits > 3) {
+				return false;
+			}
+			value = value * 10 + (*text++ - '0');
+		}
+		if (digits == 0) {
+			return false;
+		}
+		packed = packed * IP_OCTET_RANGE + value;
+	}
+
+	if (*text != '\0') {
+		return false;
+	}
+	out = packed;
+	return true;
+}
+
+inline bool ParseIP(const std::string& text, int64_t& out) { return ParseIP(text.c_str(), out); }
+
+// Unterminated text, e.g. a string field decoded in place from a packet
+inline bool ParseIP(std::string_view text, int64_t& out)
+{
+	char terminated[16]; // "999.999.999.999"
+	if (text.size() >= sizeof(terminated)) {
+		return false;
+	}
+	memcpy(terminated, text.data(), text.size());
+	terminated[text.size()] = '\0';
+	return ParseIP(terminated, out);
+}
+
+// Inverse of ParseIP, without leading zeros
+inline std::string FormatIP(int64_t packed)
+{
+	int parts[4];
+	for (int part = 3; part >= 0; part--) {
+		parts[part] = static_cast<int>(packed % IP_OCTET_RANGE);
+		packed /= IP_OCTET_RANGE;
+	}
+
+	char text[16];
+	snprintf(text, sizeof(text), "%d.%d.%d.%d", parts[0], parts[1], parts[2], parts[3]);
+	return text;
+}
+
+} // namespace Net
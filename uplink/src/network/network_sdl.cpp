@@ -6,8 +6,37 @@
 
 #include <cstring>
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#endif
+
+// SDL_net has no non-blocking send and keeps the OS socket private. Every
+// release from 1.2 to 2.x starts its TCP socket with the two members below;
+// anything else must not build against them.
+#if defined(SDL_NET_VERSION_ATLEAST)
+#if SDL_NET_VERSION_ATLEAST(3, 0, 0)
+#error "SDLNetSocketPrefix only matches SDL_net 1.2 - 2.x"
+#endif
+#elif !defined(SDL_NET_MAJOR_VERSION) || SDL_NET_MAJOR_VERSION >= 3
+#error "SDLNetSocketPrefix only matches SDL_net 1.2 - 2.x"
+#endif
+
 namespace Net {
 
+struct SDLNetSocketPrefix {
+    int ready;
+#ifdef _WIN32
+    SOCKET channel;
+#else
+    int channel;
+#endif
+};
+
 // ============================================================================
 // Socket Implementation
 // ============================================================================
@@ -78,12 +107,60 @@ NetResult Socket::Send(const void* data, size_t length) {
     return NetResult::OK;
 }
 
+bool Socket::SetNonBlocking() {
+    if (!m_socket) return false;
+
+    const SDLNetSocketPrefix* raw = reinterpret_cast<const SDLNetSocketPrefix*>(m_socket);
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    return ioctlsocket(raw->channel, FIONBIO, &nonBlocking) == 0;
+#else
+    int flags = fcntl(raw->channel, F_GETFL, 0);
+    return flags >= 0 && fcntl(raw->channel, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+NetResult Socket::SendNonBlocking(const void* data, size_t length, size_t& sent) {
+    sent = 0;
+    if (!m_socket) return NetResult::ERR_DISCONNECTED;
+    if (!data || length == 0) return NetResult::OK;
+
+    const SDLNetSocketPrefix* raw = reinterpret_cast<const SDLNetSocketPrefix*>(m_socket);
+
+#ifdef _WIN32
+    // Non-blocking since SetNonBlocking, so this is the only syscall
+    int result = send(raw->channel, static_cast<const char*>(data), static_cast<int>(length), 0);
+    bool wouldBlock = result == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL; // A closed peer is an error, not SIGPIPE
+#endif
+    ssize_t result;
+    do {
+        result = send(raw->channel, data, length, flags);
+    } while (result < 0 && errno == EINTR);
+    bool wouldBlock = result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+
+    if (wouldBlock) {
+        return NetResult::OK;
+    }
+    if (result < 0) {
+        return NetResult::ERR_SEND_FAILED;
+    }
+
+    sent = static_cast<size_t>(result);
+    return NetResult::OK;
+}
+
 int Socket::Recv(void* buffer, size_t maxLength, uint32_t timeoutMs) {
     if (!m_socket) return -1;
     if (!buffer || maxLength == 0) return 0;
     
-    // Check if data is available
-    if (timeoutMs == 0) {
+    // Check if data is available (skip the probe if Poll already flagged us)
+    if (timeoutMs == 0 && !SDLNet_SocketReady(m_socket)) {
         SDLNet_SocketSet set = SDLNet_AllocSocketSet(1);
         if (!set) return -1;
         
@@ -116,6 +193,87 @@ bool Socket::HasData(uint32_t timeoutMs) {
     return hasData;
 }
 
+bool Socket::IsReady() const {
+    return m_socket && SDLNet_SocketReady(m_socket);
+}
+
+// ============================================================================
+// SocketSet Implementation
+// ============================================================================
+
+SocketSet::SocketSet()
+    : m_set(nullptr)
+    , m_maxSockets(0)
+    , m_watchedCount(0)
+{
+}
+
+SocketSet::~SocketSet() {
+    Free();
+}
+
+bool SocketSet::Init(int maxSockets) {
+    Free();
+
+    m_set = SDLNet_AllocSocketSet(maxSockets);
+    if (!m_set) return false;
+
+    m_maxSockets = maxSockets;
+    m_watchedCount = 0;
+    return true;
+}
+
+void SocketSet::Free() {
+    if (m_set) {
+        SDLNet_FreeSocketSet(m_set);
+        m_set = nullptr;
+    }
+    m_maxSockets = 0;
+    m_watchedCount = 0;
+}
+
+bool SocketSet::Watch(Socket& socket) {
+    return Add(socket.m_socket);
+}
+
+void SocketSet::Unwatch(Socket& socket) {
+    Remove(socket.m_socket);
+}
+
+bool SocketSet::Add(TCPsocket socket) {
+    if (!m_set || !socket) return false;
+    if (m_watchedCount >= m_maxSockets) return false;
+
+    if (SDLNet_TCP_AddSocket(m_set, socket) < 0) {
+        return false;
+    }
+    m_watchedCount++;
+    return true;
+}
+
+void SocketSet::Remove(TCPsocket socket) {
+    if (!m_set || !socket) return;
+
+    if (SDLNet_TCP_DelSocket(m_set, socket) >= 0) {
+        m_watchedCount--;
+    }
+}
+
+int SocketSet::Poll(uint32_t timeoutMs) {
+    if (!m_set || m_watchedCount == 0) return 0;
+
+    // Single select() over every watched socket - sets each socket's ready flag
+    return SDLNet_CheckSockets(m_set, timeoutMs);
+}
+
+int SocketSet::GetWatchedCount() const {
+    return m_watchedCount;
+}
+
+int SocketSet::GetCapacity() const {
+    return m_maxSockets;
+}
+
 // ============================================================================
 // NetworkManager Implementation
 // ============================================================================
@@ -123,7 +281,6 @@ bool Socket::HasData(uint32_t timeoutMs) {
 NetworkManager::NetworkManager()
     : m_initialized(false)
     , m_listenSocket(nullptr)
-    , m_socketSet(nullptr)
 {
 }
 
@@ -136,15 +293,14 @@ NetworkManager& NetworkManager::Instance() {
     return instance;
 }
 
-NetResult NetworkManager::Init() {
+NetResult NetworkManager::Init(int maxSockets) {
     if (m_initialized) return NetResult::OK;
     
     if (SDLNet_Init() < 0) {
         return NetResult::ERR_INIT_FAILED;
     }
     
-    m_socketSet = SDLNet_AllocSocketSet(NET_MAX_PLAYERS + 1);
-    if (!m_socketSet) {
+    if (!m_socketSet.Init(maxSockets)) {
         SDLNet_Quit();
         return NetResult::ERR_INIT_FAILED;
     }
@@ -158,10 +314,7 @@ void NetworkManager::Shutdown() {
     
     StopListening();
     
-    if (m_socketSet) {
-        SDLNet_FreeSocketSet(m_socketSet);
-        m_socketSet = nullptr;
-    }
+    m_socketSet.Free();
     
     SDLNet_Quit();
     m_initialized = false;
@@ -185,15 +338,17 @@ NetResult NetworkManager::Listen(uint16_t port) {
         return NetResult::ERR_BIND_FAILED;
     }
     
-    SDLNet_TCP_AddSocket(m_socketSet, m_listenSocket);
+    if (!m_socketSet.Add(m_listenSocket)) {
+        SDLNet_TCP_Close(m_listenSocket);
+        m_listenSocket = nullptr;
+        return NetResult::ERR_BIND_FAILED;
+    }
     return NetResult::OK;
 }
 
 void NetworkManager::StopListening() {
     if (m_listenSocket) {
-        if (m_socketSet) {
-            SDLNet_TCP_DelSocket(m_socketSet, m_listenSocket);
-        }
+        m_socketSet.Remove(m_listenSocket);
         SDLNet_TCP_Close(m_listenSocket);
         m_listenSocket = nullptr;
     }
@@ -202,10 +357,12 @@ void NetworkManager::StopListening() {
 Socket* NetworkManager::Accept() {
     if (!m_listenSocket) return nullptr;
     
-    // Check if there's a pending connection
-    int ready = SDLNet_CheckSockets(m_socketSet, 0);
-    if (ready <= 0 || !SDLNet_SocketReady(m_listenSocket)) {
-        return nullptr;
+    // Check if there's a pending connection (Poll may already have flagged it)
+    if (!SDLNet_SocketReady(m_listenSocket)) {
+        int ready = m_socketSet.Poll(0);
+        if (ready <= 0 || !SDLNet_SocketReady(m_listenSocket)) {
+            return nullptr;
+        }
     }
     
     TCPsocket clientSocket = SDLNet_TCP_Accept(m_listenSocket);
@@ -218,6 +375,22 @@ Socket* NetworkManager::Accept() {
     return socket;
 }
 
+bool NetworkManager::Watch(Socket& socket) {
+    return m_socketSet.Watch(socket);
+}
+
+void NetworkManager::Unwatch(Socket& socket) {
+    m_socketSet.Unwatch(socket);
+}
+
+int NetworkManager::Poll(uint32_t timeoutMs) {
+    return m_socketSet.Poll(timeoutMs);
+}
+
+int NetworkManager::GetWatchedCount() const {
+    return m_socketSet.GetWatchedCount();
+}
+
 NetResult NetworkManager::Connect(const std::string& host, uint16_t port, Socket& outSocket) {
     if (!m_initialized) return NetResult::ERR_INIT_FAILED;
     
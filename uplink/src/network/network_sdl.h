@@ -19,7 +19,9 @@ namespace Net {
 
 constexpr uint16_t DEFAULT_PORT = 31337;
 constexpr size_t NET_MAX_PLAYERS = 32;
-constexpr uint32_t PROTOCOL_VERSION = 1;
+// 2: zstd FLAG_COMPRESSED payloads, 3: timestamped TIME_SYNC, 4: reliable channel and session resume,
+// 5: varint-encoded messages (packetcodec.h)
+constexpr uint32_t PROTOCOL_VERSION = 5;
 
 // Default server address - change this to your production server IP/hostname
 constexpr const char* DEFAULT_SERVER_HOST = "localhost";
@@ -80,6 +82,14 @@ public:
 	// Send data (blocking)
 	NetResult Send(const void* data, size_t length);
 
+	// Put the socket in non-blocking mode for good (Send no longer waits either).
+	// Call once before using SendNonBlocking; returns false on failure.
+	bool SetNonBlocking();
+
+	// Send as much as the kernel will take right now, without waiting. sent is
+	// set to the bytes written, which may be none while the peer isn't reading.
+	NetResult SendNonBlocking(const void* data, size_t length, size_t& sent);
+
 	// Receive data (non-blocking if timeout is 0)
 	// Returns bytes received, or 0 if no data, or -1 on error
 	int Recv(void* buffer, size_t maxLength, uint32_t timeoutMs = 0);
@@ -87,11 +97,62 @@ public:
 	// Check if data is available to read
 	bool HasData(uint32_t timeoutMs = 0);
 
+	// Check the readiness flag set by the last NetworkManager::Poll (no syscall)
+	bool IsReady() const;
+
 private:
 	friend class NetworkManager;
+	friend class SocketSet;
 	TCPsocket m_socket;
 };
 
+// ============================================================================
+// Socket Set
+// ============================================================================
+
+// Readiness multiplexing over a group of sockets - one select() per Poll.
+// A socket belongs to at most one set, and each thread that waits on sockets
+// owns its own set.
+class SocketSet {
+public:
+	SocketSet();
+	~SocketSet();
+
+	// No copy
+	SocketSet(const SocketSet&) = delete;
+	SocketSet& operator=(const SocketSet&) = delete;
+
+	// Allocate room for maxSockets sockets (SDL_net must be initialised)
+	bool Init(int maxSockets);
+
+	// Free the set; the sockets themselves stay open
+	void Free();
+
+	// Add a connected socket so Poll() reports it
+	// Returns false if the set is full
+	bool Watch(Socket& socket);
+
+	// Remove a socket (call before closing it)
+	void Unwatch(Socket& socket);
+
+	// Block until a watched socket is readable or the timeout expires
+	// Returns number of ready sockets, 0 on timeout or when empty, -1 on error
+	int Poll(uint32_t timeoutMs);
+
+	int GetWatchedCount() const;
+	int GetCapacity() const;
+
+private:
+	friend class NetworkManager;
+
+	bool Add(TCPsocket socket);
+	void Remove(TCPsocket socket);
+
+	SDLNet_SocketSet m_set;
+	int m_maxSockets;
+	int m_watchedCount;
+};
+
 // ============================================================================
 // Network Manager (Singleton)
 // ============================================================================
@@ -101,7 +162,8 @@ public:
 	static NetworkManager& Instance();
 
 	// Initialize SDL_net
-	NetResult Init();
+	// maxSockets sizes the shared socket set (listen socket + watched connections)
+	NetResult Init(int maxSockets = NET_MAX_PLAYERS + 1);
 
 	// Shutdown SDL_net
 	void Shutdown();
@@ -121,6 +183,25 @@ public:
 	// Returns nullptr if no pending connection
 	Socket* Accept();
 
+	// ---- Readiness Multiplexing ----
+
+	// The shared set holds the listen socket; threads other than the one
+	// accepting connections should wait on a SocketSet of their own
+
+	// Add a connected socket to the shared socket set so Poll() reports it
+	// Returns false if the set is full
+	bool Watch(Socket& socket);
+
+	// Remove a socket from the shared socket set (call before closing it)
+	void Unwatch(Socket& socket);
+
+	// Block until the listen socket or a watched socket is readable, or the timeout expires
+	// Returns number of ready sockets, 0 on timeout, -1 on error
+	int Poll(uint32_t timeoutMs);
+
+	// Number of sockets currently in the set (including the listen socket)
+	int GetWatchedCount() const;
+
 	// ---- Client Functions ----
 
 	// Connect to a server
@@ -144,14 +225,17 @@ private:
 
 	bool m_initialized;
 	TCPsocket m_listenSocket;
-	SDLNet_SocketSet m_socketSet;
+	SocketSet m_socketSet;
 };
 
 // ============================================================================
 // Convenience functions
 // ============================================================================
 
-inline NetResult NetInit() { return NetworkManager::Instance().Init(); }
+inline NetResult NetInit(int maxSockets = NET_MAX_PLAYERS + 1)
+{
+	return NetworkManager::Instance().Init(maxSockets);
+}
 
 inline void NetShutdown() { NetworkManager::Instance().Shutdown(); }
 
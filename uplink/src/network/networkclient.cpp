@@ -9,6 +9,7 @@
 
 #include "app/app.h"
 #include "app/globals.h"
+#include "app/miscutils.h"
 
 #include "options/options.h"
 
@@ -38,6 +39,11 @@ NetworkClient::NetworkClient()
 #if ENABLE_NETWORK
 	socket = nullptr;
 	m_connectionState = ConnectionState::DISCONNECTED;
+	m_session = 0;
+	m_playerId = 0;
+	m_sessionReady = false;
+	m_resuming = false;
+	m_fragmentResume = 0;
 #endif
 
 	clienttype = CLIENT_NONE;
@@ -109,39 +115,14 @@ bool NetworkClient::StartClient(const char* ip)
 		Net::Socket* newSock = new Net::Socket(std::move(clientSocket));
 		socket = newSock;
 
-		// Send Handshake Packet
-		Net::HandshakePacket handshakePayload;
-		handshakePayload.protocolVersion = Net::PROTOCOL_VERSION;
-		handshakePayload.clientVersion = 1;
-
-		// Handle (get from player profile if possible, else "Player")
-		// Uplink world player might not be fully initialized yet?
-		// Actually StartClient is called from MainMenu, player might be "NEWAGENT" or loaded.
-		// For now, use "Guest".
-		strncpy(handshakePayload.handle, "Guest", sizeof(handshakePayload.handle) - 1);
-
-		Net::SupabaseClient& supabase = Net::SupabaseClient::Instance();
-		std::string token = supabase.GetAuthToken();
-		if (token.length() > 0) {
-			strncpy(handshakePayload.authToken, token.c_str(), sizeof(handshakePayload.authToken) - 1);
-		} else {
-			memset(handshakePayload.authToken, 0, sizeof(handshakePayload.authToken));
-		}
-
-		// Serialize
-		uint8_t buffer[1024];
-		size_t packetLen = Net::WritePacket(
-			buffer, Net::PacketType::HANDSHAKE, Net::FLAG_NONE, &handshakePayload, sizeof(handshakePayload));
-
-		Net::NetResult sendRes = newSock->Send(buffer, packetLen);
-		if (sendRes != Net::NetResult::OK) {
+		if (!SendHandshake(*newSock)) {
 			printf("NetworkClient::StartClient failed to send handshake\n");
 			delete newSock;
 			socket = nullptr;
 			return false;
 		}
 
-		m_recvBuffer.clear();
+		m_recvStream.Clear();
 		return true;
 	}
 #else
@@ -160,8 +141,17 @@ bool NetworkClient::StartClientAsync(const char* ip)
 	// Clean up old connection if any
 	StopClient();
 
-	m_connectionState = ConnectionState::CONNECTING;
 	m_pendingHost = ip;
+	return ConnectAsync();
+#else
+	return false;
+#endif
+}
+
+#if ENABLE_NETWORK
+bool NetworkClient::ConnectAsync()
+{
+	m_connectionState = ConnectionState::CONNECTING;
 
 	// Start connection in background thread
 	if (m_connectThread.joinable()) {
@@ -185,26 +175,7 @@ bool NetworkClient::StartClientAsync(const char* ip)
 		Net::Socket* newSock = new Net::Socket(std::move(clientSocket));
 		socket = newSock;
 
-		// Send Handshake Packet
-		Net::HandshakePacket handshakePayload;
-		handshakePayload.protocolVersion = Net::PROTOCOL_VERSION;
-		handshakePayload.clientVersion = 1;
-		strncpy(handshakePayload.handle, "Guest", sizeof(handshakePayload.handle) - 1);
-
-		Net::SupabaseClient& supabase = Net::SupabaseClient::Instance();
-		std::string token = supabase.GetAuthToken();
-		if (token.length() > 0) {
-			strncpy(handshakePayload.authToken, token.c_str(), sizeof(handshakePayload.authToken) - 1);
-		} else {
-			memset(handshakePayload.authToken, 0, sizeof(handshakePayload.authToken));
-		}
-
-		uint8_t buffer[1024];
-		size_t packetLen = Net::WritePacket(
-			buffer, Net::PacketType::HANDSHAKE, Net::FLAG_NONE, &handshakePayload, sizeof(handshakePayload));
-
-		Net::NetResult sendRes = newSock->Send(buffer, packetLen);
-		if (sendRes != Net::NetResult::OK) {
+		if (!SendHandshake(*newSock)) {
 			printf("[NetworkClient] Async connection: handshake failed\n");
 			delete newSock;
 			socket = nullptr;
@@ -217,11 +188,42 @@ bool NetworkClient::StartClientAsync(const char* ip)
 	});
 
 	return true;
-#else
-	return false;
-#endif
 }
 
+bool NetworkClient::SendHandshake(Net::Socket& sock)
+{
+	Net::HandshakePacket handshakePayload;
+	handshakePayload.protocolVersion = Net::PROTOCOL_VERSION;
+	handshakePayload.clientVersion = 1;
+
+	// Handle (get from player profile if possible, else "Player")
+	// Uplink world player might not be fully initialized yet?
+	// Actually StartClient is called from MainMenu, player might be "NEWAGENT" or loaded.
+	// For now, use "Guest".
+	handshakePayload.handle = "Guest";
+
+	std::string token = Net::SupabaseClient::Instance().GetAuthToken();
+	handshakePayload.authToken = token;
+
+	// After a dropped connection, ask to carry on with the same session
+	handshakePayload.resumeSession = m_session;
+	handshakePayload.resumeReceived = m_reliableIn.GetReceived();
+
+	// May run on the connect thread, so it keeps clear of m_messageBuffer
+	std::vector<uint8_t> encoded;
+	Net::EncodeMessage(handshakePayload, encoded);
+
+	std::vector<uint8_t> buffer(sizeof(Net::PacketHeader) + encoded.size());
+	size_t packetLen = Net::WritePacket(buffer.data(),
+										Net::PacketType::HANDSHAKE,
+										Net::FLAG_NONE,
+										encoded.data(),
+										static_cast<uint16_t>(encoded.size()));
+
+	return sock.Send(buffer.data(), packetLen) == Net::NetResult::OK;
+}
+#endif
+
 bool NetworkClient::StopClient()
 {
 #if ENABLE_NETWORK
@@ -237,6 +239,14 @@ bool NetworkClient::StopClient()
 		socket = nullptr;
 	}
 
+	// Next connection starts a fresh stream and session
+	m_recvStream.Clear();
+	m_decompressor.Reset();
+	m_fragmentBuffer.clear();
+	m_worldMirror.Clear();
+	ResetServerClock();
+	EndSession();
+
 	m_connectionState = ConnectionState::DISCONNECTED;
 	return true;
 
@@ -354,6 +364,14 @@ void NetworkClient::Update()
 {
 
 #if ENABLE_NETWORK
+	// A reconnect to resume the session didn't get through
+	if (m_resuming && m_connectionState == ConnectionState::FAILED) {
+		printf("NetworkClient: Could not resume the session\n");
+		EndSession();
+		ReturnToMenu();
+		return;
+	}
+
 	// Check for input from server
 
 	if (socket != nullptr) {
@@ -361,56 +379,148 @@ void NetworkClient::Update()
 
 		// Simple receive loop
 		if (clientSock->HasData()) {
-			char buffer[4096];
-			int received = clientSock->Recv(buffer, sizeof(buffer));
+			int received = clientSock->Recv(m_recvStream.WriteBegin(), m_recvStream.WriteSpace());
 
 			if (received > 0) {
-				// Append to buffer
-				size_t oldSize = m_recvBuffer.size();
-				m_recvBuffer.resize(oldSize + received);
-				memcpy(m_recvBuffer.data() + oldSize, buffer, received);
-
-				// Process packets
-				while (m_recvBuffer.size() >= sizeof(Net::PacketHeader)) {
-					Net::PacketHeader header;
-					memcpy(&header, m_recvBuffer.data(), sizeof(header));
+				m_recvStream.CommitWrite(static_cast<size_t>(received));
+
+				// Process every complete packet in place
+				Net::PacketView packet;
+				while (m_recvStream.Next(packet)) {
+					Net::PacketHeader header = packet.header;
+					const uint8_t* payload = packet.payload;
+
+					// Reliable packets carry their sequence ahead of the (maybe compressed) body
+					uint32_t sequence = 0;
+					if (header.flags & Net::FLAG_RELIABLE) {
+						if (header.length < Net::RELIABLE_PREFIX_SIZE) {
+							continue;
+						}
+						sequence = Net::ReadSequence(payload);
+						payload += Net::RELIABLE_PREFIX_SIZE;
+						header.length -= Net::RELIABLE_PREFIX_SIZE;
+					}
 
-					size_t fullPacketSize = sizeof(Net::PacketHeader) + header.length;
+					// Inflate in place of the wire payload; handlers below see the original bytes
+					if (header.flags & Net::FLAG_COMPRESSED) {
+						size_t inflatedLen = 0;
+						if (!m_decompressor.Decompress(payload, header.length, payload, inflatedLen)) {
+							printf("[NET] Failed to decompress packet type 0x%02X\n", header.type);
+							continue;
+						}
+						header.length = static_cast<uint16_t>(inflatedLen);
+						header.flags &= ~Net::FLAG_COMPRESSED;
+					}
 
-					if (m_recvBuffer.size() < fullPacketSize) {
-						break; // Wait for more data
+					// Copies resent after a resume are inflated above (the stream has to
+					// see them) but were applied before the connection dropped
+					if (sequence != 0) {
+						Net::ReliableReceiver::Result result = m_reliableIn.Accept(sequence);
+						if (result == Net::ReliableReceiver::Result::DUPLICATE) {
+							continue;
+						}
+						if (result == Net::ReliableReceiver::Result::GAP) {
+							printf("[NET] Reliable sequence gap (%u after %u)\n",
+								   sequence,
+								   m_reliableIn.GetReceived());
+							m_session = 0; // What we have can't be resumed
+							ConnectionLost();
+							return;
+						}
 					}
 
-					// We have a full packet
-					const uint8_t* payload = m_recvBuffer.data() + sizeof(Net::PacketHeader);
+					// Reassemble fragmented messages; only the last fragment is dispatched
+					size_t messageLen = header.length;
+					if (header.flags & Net::FLAG_FRAGMENTED) {
+						if (m_fragmentBuffer.size() + header.length > MAX_MESSAGE_SIZE) {
+							printf("[NET] Fragmented message too large, dropping\n");
+							m_fragmentBuffer.clear();
+							continue;
+						}
+						if (m_fragmentBuffer.empty()) {
+							m_fragmentResume = sequence != 0 ? sequence - 1 : m_reliableIn.GetReceived();
+						}
+						m_fragmentBuffer.insert(m_fragmentBuffer.end(), payload, payload + header.length);
+						if (!(header.flags & Net::FLAG_LAST_FRAGMENT)) {
+							continue;
+						}
+						payload = m_fragmentBuffer.data();
+						messageLen = m_fragmentBuffer.size();
+					}
 
 					// Handle packet
 					switch (static_cast<Net::PacketType>(header.type)) {
+					case Net::PacketType::HANDSHAKE_ACK: {
+						Net::HandshakeAckPacket ack;
+						if (Net::DecodeMessage(payload, messageLen, ack)) {
+							HandleHandshakeAck(ack);
+						}
+						break;
+					}
+					case Net::PacketType::ACK: {
+						Net::AckPacket ack;
+						if (Net::DecodeMessage(payload, messageLen, ack)) {
+							m_reliableOut.Acknowledge(ack.sequence);
+						}
+						break;
+					}
+					case Net::PacketType::WORLD_FULL: {
+						if (m_worldMirror.ApplyFull(payload, messageLen)) {
+							printf("[NET] World snapshot: %zu entities\n",
+								   m_worldMirror.GetEntities().size());
+						} else {
+							printf("[NET] Malformed world snapshot\n");
+						}
+						break;
+					}
+					case Net::PacketType::WORLD_DELTA: {
+						if (!m_worldMirror.ApplyDelta(payload, messageLen)) {
+							printf("[NET] Malformed or unexpected world delta\n");
+						}
+						break;
+					}
 					case Net::PacketType::TIME_SYNC: {
-						if (header.length >= sizeof(Net::TimeSyncPacket)) {
-							const Net::TimeSyncPacket* tsp =
-								reinterpret_cast<const Net::TimeSyncPacket*>(payload);
-							if (game && game->GetWorld()) {
-								game->GetWorld()->date.SetDate(
-									tsp->second, tsp->minute, tsp->hour, tsp->day, tsp->month, tsp->year);
-							}
+						Net::TimeSyncPacket tsp;
+						if (Net::DecodeMessage(payload, messageLen, tsp)) {
+							double gameSeconds =
+								Date::CalendarToSeconds(
+									tsp.second, tsp.minute, tsp.hour, tsp.day, tsp.month, tsp.year) +
+								tsp.millisecond / 1000.0;
+							m_serverClock.AddSample(gameSeconds,
+													tsp.paused ? 0.0 : tsp.gameSpeed,
+													tsp.serverTimeMs,
+													GetAccurateTime() / 1000.0);
+						}
+						break;
+					}
+					case Net::PacketType::TRACE_UPDATE: {
+						Net::TraceUpdatePacket trace;
+						if (Net::DecodeMessage(payload, messageLen, trace)) {
+							m_tracePredictor.AddUpdate(trace.active,
+													   trace.progress,
+													   trace.linksPerSecond,
+													   trace.totalLinks,
+													   GetAccurateTime() / 1000.0);
 						}
 						break;
 					}
 					case Net::PacketType::PLAYER_CHAT: {
-						if (header.length >= sizeof(Net::ChatPacket)) {
-							const Net::ChatPacket* chat = reinterpret_cast<const Net::ChatPacket*>(payload);
-
-							// Log to console
-							printf("[CHAT] [%s] %s: %s\n", chat->channel, chat->sender, chat->message);
-
+						Net::ChatPacket chat;
+						if (Net::DecodeMessage(payload, messageLen, chat)) {
 							// Store in chat history
 							ChatDisplayMessage msg;
-							msg.sender = chat->sender;
-							msg.channel = chat->channel;
-							msg.message = chat->message;
+							msg.sender = chat.sender;
+							msg.channel = chat.channel;
+							msg.message = chat.message;
 							msg.timestamp = 0; // TODO: get game time
-							m_chatHistory.push_back(msg);
+
+							// Log to console
+							printf("[CHAT] [%s] %s: %s\n",
+								   msg.channel.c_str(),
+								   msg.sender.c_str(),
+								   msg.message.c_str());
+
+							m_chatHistory.push_back(std::move(msg));
 
 							// Trim to max size
 							while (m_chatHistory.size() > MAX_CHAT_HISTORY) {
@@ -420,18 +530,20 @@ void NetworkClient::Update()
 						break;
 					}
 					case Net::PacketType::PLAYER_LIST: {
-						if (header.length >= sizeof(uint8_t)) {
-							const Net::PlayerListPacket* list =
-								reinterpret_cast<const Net::PlayerListPacket*>(payload);
-
+						Net::PlayerListPacket list;
+						if (Net::DecodeMessage(payload, messageLen, list)) {
 							// Store player list
 							m_onlinePlayers.clear();
-							for (uint8_t i = 0; i < list->playerCount && i < 32; ++i) {
-								m_onlinePlayers.push_back(list->players[i]);
-							}
-
-							if (list->playerCount > 0) {
-								printf("[NET] %u players online\n", list->playerCount);
+							list.players.ForEach([this](const Net::PlayerListEntry& entry) {
+								OnlinePlayer player;
+								player.playerId = entry.playerId;
+								player.handle = entry.handle;
+								player.rating = entry.rating;
+								m_onlinePlayers.push_back(std::move(player));
+							});
+
+							if (!m_onlinePlayers.empty()) {
+								printf("[NET] %zu players online\n", m_onlinePlayers.size());
 							}
 						}
 						break;
@@ -440,28 +552,21 @@ void NetworkClient::Update()
 						break;
 					}
 
-					// Remove processed packet
-					m_recvBuffer.erase(m_recvBuffer.begin(), m_recvBuffer.begin() + fullPacketSize);
+					if (header.flags & Net::FLAG_FRAGMENTED) {
+						m_fragmentBuffer.clear();
+					}
 				}
-			} else if (received == -1) {
-				// Disconnected
-				printf("NetworkClient: Connection lost\n");
-
-				EclReset(app->GetOptions()->GetOptionValue("graphics_screenwidth"),
-						 app->GetOptions()->GetOptionValue("graphics_screenheight"));
-
-				clientSock->Close();
-				delete clientSock;
-				socket = nullptr;
-				m_recvBuffer.clear();
 
-				app->GetNetwork()->SetStatus(NETWORK_NONE);
-				app->GetMainMenu()->RunScreen(MAINMENU_NETWORKOPTIONS);
+				SendAck();
+			} else if (received == -1) {
+				ConnectionLost();
 				return;
 			}
 		}
 	}
 
+	ApplyServerClock();
+
 	// Update interface
 
 	if (screen) {
@@ -470,34 +575,193 @@ void NetworkClient::Update()
 #endif
 }
 
+#if ENABLE_NETWORK
+void NetworkClient::ApplyServerClock()
+{
+	if (!m_serverClock.HasEstimate() || !game || !game->GetWorld()) {
+		return;
+	}
+
+	// The server owns the clock while connected - the date only shows the
+	// prediction, whole seconds at a time, and no longer runs on its own
+	Date& date = game->GetWorld()->date;
+	date.DeActivate();
+	date.SetSeconds(static_cast<int64_t>(m_serverClock.DisplaySeconds(GetAccurateTime() / 1000.0)));
+}
+
+void NetworkClient::ResetServerClock()
+{
+	if (m_serverClock.HasEstimate() && game && game->GetWorld()) {
+		game->GetWorld()->date.Activate();
+	}
+
+	m_serverClock.Reset();
+	m_tracePredictor.Reset();
+}
+
+float NetworkClient::GetTraceProgress() { return m_tracePredictor.GetProgress(GetAccurateTime() / 1000.0); }
+#endif
+
 std::string NetworkClient::GetID() { return "CLIENT"; }
 
 #if ENABLE_NETWORK
 void NetworkClient::SendChat(const char* channel, const char* message)
 {
-	if (!socket || !IsConnected()) {
+	// Chat typed while a dropped connection resumes goes out once it has
+	if (!m_resuming && (!socket || !IsConnected())) {
 		return;
 	}
 
-	Net::Socket* clientSock = (Net::Socket*)socket;
-
+	// The server fills in the sender from the handshake
 	Net::ChatPacket chatPayload;
-	memset(&chatPayload, 0, sizeof(chatPayload));
+	chatPayload.channel = channel;
+	chatPayload.message = message;
 
-	// Get player handle if available
-	if (game && game->GetWorld() && game->GetWorld()->GetPlayer()) {
-		strncpy(chatPayload.sender, game->GetWorld()->GetPlayer()->handle, sizeof(chatPayload.sender) - 1);
+	SendEncoded(Net::PacketType::PLAYER_CHAT, Net::FLAG_RELIABLE, chatPayload);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reliable channel and session resume
+//////////////////////////////////////////////////////////////////////
+
+bool NetworkClient::SendPacket(Net::PacketType type, uint8_t flags, const void* body, uint16_t length)
+{
+	if (!(flags & Net::FLAG_RELIABLE)) {
+		return SendSequenced(type, flags, 0, body, length);
+	}
+
+	// Kept until the server acknowledges it, and sent again after a resume
+	uint32_t sequence = m_reliableOut.Retain(type, flags, body, length);
+	if (!m_sessionReady) {
+		return true; // Goes out with the rest once the session is back
+	}
+	return SendSequenced(type, flags, sequence, body, length);
+}
+
+bool NetworkClient::SendSequenced(
+	Net::PacketType type, uint8_t flags, uint32_t sequence, const void* body, size_t length)
+{
+	if (!socket) {
+		return false;
+	}
+
+	size_t prefix = sequence != 0 ? Net::RELIABLE_PREFIX_SIZE : 0;
+	m_sendBuffer.resize(sizeof(Net::PacketHeader) + prefix + length);
+
+	uint8_t* packet = m_sendBuffer.data();
+	Net::WritePacket(packet, type, flags, nullptr, static_cast<uint16_t>(prefix + length));
+	if (sequence != 0) {
+		Net::WriteSequence(packet + sizeof(Net::PacketHeader), sequence);
+	}
+	if (length > 0) {
+		memcpy(packet + sizeof(Net::PacketHeader) + prefix, body, length);
+	}
+
+	Net::Socket* clientSock = (Net::Socket*)socket;
+	return clientSock->Send(packet, m_sendBuffer.size()) == Net::NetResult::OK;
+}
+
+void NetworkClient::HandleHandshakeAck(const Net::HandshakeAckPacket& ack)
+{
+	if (ack.resumed) {
+		// The server kept everything; it has our packets up to ack.received
+		m_reliableOut.Acknowledge(ack.received);
+		printf("[NET] Session resumed as player #%u\n", ack.playerId);
 	} else {
-		strncpy(chatPayload.sender, "Player", sizeof(chatPayload.sender) - 1);
+		// A new session: the server starts again with a WORLD_FULL, and anything
+		// we had queued for the old one is gone with it
+		if (m_session != 0) {
+			printf("[NET] Session could not be resumed, starting a new one\n");
+		}
+		m_worldMirror.Clear();
+		m_reliableOut.Reset();
+		m_reliableIn.Reset();
+		m_fragmentBuffer.clear();
+	}
+
+	m_session = ack.session;
+	m_playerId = ack.playerId;
+	m_sessionReady = true;
+	m_resuming = false;
+
+	m_reliableOut.ForEachUnacked(
+		[this](uint32_t sequence, Net::PacketType type, uint8_t flags, const uint8_t* body, size_t length) {
+			SendSequenced(type, flags, sequence, body, length);
+		});
+}
+
+void NetworkClient::SendAck()
+{
+	if (!m_sessionReady) {
+		return;
+	}
+
+	// Part of a fragmented message doesn't count until all of it has arrived:
+	// a resume restarts the message from its first fragment
+	uint32_t sequence = m_fragmentBuffer.empty() ? m_reliableIn.GetReceived() : m_fragmentResume;
+	if (!m_reliableIn.TakeAck(sequence)) {
+		return;
+	}
+
+	Net::AckPacket ack;
+	ack.sequence = sequence;
+	SendEncoded(Net::PacketType::ACK, Net::FLAG_NONE, ack);
+}
+
+void NetworkClient::ConnectionLost()
+{
+	printf("NetworkClient: Connection lost\n");
+
+	Net::Socket* clientSock = (Net::Socket*)socket;
+	if (clientSock) {
+		clientSock->Close();
+		delete clientSock;
+		socket = nullptr;
 	}
 
-	strncpy(chatPayload.channel, channel, sizeof(chatPayload.channel) - 1);
-	strncpy(chatPayload.message, message, sizeof(chatPayload.message) - 1);
+	// The next connection is a new stream; a half received message arrives
+	// again from its first fragment
+	m_recvStream.Clear();
+	m_decompressor.Reset();
+	if (!m_fragmentBuffer.empty()) {
+		m_reliableIn.Rewind(m_fragmentResume);
+		m_fragmentBuffer.clear();
+	}
+	ResetServerClock();
+	m_sessionReady = false;
+
+	// Carry on where we were if the server still has the session. The world
+	// mirror is kept: a resumed session continues from the same baseline.
+	if (m_session != 0 && !m_resuming) {
+		printf("NetworkClient: Resuming session\n");
+		m_resuming = true;
+		ConnectAsync();
+		return;
+	}
 
-	uint8_t buffer[512];
-	size_t packetLen = Net::WritePacket(
-		buffer, Net::PacketType::PLAYER_CHAT, Net::FLAG_NONE, &chatPayload, sizeof(chatPayload));
+	EndSession();
+	ReturnToMenu();
+}
+
+void NetworkClient::EndSession()
+{
+	m_session = 0;
+	m_playerId = 0;
+	m_sessionReady = false;
+	m_resuming = false;
+	m_reliableOut.Reset();
+	m_reliableIn.Reset();
+}
+
+void NetworkClient::ReturnToMenu()
+{
+	EclReset(app->GetOptions()->GetOptionValue("graphics_screenwidth"),
+			 app->GetOptions()->GetOptionValue("graphics_screenheight"));
+
+	m_worldMirror.Clear();
+	m_connectionState = ConnectionState::DISCONNECTED;
 
-	clientSock->Send(buffer, packetLen);
+	app->GetNetwork()->SetStatus(NETWORK_NONE);
+	app->GetMainMenu()->RunScreen(MAINMENU_NETWORKOPTIONS);
 }
 #endif
@@ -14,6 +14,11 @@
 	#include "network/network_sdl.h"
 	#include "network/tcp4u_compat.h"
 	#include "network/protocol.h"
+	#include "network/packetframer.h"
+	#include "network/packetcompressor.h"
+	#include "network/worldreplication.h"
+	#include "network/clockmodel.h"
+	#include "network/reliablechannel.h"
 	#include <vector>
 	#include <string>
 	#include <thread>
@@ -33,6 +38,13 @@ class NetworkScreen;
 // Connection state for async connections
 enum class ConnectionState { DISCONNECTED, CONNECTING, CONNECTED, FAILED };
 
+// Online player, copied out of a PLAYER_LIST
+struct OnlinePlayer {
+	uint32_t playerId;
+	std::string handle;
+	int rating;
+};
+
 // Chat message structure for storage
 struct ChatDisplayMessage {
 	std::string sender;
@@ -48,7 +60,30 @@ class NetworkClient : public UplinkObject {
 protected:
 #if ENABLE_NETWORK
 	Net::Socket* socket;
-	std::vector<uint8_t> m_recvBuffer;
+	Net::PacketFramer m_recvStream;
+	Net::PacketDecompressor m_decompressor; // Inflates FLAG_COMPRESSED payloads
+	std::vector<uint8_t> m_fragmentBuffer; // Reassembles FLAG_FRAGMENTED messages
+	static const size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+	// Server world state replicated via WORLD_FULL / WORLD_DELTA
+	Net::WorldMirror m_worldMirror;
+
+	// Server game clock and trace progress, predicted between TIME_SYNC / TRACE_UPDATE
+	Net::ServerClock m_serverClock;
+	Net::TracePredictor m_tracePredictor;
+
+	// Reliable channel (chat out, world state in) and the session it belongs to.
+	// A dropped connection reconnects with the session and continues from the
+	// last acknowledged packet in each direction.
+	Net::ReliableSender m_reliableOut;
+	Net::ReliableReceiver m_reliableIn;
+	uint64_t m_session; // 0 = none
+	uint32_t m_playerId;
+	bool m_sessionReady; // HANDSHAKE_ACK received on this connection
+	bool m_resuming; // Reconnecting after a drop
+	uint32_t m_fragmentResume; // Last sequence before the fragmented message in m_fragmentBuffer
+	std::vector<uint8_t> m_sendBuffer; // Scratch for outgoing packets
+	std::vector<uint8_t> m_messageBuffer; // Scratch for encoding messages
 
 	// Async connection state
 	std::atomic<ConnectionState> m_connectionState;
@@ -56,7 +91,7 @@ protected:
 	std::thread m_connectThread;
 
 	// Online players and chat storage
-	std::vector<Net::PlayerListEntry> m_onlinePlayers;
+	std::vector<OnlinePlayer> m_onlinePlayers;
 	std::vector<ChatDisplayMessage> m_chatHistory;
 	static const size_t MAX_CHAT_HISTORY = 100;
 #endif
@@ -70,6 +105,27 @@ protected:
 	void Handle_ClientCommsData(char* buffer);
 	void Handle_ClientStatusData(char* buffer);
 
+#if ENABLE_NETWORK
+	void ApplyServerClock(); // Shows the predicted server time in the world's date
+	void ResetServerClock(); // Hands the date back to the local game
+
+	bool ConnectAsync(); // Connects to m_pendingHost on m_connectThread
+	bool SendHandshake(Net::Socket& sock);
+	bool SendPacket(Net::PacketType type, uint8_t flags, const void* body, uint16_t length);
+	template <typename Msg> bool SendEncoded(Net::PacketType type, uint8_t flags, const Msg& message)
+	{
+		size_t length = Net::EncodeMessage(message, m_messageBuffer);
+		return SendPacket(type, flags, m_messageBuffer.data(), static_cast<uint16_t>(length));
+	}
+	bool SendSequenced(
+		Net::PacketType type, uint8_t flags, uint32_t sequence, const void* body, size_t length);
+	void HandleHandshakeAck(const Net::HandshakeAckPacket& ack);
+	void SendAck(); // Acknowledges what has arrived, if that changed
+	void ConnectionLost(); // Resumes the session, or goes back to the menu
+	void EndSession();
+	void ReturnToMenu();
+#endif
+
 public:
 	NetworkClient();
 	virtual ~NetworkClient();
@@ -94,8 +150,12 @@ public:
 
 	// Online players and chat accessors
 #if ENABLE_NETWORK
-	const std::vector<Net::PlayerListEntry>& GetOnlinePlayers() const { return m_onlinePlayers; }
+	const std::vector<OnlinePlayer>& GetOnlinePlayers() const { return m_onlinePlayers; }
 	const std::vector<ChatDisplayMessage>& GetChatHistory() const { return m_chatHistory; }
+	const Net::WorldMirror& GetWorldMirror() const { return m_worldMirror; }
+	bool IsTraceActive() const { return m_tracePredictor.IsActive(); }
+	int GetTraceTotalLinks() const { return m_tracePredictor.GetTotalLinks(); }
+	float GetTraceProgress(); // Predicted links traced, 0 without an active trace
 	void SendChat(const char* channel, const char* message);
 #endif
 
@@ -0,0 +1,364 @@
+#pragma once
+
+/*
+ * Cybrelink Packet Codec
+ * Schema-driven encoders and decoders for the messages in protocol.h
+ *
+ * Each message struct lists its fields once, in wire order:
+ *
+ *   static constexpr auto Fields()
+ *   {
+ *       return std::make_tuple(Field(&ChatPacket::channel, MAX_CHANNEL_LENGTH), ...);
+ *   }
+ *
+ * and EncodeMessage / DecodeMessage walk that table. A field's encoding
+ * follows from its member type:
+ *
+ *   uint8_t, bool, 1 byte enums     1 byte
+ *   uint16_t, uint32_t, uint64_t    varint
+ *   int16_t, int32_t                zigzag varint
+ *   float                           4 bytes, little endian
+ *   std::string_view                varint length + bytes, at most maxLength
+ *   RepeatedView<Entry>             varint count + entries, at most maxLength
+ *
+ * Decoding is bounds checked and copies nothing: strings and lists are views
+ * into the payload and stay valid as long as it does. Bytes after the last
+ * field are ignored, so a message can grow trailing fields older peers skip.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace Net {
+
+// ============================================================================
+// Field Table
+// ============================================================================
+
+template <typename Msg, typename T> struct FieldSpec {
+	T Msg::*member;
+	size_t maxLength; // Strings: bytes, lists: entries, otherwise unused
+};
+
+template <typename Msg, typename T> constexpr FieldSpec<Msg, T> Field(T Msg::*member, size_t maxLength = 0)
+{
+	return { member, maxLength };
+}
+
+// ============================================================================
+// Payload Writer / Reader
+// ============================================================================
+
+class PayloadWriter {
+public:
+	explicit PayloadWriter(std::vector<uint8_t>& out) : m_out(out) { }
+
+	void WriteByte(uint8_t value) { m_out.push_back(value); }
+
+	void WriteVarint(uint64_t value)
+	{
+		while (value >= 0x80) {
+			m_out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		m_out.push_back(static_cast<uint8_t>(value));
+	}
+
+	void WriteFixed32(uint32_t value)
+	{
+		for (int i = 0; i < 4; i++) {
+			m_out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+
+	void WriteBytes(const void* data, size_t length)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_out.insert(m_out.end(), bytes, bytes + length);
+	}
+
+private:
+	std::vector<uint8_t>& m_out;
+};
+
+class PayloadReader {
+public:
+	PayloadReader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_pos(0) { }
+
+	size_t Position() const { return m_pos; }
+	const uint8_t* Current() const { return m_data + m_pos; }
+
+	bool ReadByte(uint8_t& out)
+	{
+		if (m_pos >= m_size) {
+			return false;
+		}
+		out = m_data[m_pos++];
+		return true;
+	}
+
+	bool ReadVarint(uint64_t& out)
+	{
+		out = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint8_t byte;
+			if (!ReadByte(byte)) {
+				return false;
+			}
+			out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false; // Longer than any 64 bit value
+	}
+
+	bool ReadFixed32(uint32_t& out)
+	{
+		if (m_size - m_pos < 4) {
+			return false;
+		}
+		out = 0;
+		for (int i = 0; i < 4; i++) {
+			out |= static_cast<uint32_t>(m_data[m_pos++]) << (i * 8);
+		}
+		return true;
+	}
+
+	// Points out at the next length bytes instead of copying them
+	bool ReadView(size_t length, const uint8_t*& out)
+	{
+		if (m_size - m_pos < length) {
+			return false;
+		}
+		out = m_data + m_pos;
+		m_pos += length;
+		return true;
+	}
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	size_t m_pos;
+};
+
+// ============================================================================
+// Repeated Fields
+// ============================================================================
+
+namespace Codec {
+template <typename Msg> void WriteFields(PayloadWriter& out, const Msg& msg);
+template <typename Msg> bool ReadFields(PayloadReader& in, Msg& msg);
+} // namespace Codec
+
+// A list of sub-messages. Senders point it at their entries; decoding points it
+// at the encoded entries in the payload, which ForEach decodes one at a time
+// (they were all checked when the message was decoded).
+
+template <typename Entry> class RepeatedView {
+public:
+	using EntryType = Entry;
+
+	RepeatedView() : m_items(nullptr), m_encoded(nullptr), m_encodedLength(0), m_count(0) { }
+
+	RepeatedView(const Entry* items, size_t count) :
+		m_items(items),
+		m_encoded(nullptr),
+		m_encodedLength(0),
+		m_count(count)
+	{
+	}
+
+	static RepeatedView FromPayload(const uint8_t* encoded, size_t length, size_t count)
+	{
+		RepeatedView view;
+		view.m_encoded = encoded;
+		view.m_encodedLength = length;
+		view.m_count = count;
+		return view;
+	}
+
+	size_t Size() const { return m_count; }
+	bool Empty() const { return m_count == 0; }
+
+	// fn(const Entry&) for each entry, in order
+	template <typename Fn> void ForEach(Fn&& fn) const
+	{
+		if (m_items) {
+			for (size_t i = 0; i < m_count; i++) {
+				fn(m_items[i]);
+			}
+			return;
+		}
+
+		PayloadReader in(m_encoded, m_encodedLength);
+		for (size_t i = 0; i < m_count; i++) {
+			Entry entry {};
+			Codec::ReadFields(in, entry);
+			fn(entry);
+		}
+	}
+
+private:
+	const Entry* m_items;
+	const uint8_t* m_encoded;
+	size_t m_encodedLength;
+	size_t m_count;
+};
+
+// ============================================================================
+// Field Encodings
+// ============================================================================
+
+namespace Codec {
+
+template <typename T> struct IsRepeated : std::false_type { };
+template <typename Entry> struct IsRepeated<RepeatedView<Entry>> : std::true_type { };
+
+template <typename T> constexpr bool IS_BYTE = std::is_same_v<T, uint8_t> || std::is_same_v<T, bool>;
+
+template <typename T> void WriteValue(PayloadWriter& out, const T& value, size_t maxLength)
+{
+	if constexpr (std::is_same_v<T, std::string_view>) {
+		size_t length = std::min(value.size(), maxLength);
+		out.WriteVarint(length);
+		out.WriteBytes(value.data(), length);
+	} else if constexpr (IsRepeated<T>::value) {
+		size_t count = std::min(value.Size(), maxLength);
+		out.WriteVarint(count);
+		size_t written = 0;
+		value.ForEach([&](const auto& entry) {
+			if (written++ < count) {
+				WriteFields(out, entry);
+			}
+		});
+	} else if constexpr (std::is_enum_v<T>) {
+		static_assert(sizeof(T) == 1, "Enum fields are encoded as one byte");
+		out.WriteByte(static_cast<uint8_t>(value));
+	} else if constexpr (IS_BYTE<T>) {
+		out.WriteByte(static_cast<uint8_t>(value));
+	} else if constexpr (std::is_same_v<T, float>) {
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		out.WriteFixed32(bits);
+	} else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+		out.WriteVarint(value);
+	} else if constexpr (std::is_integral_v<T>) {
+		// ZigZag keeps small negative numbers short
+		int64_t wide = value;
+		out.WriteVarint((static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+	} else {
+		static_assert(!sizeof(T), "No wire encoding for this field type");
+	}
+}
+
+template <typename T> bool ReadValue(PayloadReader& in, T& value, size_t maxLength)
+{
+	if constexpr (std::is_same_v<T, std::string_view>) {
+		uint64_t length;
+		const uint8_t* bytes;
+		if (!in.ReadVarint(length) || length > maxLength || !in.ReadView(length, bytes)) {
+			return false;
+		}
+		value = std::string_view(reinterpret_cast<const char*>(bytes), length);
+		return true;
+	} else if constexpr (IsRepeated<T>::value) {
+		uint64_t count;
+		if (!in.ReadVarint(count) || count > maxLength) {
+			return false;
+		}
+		// Checked here, so ForEach can decode them later without failing
+		const uint8_t* start = in.Current();
+		size_t startPos = in.Position();
+		for (uint64_t i = 0; i < count; i++) {
+			typename T::EntryType entry {};
+			if (!ReadFields(in, entry)) {
+				return false;
+			}
+		}
+		value = T::FromPayload(start, in.Position() - startPos, count);
+		return true;
+	} else if constexpr (std::is_enum_v<T> || IS_BYTE<T>) {
+		uint8_t byte;
+		if (!in.ReadByte(byte)) {
+			return false;
+		}
+		if constexpr (std::is_same_v<T, bool>) {
+			value = byte != 0;
+		} else {
+			value = static_cast<T>(byte);
+		}
+		return true;
+	} else if constexpr (std::is_same_v<T, float>) {
+		uint32_t bits;
+		if (!in.ReadFixed32(bits)) {
+			return false;
+		}
+		memcpy(&value, &bits, sizeof(value));
+		return true;
+	} else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+		uint64_t wide;
+		if (!in.ReadVarint(wide) || wide > std::numeric_limits<T>::max()) {
+			return false;
+		}
+		value = static_cast<T>(wide);
+		return true;
+	} else if constexpr (std::is_integral_v<T>) {
+		uint64_t encoded;
+		if (!in.ReadVarint(encoded)) {
+			return false;
+		}
+		int64_t wide = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+		if (wide < std::numeric_limits<T>::min() || wide > std::numeric_limits<T>::max()) {
+			return false;
+		}
+		value = static_cast<T>(wide);
+		return true;
+	} else {
+		static_assert(!sizeof(T), "No wire encoding for this field type");
+	}
+}
+
+template <typename Msg> void WriteFields(PayloadWriter& out, const Msg& msg)
+{
+	std::apply([&](const auto&... fields) { (WriteValue(out, msg.*(fields.member), fields.maxLength), ...); },
+			   Msg::Fields());
+}
+
+template <typename Msg> bool ReadFields(PayloadReader& in, Msg& msg)
+{
+	return std::apply(
+		[&](const auto&... fields) { return (ReadValue(in, msg.*(fields.member), fields.maxLength) && ...); },
+		Msg::Fields());
+}
+
+} // namespace Codec
+
+// ============================================================================
+// Messages
+// ============================================================================
+
+// Replaces out with the encoded message; returns its length
+template <typename Msg> size_t EncodeMessage(const Msg& msg, std::vector<uint8_t>& out)
+{
+	out.clear();
+	PayloadWriter writer(out);
+	Codec::WriteFields(writer, msg);
+	return out.size();
+}
+
+// False if the payload is cut short or a field is out of range (msg is then
+// partly filled). Strings and lists in msg point into data.
+template <typename Msg> bool DecodeMessage(const uint8_t* data, size_t length, Msg& msg)
+{
+	PayloadReader reader(data, length);
+	return Codec::ReadFields(reader, msg);
+}
+
+} // namespace Net
@@ -0,0 +1,151 @@
+/*
+ * Cybrelink Packet Compression Implementation
+ */
+
+#include "packetcompressor.h"
+#include "worlddictionary.h"
+
+#include <zstd.h>
+
+#include <utility>
+
+namespace Net {
+
+// Dictionaries are immutable once built and shared by every connection
+static ZSTD_CDict* GetCompressionDictionary()
+{
+	static ZSTD_CDict* dict = ZSTD_createCDict(WORLD_DICTIONARY, WORLD_DICTIONARY_SIZE, COMPRESSION_LEVEL);
+	return dict;
+}
+
+static ZSTD_DDict* GetDecompressionDictionary()
+{
+	static ZSTD_DDict* dict = ZSTD_createDDict(WORLD_DICTIONARY, WORLD_DICTIONARY_SIZE);
+	return dict;
+}
+
+// Largest payload a 16-bit PacketHeader::length can carry
+static const size_t MAX_PAYLOAD = 0xFFFF;
+
+// ============================================================================
+// PacketCompressor
+// ============================================================================
+
+PacketCompressor::PacketCompressor() : m_ctx(nullptr) { }
+
+PacketCompressor::~PacketCompressor() { ZSTD_freeCCtx(m_ctx); }
+
+PacketCompressor::PacketCompressor(PacketCompressor&& other) noexcept : m_ctx(other.m_ctx)
+{
+	other.m_ctx = nullptr;
+}
+
+PacketCompressor& PacketCompressor::operator=(PacketCompressor&& other) noexcept
+{
+	std::swap(m_ctx, other.m_ctx);
+	return *this;
+}
+
+bool PacketCompressor::ShouldCompress(size_t len)
+{
+	return len >= COMPRESSION_THRESHOLD && MaxCompressedSize(len) <= MAX_PAYLOAD;
+}
+
+size_t PacketCompressor::MaxCompressedSize(size_t len) { return ZSTD_compressBound(len); }
+
+size_t PacketCompressor::Compress(const void* payload, size_t len, uint8_t* out, size_t outCapacity)
+{
+	// Context is created lazily so idle connections cost nothing
+	if (!m_ctx) {
+		m_ctx = ZSTD_createCCtx();
+		if (!m_ctx) {
+			return 0;
+		}
+		ZSTD_CCtx_refCDict(m_ctx, GetCompressionDictionary());
+		ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_windowLog, COMPRESSION_WINDOW_LOG);
+	}
+
+	ZSTD_inBuffer input = { payload, len, 0 };
+	ZSTD_outBuffer output = { out, outCapacity, 0 };
+
+	// Flush (not end) so the block is decodable now but the frame stays open
+	size_t remaining;
+	do {
+		remaining = ZSTD_compressStream2(m_ctx, &output, &input, ZSTD_e_flush);
+		if (ZSTD_isError(remaining)) {
+			return 0;
+		}
+	} while (remaining != 0 && output.pos < output.size);
+
+	if (remaining != 0) {
+		return 0; // Output buffer too small
+	}
+
+	return output.pos;
+}
+
+void PacketCompressor::Reset()
+{
+	if (m_ctx) {
+		ZSTD_CCtx_reset(m_ctx, ZSTD_reset_session_only);
+	}
+}
+
+// ============================================================================
+// PacketDecompressor
+// ============================================================================
+
+PacketDecompressor::PacketDecompressor() : m_ctx(nullptr) { }
+
+PacketDecompressor::~PacketDecompressor() { ZSTD_freeDCtx(m_ctx); }
+
+PacketDecompressor::PacketDecompressor(PacketDecompressor&& other) noexcept :
+	m_ctx(other.m_ctx),
+	m_output(std::move(other.m_output))
+{
+	other.m_ctx = nullptr;
+}
+
+PacketDecompressor& PacketDecompressor::operator=(PacketDecompressor&& other) noexcept
+{
+	std::swap(m_ctx, other.m_ctx);
+	std::swap(m_output, other.m_output);
+	return *this;
+}
+
+bool PacketDecompressor::Decompress(const uint8_t* data, size_t len, const uint8_t*& out, size_t& outLen)
+{
+	if (!m_ctx) {
+		m_ctx = ZSTD_createDCtx();
+		if (!m_ctx) {
+			return false;
+		}
+		ZSTD_DCtx_refDDict(m_ctx, GetDecompressionDictionary());
+	}
+
+	// One spare byte: a completely full buffer means the payload was oversized
+	m_output.resize(MAX_PAYLOAD + 1);
+
+	ZSTD_inBuffer input = { data, len, 0 };
+	ZSTD_outBuffer output = { m_output.data(), m_output.size(), 0 };
+
+	while (input.pos < input.size) {
+		size_t ret = ZSTD_decompressStream(m_ctx, &output, &input);
+		if (ZSTD_isError(ret) || output.pos == output.size) {
+			return false;
+		}
+	}
+
+	out = m_output.data();
+	outLen = output.pos;
+	return true;
+}
+
+void PacketDecompressor::Reset()
+{
+	if (m_ctx) {
+		ZSTD_DCtx_reset(m_ctx, ZSTD_reset_session_only);
+	}
+}
+
+} // namespace Net
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ * Cybrelink Packet Compression
+ * Per-connection zstd streams for FLAG_COMPRESSED payloads
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+namespace Net {
+
+// Payloads smaller than this are sent raw - the frame overhead isn't worth it
+constexpr size_t COMPRESSION_THRESHOLD = 128;
+
+constexpr int COMPRESSION_LEVEL = 3;
+
+// Sender match window. Bounds per-connection compressor memory on the server.
+constexpr int COMPRESSION_WINDOW_LOG = 17; // 128 KiB
+
+// ============================================================================
+// Packet Compressor (sender side, one per connection)
+// ============================================================================
+
+// Each connection carries one never-ending zstd frame. Every compressed
+// payload is a flushed block of that frame, so later packets can reference
+// earlier ones (the same computer names and IPs repeat from tick to tick).
+// TCP delivers blocks in order, which is all the matching decompressor needs.
+//
+// Because the stream history advances as soon as input is consumed, a payload
+// handed to Compress() must be sent compressed. Check ShouldCompress() first.
+
+class PacketCompressor {
+public:
+	PacketCompressor();
+	~PacketCompressor();
+
+	PacketCompressor(const PacketCompressor&) = delete;
+	PacketCompressor& operator=(const PacketCompressor&) = delete;
+	PacketCompressor(PacketCompressor&& other) noexcept;
+	PacketCompressor& operator=(PacketCompressor&& other) noexcept;
+
+	// True if len is above the threshold and its worst case still fits a 16-bit packet
+	static bool ShouldCompress(size_t len);
+
+	// Worst-case compressed size for len bytes of input
+	static size_t MaxCompressedSize(size_t len);
+
+	// Compress payload into out (capacity >= MaxCompressedSize(len))
+	// Returns compressed size, or 0 on error (the stream is unusable afterwards)
+	size_t Compress(const void* payload, size_t len, uint8_t* out, size_t outCapacity);
+
+	// Start a fresh stream (new connection)
+	void Reset();
+
+private:
+	ZSTD_CCtx_s* m_ctx;
+};
+
+// ============================================================================
+// Packet Decompressor (receiver side, one per connection)
+// ============================================================================
+
+class PacketDecompressor {
+public:
+	PacketDecompressor();
+	~PacketDecompressor();
+
+	PacketDecompressor(const PacketDecompressor&) = delete;
+	PacketDecompressor& operator=(const PacketDecompressor&) = delete;
+	PacketDecompressor(PacketDecompressor&& other) noexcept;
+	PacketDecompressor& operator=(PacketDecompressor&& other) noexcept;
+
+	// Decompress one FLAG_COMPRESSED payload. On success out/outLen point into an
+	// internal buffer that stays valid until the next call.
+	bool Decompress(const uint8_t* data, size_t len, const uint8_t*& out, size_t& outLen);
+
+	// Start a fresh stream (new connection)
+	void Reset();
+
+private:
+	ZSTD_DCtx_s* m_ctx;
+	std::vector<uint8_t> m_output;
+};
+
+} // namespace Net
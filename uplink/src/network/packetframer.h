@@ -0,0 +1,154 @@
+#pragma once
+
+/*
+ * Cybrelink Packet Framer
+ * Reassembles a TCP byte stream into complete protocol packets
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "network/protocol.h"
+
+namespace Net {
+
+// ============================================================================
+// Packet View
+// ============================================================================
+
+// A complete packet still sitting in the framer's buffer.
+// payload is only valid until the next PacketFramer::WriteBegin() or Clear().
+struct PacketView {
+	PacketHeader header;
+	const uint8_t* payload;
+	size_t length; // == header.length
+};
+
+// ============================================================================
+// Packet Framer
+// ============================================================================
+
+// Receive buffer with read/write cursors. Sockets recv straight into
+// WriteBegin(), and Next() hands out packets in place without copying.
+// Consumed bytes are reclaimed lazily: the unread tail (at most one partial
+// packet) is moved to the front only when the free space runs low or the
+// pending packet would not fit, so the cost per byte is O(1) no matter how
+// many packets arrive in one read.
+
+class PacketFramer {
+public:
+	// Largest packet the 16-bit PacketHeader::length can describe
+	static constexpr size_t MAX_PACKET_SIZE = sizeof(PacketHeader) + 0xFFFF;
+
+	// Minimum free space offered to a recv before the buffer is compacted
+	static constexpr size_t RECV_CHUNK = 4096;
+
+	explicit PacketFramer(size_t capacity = MAX_PACKET_SIZE + RECV_CHUNK) :
+		m_buffer(capacity < MAX_PACKET_SIZE ? MAX_PACKET_SIZE : capacity),
+		m_readPos(0),
+		m_writePos(0)
+	{
+	}
+
+	// ---- Writing (socket -> framer) ----
+
+	// Pointer to contiguous free space for the next recv
+	uint8_t* WriteBegin()
+	{
+		if (m_readPos == m_writePos) {
+			m_readPos = m_writePos = 0;
+		} else if (m_readPos > 0 &&
+				   (WriteSpace() < RECV_CHUNK || m_readPos + PendingPacketSize() > m_buffer.size())) {
+			Compact();
+		}
+		return m_buffer.data() + m_writePos;
+	}
+
+	size_t WriteSpace() const { return m_buffer.size() - m_writePos; }
+
+	// Mark len bytes written at WriteBegin() as received
+	void CommitWrite(size_t len)
+	{
+		m_writePos += len;
+		if (m_writePos > m_buffer.size()) {
+			m_writePos = m_buffer.size();
+		}
+	}
+
+	// Copy bytes in (for callers that don't recv directly into the framer)
+	bool Append(const void* data, size_t len)
+	{
+		WriteBegin();
+		if (len > WriteSpace()) {
+			return false;
+		}
+		memcpy(m_buffer.data() + m_writePos, data, len);
+		m_writePos += len;
+		return true;
+	}
+
+	// ---- Reading (framer -> dispatch) ----
+
+	// Look at the next complete packet without consuming it
+	bool Peek(PacketView& out) const
+	{
+		size_t available = m_writePos - m_readPos;
+		if (available < sizeof(PacketHeader)) {
+			return false;
+		}
+
+		const uint8_t* start = m_buffer.data() + m_readPos;
+		memcpy(&out.header, start, sizeof(PacketHeader));
+
+		if (available < sizeof(PacketHeader) + out.header.length) {
+			return false; // Wait for more data
+		}
+
+		out.payload = start + sizeof(PacketHeader);
+		out.length = out.header.length;
+		return true;
+	}
+
+	// Pop the next complete packet. Returns false if only a partial packet is buffered.
+	bool Next(PacketView& out)
+	{
+		if (!Peek(out)) {
+			return false;
+		}
+
+		m_readPos += sizeof(PacketHeader) + out.length;
+		return true;
+	}
+
+	// Bytes received but not yet returned by Next()
+	size_t Buffered() const { return m_writePos - m_readPos; }
+
+	void Clear() { m_readPos = m_writePos = 0; }
+
+private:
+	// Full size of the packet at the read cursor (header only if it isn't complete yet)
+	size_t PendingPacketSize() const
+	{
+		if (m_writePos - m_readPos < sizeof(PacketHeader)) {
+			return sizeof(PacketHeader);
+		}
+		PacketHeader header;
+		memcpy(&header, m_buffer.data() + m_readPos, sizeof(PacketHeader));
+		return sizeof(PacketHeader) + header.length;
+	}
+
+	void Compact()
+	{
+		size_t remaining = m_writePos - m_readPos;
+		memmove(m_buffer.data(), m_buffer.data() + m_readPos, remaining);
+		m_readPos = 0;
+		m_writePos = remaining;
+	}
+
+	std::vector<uint8_t> m_buffer;
+	size_t m_readPos;
+	size_t m_writePos;
+};
+
+} // namespace Net
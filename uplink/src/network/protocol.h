@@ -8,6 +8,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "network/packetcodec.h"
+
 namespace Net {
 
 // ============================================================================
@@ -34,6 +36,7 @@ enum class PacketType : uint8_t {
 	HANDSHAKE_ACK = 0x02,
 	DISCONNECT = 0x03,
 	KEEPALIVE = 0x04,
+	ACK = 0x05, // Cumulative acknowledgement of FLAG_RELIABLE packets (AckPacket)
 
 	// Authentication
 	AUTH_REQUEST = 0x10,
@@ -71,11 +74,15 @@ enum class PacketType : uint8_t {
 enum PacketFlags : uint8_t {
 	FLAG_NONE = 0x00,
 	FLAG_COMPRESSED = 0x01, // Payload is zstd compressed
-	FLAG_RELIABLE = 0x02, // Requires acknowledgment
+	FLAG_RELIABLE = 0x02, // Sequenced, acknowledged and resent after a reconnect (see reliablechannel.h)
 	FLAG_FRAGMENTED = 0x04, // Part of larger message
 	FLAG_LAST_FRAGMENT = 0x08, // Last fragment of message
 };
 
+// Messages larger than this are split into FLAG_FRAGMENTED packets; the last one
+// also carries FLAG_LAST_FRAGMENT. Receivers concatenate payloads before parsing.
+constexpr uint16_t MAX_FRAGMENT_PAYLOAD = 16 * 1024;
+
 // ============================================================================
 // Player Actions (for PLAYER_ACTION packet)
 // ============================================================================
@@ -149,55 +156,157 @@ inline bool ReadPacketHeader(const uint8_t* buffer, size_t bufferLen, PacketHead
 inline const uint8_t* GetPayload(const uint8_t* packet) { return packet + sizeof(PacketHeader); }
 
 // ============================================================================
-// Common Packet Structures
+// Messages
 // ============================================================================
 
-#pragma pack(push, 1)
+// Payloads of the fixed-shape packet types, encoded through their Fields()
+// tables (see packetcodec.h). String members are views: into the payload when
+// decoded, into the caller's own storage when encoding.
+
+constexpr size_t MAX_HANDLE_LENGTH = 32;
+constexpr size_t MAX_AUTH_TOKEN_LENGTH = 4096; // Supabase JWTs run well past 512 bytes
+constexpr size_t MAX_CHANNEL_LENGTH = 16; // "global", "team", "whisper"
+constexpr size_t MAX_CHAT_LENGTH = 256;
+constexpr size_t MAX_ACTION_DATA_LENGTH = 64;
+constexpr size_t MAX_PLAYER_LIST_ENTRIES = 1024; // Keeps a PLAYER_LIST inside one packet
 
 struct HandshakePacket {
-	uint32_t protocolVersion;
-	uint32_t clientVersion;
-	char handle[32];
-	char authToken[512]; // Supabase JWT can be long
+	// First on the wire: an old fixed-layout handshake's little endian version
+	// still decodes as its version number, so it is rejected as a mismatch
+	uint32_t protocolVersion = 0;
+	uint32_t clientVersion = 0;
+	std::string_view handle;
+	std::string_view authToken;
+	uint64_t resumeSession = 0; // From the last HANDSHAKE_ACK, 0 = new session
+	uint32_t resumeReceived = 0; // Last reliable sequence received in that session
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&HandshakePacket::protocolVersion),
+							   Field(&HandshakePacket::clientVersion),
+							   Field(&HandshakePacket::handle, MAX_HANDLE_LENGTH),
+							   Field(&HandshakePacket::authToken, MAX_AUTH_TOKEN_LENGTH),
+							   Field(&HandshakePacket::resumeSession),
+							   Field(&HandshakePacket::resumeReceived));
+	}
+};
+
+struct HandshakeAckPacket {
+	uint32_t playerId = 0;
+	uint64_t session = 0; // Token for resuming this session after a dropped connection
+	uint32_t received = 0; // Resumed: last reliable sequence the server has; resend everything after it
+	bool resumed = false; // False = new session - drop any state kept from the last one
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&HandshakeAckPacket::playerId),
+							   Field(&HandshakeAckPacket::session),
+							   Field(&HandshakeAckPacket::received),
+							   Field(&HandshakeAckPacket::resumed));
+	}
+};
+
+struct AckPacket {
+	uint32_t sequence = 0; // Every reliable packet up to and including this one was handled
+
+	static constexpr auto Fields() { return std::make_tuple(Field(&AckPacket::sequence)); }
 };
 
 struct ActionPacket {
-	ActionType actionType;
-	uint32_t targetId;
-	uint32_t param1;
-	uint32_t param2;
-	char data[64]; // Variable data depending on action
+	ActionType actionType = ActionType::NONE;
+	uint32_t targetId = 0;
+	uint32_t param1 = 0;
+	uint32_t param2 = 0;
+	std::string_view data; // Depends on the action, e.g. an IP for ADD_BOUNCE
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&ActionPacket::actionType),
+							   Field(&ActionPacket::targetId),
+							   Field(&ActionPacket::param1),
+							   Field(&ActionPacket::param2),
+							   Field(&ActionPacket::data, MAX_ACTION_DATA_LENGTH));
+	}
 };
 
 struct TimeSyncPacket {
-	int second;
-	int minute;
-	int hour;
-	int day;
-	int month;
-	int year;
-	bool paused; // Is the server paused?
-	float gameSpeed; // Server game speed multiplier
+	int32_t second = 0;
+	int32_t minute = 0;
+	int32_t hour = 0;
+	int32_t day = 0;
+	int32_t month = 0;
+	int32_t year = 0;
+	bool paused = false; // Is the server paused?
+	float gameSpeed = 1.0f; // Server game speed multiplier
+	uint16_t millisecond = 0; // Sub-second part of the game time above
+	uint32_t serverTimeMs = 0; // Server steady clock when sent, for the client's delay filter
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&TimeSyncPacket::second),
+							   Field(&TimeSyncPacket::minute),
+							   Field(&TimeSyncPacket::hour),
+							   Field(&TimeSyncPacket::day),
+							   Field(&TimeSyncPacket::month),
+							   Field(&TimeSyncPacket::year),
+							   Field(&TimeSyncPacket::paused),
+							   Field(&TimeSyncPacket::gameSpeed),
+							   Field(&TimeSyncPacket::millisecond),
+							   Field(&TimeSyncPacket::serverTimeMs));
+	}
+};
+
+struct TraceUpdatePacket {
+	bool active = false; // False once the trace has stopped
+	uint8_t totalLinks = 0; // Links between the player and the traced computer
+	float progress = 0.0f; // Links traced so far (fractional)
+	float linksPerSecond = 0.0f; // Current trace speed, for prediction until the next update
+	uint32_t serverTimeMs = 0; // Server steady clock when sent
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&TraceUpdatePacket::active),
+							   Field(&TraceUpdatePacket::totalLinks),
+							   Field(&TraceUpdatePacket::progress),
+							   Field(&TraceUpdatePacket::linksPerSecond),
+							   Field(&TraceUpdatePacket::serverTimeMs));
+	}
 };
 
 struct ChatPacket {
-	char sender[32]; // Player handle who sent the message
-	char channel[16]; // "global", "team", "whisper"
-	char message[256]; // Chat message content
+	std::string_view sender; // Player handle (set by the server; ignored from clients)
+	std::string_view channel;
+	std::string_view message;
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&ChatPacket::sender, MAX_HANDLE_LENGTH),
+							   Field(&ChatPacket::channel, MAX_CHANNEL_LENGTH),
+							   Field(&ChatPacket::message, MAX_CHAT_LENGTH));
+	}
 };
 
 struct PlayerListEntry {
-	uint32_t playerId;
-	char handle[32];
-	int16_t rating; // Uplink rating
+	uint32_t playerId = 0;
+	std::string_view handle;
+	int16_t rating = 0; // Uplink rating
+
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&PlayerListEntry::playerId),
+							   Field(&PlayerListEntry::handle, MAX_HANDLE_LENGTH),
+							   Field(&PlayerListEntry::rating));
+	}
 };
 
 struct PlayerListPacket {
-	uint8_t playerCount;
-	PlayerListEntry players[32]; // Max 32 players
-};
+	RepeatedView<PlayerListEntry> players;
 
-#pragma pack(pop)
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(Field(&PlayerListPacket::players, MAX_PLAYER_LIST_ENTRIES));
+	}
+};
 
 // Note: Network constants (DEFAULT_PORT, PROTOCOL_VERSION, TICK_RATE_HZ, etc.)
 // are defined in network_sdl.h which should be included before this header
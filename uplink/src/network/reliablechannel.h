@@ -0,0 +1,170 @@
+#pragma once
+
+/*
+ * Cybrelink Reliable Channel
+ * Sequence numbers, cumulative ACKs and resend for FLAG_RELIABLE packets
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "network/protocol.h"
+
+namespace Net {
+
+// ============================================================================
+// Sequence Numbers
+// ============================================================================
+
+// Sequences start at 1 in each session (0 = nothing yet) and compare modulo 2^32
+inline bool SequenceAfter(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+
+// A FLAG_RELIABLE payload is the sender's sequence number followed by the
+// message body. The sequence is never compressed: FLAG_COMPRESSED covers the
+// body only, so a receiver can read it before inflating.
+constexpr size_t RELIABLE_PREFIX_SIZE = sizeof(uint32_t);
+
+inline uint32_t ReadSequence(const uint8_t* payload)
+{
+	uint32_t sequence;
+	memcpy(&sequence, payload, sizeof(sequence));
+	return sequence;
+}
+
+inline void WriteSequence(uint8_t* payload, uint32_t sequence)
+{
+	memcpy(payload, &sequence, sizeof(sequence));
+}
+
+// ============================================================================
+// Reliable Sender
+// ============================================================================
+
+// Numbers outgoing reliable packets and keeps their bodies (uncompressed,
+// without the sequence prefix) until the peer acknowledges them. TCP already
+// delivers in order within a connection; the copies are for the connection
+// after it, where everything unacknowledged is sent again.
+// Bodies share one buffer, so steady state doesn't allocate.
+
+class ReliableSender {
+public:
+	ReliableSender() : m_nextSequence(1) { }
+
+	void Reset()
+	{
+		m_nextSequence = 1;
+		m_packets.clear();
+		m_bodies.clear();
+	}
+
+	// Assigns the next sequence and keeps a copy of the body
+	uint32_t Retain(PacketType type, uint8_t flags, const void* body, size_t length)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(body);
+		m_packets.push_back({ m_nextSequence, static_cast<uint8_t>(type), flags, length });
+		m_bodies.insert(m_bodies.end(), bytes, bytes + length);
+		return m_nextSequence++;
+	}
+
+	// Cumulative: the peer has everything up to and including sequence
+	void Acknowledge(uint32_t sequence)
+	{
+		size_t released = 0;
+		while (!m_packets.empty() && !SequenceAfter(m_packets.front().sequence, sequence)) {
+			released += m_packets.front().length;
+			m_packets.pop_front();
+		}
+		if (released > 0) {
+			m_bodies.erase(m_bodies.begin(), m_bodies.begin() + released);
+		}
+	}
+
+	// Unacknowledged packets in sequence order:
+	// fn(uint32_t sequence, PacketType type, uint8_t flags, const uint8_t* body, size_t length)
+	template <typename Fn> void ForEachUnacked(Fn&& fn) const
+	{
+		size_t offset = 0;
+		for (const RetainedPacket& packet : m_packets) {
+			fn(packet.sequence,
+			   static_cast<PacketType>(packet.type),
+			   packet.flags,
+			   m_bodies.data() + offset,
+			   packet.length);
+			offset += packet.length;
+		}
+	}
+
+	size_t GetUnackedCount() const { return m_packets.size(); }
+	size_t GetUnackedBytes() const { return m_bodies.size(); }
+
+private:
+	struct RetainedPacket {
+		uint32_t sequence;
+		uint8_t type;
+		uint8_t flags; // As sent, minus FLAG_COMPRESSED
+		size_t length;
+	};
+
+	uint32_t m_nextSequence;
+	std::deque<RetainedPacket> m_packets;
+	std::vector<uint8_t> m_bodies; // Every retained body, oldest first
+};
+
+// ============================================================================
+// Reliable Receiver
+// ============================================================================
+
+// Tracks the last reliable sequence handled, to drop the copies a peer sends
+// again after a reconnect and to know what to acknowledge.
+
+class ReliableReceiver {
+public:
+	enum class Result {
+		DELIVER, // Next in sequence - handle it
+		DUPLICATE, // Already handled before a reconnect - drop it
+		GAP, // Something in between was lost - the stream can't be trusted
+	};
+
+	ReliableReceiver() : m_received(0), m_acknowledged(0) { }
+
+	void Reset() { m_received = m_acknowledged = 0; }
+
+	Result Accept(uint32_t sequence)
+	{
+		if (!SequenceAfter(sequence, m_received)) {
+			return Result::DUPLICATE;
+		}
+		if (sequence != m_received + 1) {
+			return Result::GAP;
+		}
+		m_received = sequence;
+		return Result::DELIVER;
+	}
+
+	// Forget everything after sequence, so the peer's resend delivers it again
+	void Rewind(uint32_t sequence)
+	{
+		m_received = sequence;
+		m_acknowledged = sequence;
+	}
+
+	uint32_t GetReceived() const { return m_received; }
+
+	// True (once per change) when an ACK up to sequence should go out
+	bool TakeAck(uint32_t sequence)
+	{
+		if (sequence == m_acknowledged) {
+			return false;
+		}
+		m_acknowledged = sequence;
+		return true;
+	}
+
+private:
+	uint32_t m_received;
+	uint32_t m_acknowledged; // Last sequence sent in an ACK
+};
+
+} // namespace Net
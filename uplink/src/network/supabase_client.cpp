@@ -3,6 +3,7 @@
 #include <cpr/cpr.h>
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <utility>
 
 using json = nlohmann::json;
 
@@ -14,12 +15,38 @@ SupabaseClient& SupabaseClient::Instance()
 	return instance;
 }
 
+SupabaseClient::~SupabaseClient() { StopWorkers(); }
+
 void SupabaseClient::Init(const std::string& url, const std::string& anonKey)
 {
 	m_url = url;
 	m_anonKey = anonKey;
 }
 
+void SupabaseClient::SetAuthToken(const std::string& token)
+{
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	m_authToken = token;
+}
+
+std::string SupabaseClient::GetAuthToken() const
+{
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	return m_authToken;
+}
+
+std::string SupabaseClient::GetLastError() const
+{
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	return m_lastError;
+}
+
+void SupabaseClient::SetLastError(const std::string& error)
+{
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	m_lastError = error;
+}
+
 std::string SupabaseClient::Login(const std::string& email, const std::string& password)
 {
 	std::string endpoint = m_url + "/auth/v1/token?grant_type=password";
@@ -88,7 +115,7 @@ SupabaseClient::SignUp(const std::string& email, const std::string& password, co
 			std::cerr << "[Supabase] SignUp JSON parse error: " << e.what() << std::endl;
 		}
 	} else {
-		m_lastError = "Status: " + std::to_string(r.status_code) + " - " + r.text;
+		SetLastError("Status: " + std::to_string(r.status_code) + " - " + r.text);
 		std::cerr << "[Supabase] SignUp failed: " << r.status_code << " " << r.text << std::endl;
 	}
 
@@ -97,7 +124,13 @@ SupabaseClient::SignUp(const std::string& email, const std::string& password, co
 
 std::optional<PlayerProfile> SupabaseClient::GetPlayerProfile(const std::string& authId)
 {
-	if (m_authToken.empty()) {
+	return GetPlayerProfile(authId, GetAuthToken());
+}
+
+std::optional<PlayerProfile>
+SupabaseClient::GetPlayerProfile(const std::string& authId, const std::string& authToken)
+{
+	if (authToken.empty()) {
 		std::cerr << "[Supabase] Cannot GetPlayerProfile: Not logged in" << std::endl;
 		return std::nullopt;
 	}
@@ -106,7 +139,7 @@ std::optional<PlayerProfile> SupabaseClient::GetPlayerProfile(const std::string&
 
 	cpr::Response r = cpr::Get(cpr::Url { endpoint },
 							   cpr::Header { { "apikey", m_anonKey },
-											 { "Authorization", "Bearer " + m_authToken },
+											 { "Authorization", "Bearer " + authToken },
 											 { "Content-Type", "application/json" } });
 
 	if (r.status_code == 200) {
@@ -134,6 +167,13 @@ std::optional<PlayerProfile> SupabaseClient::GetPlayerProfile(const std::string&
 }
 
 bool SupabaseClient::CreatePlayerProfile(const std::string& authId, const std::string& handle)
+{
+	return CreatePlayerProfile(authId, handle, GetAuthToken());
+}
+
+bool SupabaseClient::CreatePlayerProfile(const std::string& authId,
+										 const std::string& handle,
+										 const std::string& authToken)
 {
 	// Should be called if the trigger doesn't exist
 	std::string endpoint = m_url + "/rest/v1/players";
@@ -149,8 +189,8 @@ bool SupabaseClient::CreatePlayerProfile(const std::string& authId, const std::s
 							{ "Content-Type", "application/json" },
 							{ "Prefer", "return=minimal" } };
 
-	if (!m_authToken.empty()) {
-		headers.insert({ "Authorization", "Bearer " + m_authToken });
+	if (!authToken.empty()) {
+		headers.insert({ "Authorization", "Bearer " + authToken });
 	}
 
 	cpr::Response r = cpr::Post(cpr::Url { endpoint }, headers, cpr::Body { payload.dump() });
@@ -165,7 +205,8 @@ bool SupabaseClient::CreatePlayerProfile(const std::string& authId, const std::s
 
 bool SupabaseClient::UpdatePlayerProfile(const PlayerProfile& profile)
 {
-	if (m_authToken.empty() || profile.id == 0) {
+	std::string authToken = GetAuthToken();
+	if (authToken.empty() || profile.id == 0) {
 		return false;
 	}
 
@@ -177,7 +218,7 @@ bool SupabaseClient::UpdatePlayerProfile(const PlayerProfile& profile)
 
 	cpr::Response r = cpr::Patch(cpr::Url { endpoint },
 								 cpr::Header { { "apikey", m_anonKey },
-											   { "Authorization", "Bearer " + m_authToken },
+											   { "Authorization", "Bearer " + authToken },
 											   { "Content-Type", "application/json" } },
 								 cpr::Body { payload.dump() });
 
@@ -237,10 +278,11 @@ std::vector<Computer> SupabaseClient::GetAllComputers()
 
 	std::string endpoint = m_url + "/rest/v1/computers?select=*";
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Get(
 		cpr::Url { endpoint },
 		cpr::Header { { "apikey", m_anonKey },
-					  { "Authorization", "Bearer " + (m_authToken.empty() ? m_anonKey : m_authToken) } },
+					  { "Authorization", "Bearer " + (authToken.empty() ? m_anonKey : authToken) } },
 		cpr::VerifySsl { false },
 		cpr::Timeout { 5000 });
 
@@ -279,9 +321,10 @@ bool SupabaseClient::UpdateComputer(const Computer& computer)
 
 	json payload = { { "security_level", computer.security_level }, { "is_running", computer.is_running } };
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Patch(cpr::Url { endpoint },
 								 cpr::Header { { "apikey", m_anonKey },
-											   { "Authorization", "Bearer " + m_authToken },
+											   { "Authorization", "Bearer " + authToken },
 											   { "Content-Type", "application/json" },
 											   { "Prefer", "return=minimal" } },
 								 cpr::Body { payload.dump() },
@@ -304,10 +347,11 @@ std::vector<Mission> SupabaseClient::GetAllMissions()
 
 	std::string endpoint = m_url + "/rest/v1/missions?select=*";
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Get(
 		cpr::Url { endpoint },
 		cpr::Header { { "apikey", m_anonKey },
-					  { "Authorization", "Bearer " + (m_authToken.empty() ? m_anonKey : m_authToken) } },
+					  { "Authorization", "Bearer " + (authToken.empty() ? m_anonKey : authToken) } },
 		cpr::VerifySsl { false },
 		cpr::Timeout { 5000 });
 
@@ -347,10 +391,11 @@ std::vector<Mission> SupabaseClient::GetUnclaimedMissions()
 
 	std::string endpoint = m_url + "/rest/v1/missions?claimed_by=is.null&completed=eq.false";
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Get(
 		cpr::Url { endpoint },
 		cpr::Header { { "apikey", m_anonKey },
-					  { "Authorization", "Bearer " + (m_authToken.empty() ? m_anonKey : m_authToken) } },
+					  { "Authorization", "Bearer " + (authToken.empty() ? m_anonKey : authToken) } },
 		cpr::VerifySsl { false },
 		cpr::Timeout { 5000 });
 
@@ -390,9 +435,10 @@ bool SupabaseClient::UpdateMission(const Mission& mission)
 		payload["claimed_by"] = mission.claimed_by;
 	}
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Patch(cpr::Url { endpoint },
 								 cpr::Header { { "apikey", m_anonKey },
-											   { "Authorization", "Bearer " + m_authToken },
+											   { "Authorization", "Bearer " + authToken },
 											   { "Content-Type", "application/json" },
 											   { "Prefer", "return=minimal" } },
 								 cpr::Body { payload.dump() },
@@ -412,9 +458,10 @@ bool SupabaseClient::ClaimMission(int32_t missionId, int32_t playerId)
 
 	json payload = { { "claimed_by", playerId } };
 
+	std::string authToken = GetAuthToken();
 	cpr::Response r = cpr::Patch(cpr::Url { endpoint },
 								 cpr::Header { { "apikey", m_anonKey },
-											   { "Authorization", "Bearer " + m_authToken },
+											   { "Authorization", "Bearer " + authToken },
 											   { "Content-Type", "application/json" },
 											   { "Prefer", "return=minimal" } },
 								 cpr::Body { payload.dump() },
@@ -424,4 +471,369 @@ bool SupabaseClient::ClaimMission(int32_t missionId, int32_t playerId)
 	return r.status_code == 200 || r.status_code == 204;
 }
 
+// ============================================================================
+// World Persistence - Bank Accounts
+// ============================================================================
+
+std::vector<BankAccount> SupabaseClient::GetAllBankAccounts()
+{
+	std::vector<BankAccount> accounts;
+	if (m_url.empty()) {
+		return accounts;
+	}
+
+	std::string endpoint = m_url + "/rest/v1/bank_accounts?select=*";
+
+	std::string authToken = GetAuthToken();
+	cpr::Response r = cpr::Get(
+		cpr::Url { endpoint },
+		cpr::Header { { "apikey", m_anonKey },
+					  { "Authorization", "Bearer " + (authToken.empty() ? m_anonKey : authToken) } },
+		cpr::VerifySsl { false },
+		cpr::Timeout { 5000 });
+
+	if (r.status_code == 200) {
+		try {
+			auto j = json::parse(r.text);
+			for (const auto& item : j) {
+				BankAccount a;
+				a.id = item.value("id", 0);
+				a.bank_ip = item.value("bank_ip", 0LL);
+				a.account_number = item.value("account_number", "");
+				a.account_name = item.value("account_name", "");
+				a.balance = item.value("balance", 0);
+				a.owner_player_id = item.value("owner_player_id", 0);
+				a.regen_rate = item.value("regen_rate", 0);
+				accounts.push_back(a);
+			}
+			printf("[Supabase] Loaded %zu bank accounts\n", accounts.size());
+		} catch (const std::exception& e) {
+			std::cerr << "[Supabase] GetAllBankAccounts parse error: " << e.what() << std::endl;
+		}
+	} else {
+		std::cerr << "[Supabase] GetAllBankAccounts failed: " << r.status_code << std::endl;
+	}
+
+	return accounts;
+}
+
+// ============================================================================
+// World Persistence - Bulk Upserts
+// ============================================================================
+
+// POST an array of rows; PostgREST turns merge-duplicates into
+// INSERT ... ON CONFLICT (id) DO UPDATE, so a whole batch is one round-trip
+bool SupabaseClient::Upsert(const std::string& table, const std::string& rowsJson)
+{
+	if (m_url.empty()) {
+		return false;
+	}
+
+	std::string endpoint = m_url + "/rest/v1/" + table;
+
+	std::string authToken = GetAuthToken();
+	cpr::Response r = cpr::Post(
+		cpr::Url { endpoint },
+		cpr::Header { { "apikey", m_anonKey },
+					  { "Authorization", "Bearer " + (authToken.empty() ? m_anonKey : authToken) },
+					  { "Content-Type", "application/json" },
+					  { "Prefer", "resolution=merge-duplicates,return=minimal" } },
+		cpr::Body { rowsJson },
+		cpr::VerifySsl { false },
+		cpr::Timeout { 5000 });
+
+	if (r.status_code == 200 || r.status_code == 201 || r.status_code == 204) {
+		return true;
+	}
+
+	std::cerr << "[Supabase] Upsert " << table << " failed: " << r.status_code << " " << r.text << std::endl;
+	return false;
+}
+
+bool SupabaseClient::UpsertComputers(const std::vector<Computer>& computers)
+{
+	if (computers.empty()) {
+		return true;
+	}
+
+	// Only the columns the server changes at runtime
+	json rows = json::array();
+	for (const auto& c : computers) {
+		rows.push_back({ { "id", c.id },
+						 { "name", c.name },
+						 { "security_level", c.security_level },
+						 { "is_running", c.is_running } });
+	}
+	return Upsert("computers", rows.dump());
+}
+
+bool SupabaseClient::UpsertMissions(const std::vector<Mission>& missions)
+{
+	if (missions.empty()) {
+		return true;
+	}
+
+	json rows = json::array();
+	for (const auto& m : missions) {
+		json row = { { "id", m.id },
+					 { "mission_type", m.mission_type },
+					 { "target_ip", m.target_ip },
+					 { "description", m.description },
+					 { "payment", m.payment },
+					 { "difficulty", m.difficulty },
+					 { "completed", m.completed } };
+		row["claimed_by"] = m.claimed_by > 0 ? json(m.claimed_by) : json(nullptr);
+		rows.push_back(row);
+	}
+	return Upsert("missions", rows.dump());
+}
+
+bool SupabaseClient::UpsertBankAccounts(const std::vector<BankAccount>& accounts)
+{
+	if (accounts.empty()) {
+		return true;
+	}
+
+	json rows = json::array();
+	for (const auto& a : accounts) {
+		rows.push_back({ { "id", a.id },
+						 { "bank_ip", a.bank_ip },
+						 { "account_number", a.account_number },
+						 { "account_name", a.account_name },
+						 { "balance", a.balance },
+						 { "owner_player_id", a.owner_player_id },
+						 { "regen_rate", a.regen_rate } });
+	}
+	return Upsert("bank_accounts", rows.dump());
+}
+
+// ============================================================================
+// Worker Pool
+// ============================================================================
+
+void SupabaseClient::StartWorkers(int count)
+{
+	std::lock_guard<std::mutex> lock(m_jobMutex);
+	StartWorkersLocked(count);
+}
+
+void SupabaseClient::StartWorkersLocked(int count)
+{
+	if (!m_workers.empty()) {
+		return;
+	}
+
+	m_stopping = false;
+	for (int i = 0; i < (count > 0 ? count : 1); i++) {
+		m_workers.emplace_back(&SupabaseClient::WorkerLoop, this, static_cast<size_t>(i));
+	}
+}
+
+void SupabaseClient::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		if (m_workers.empty()) {
+			return;
+		}
+		m_stopping = true;
+	}
+	m_jobReady.notify_all();
+
+	for (auto& worker : m_workers) {
+		worker.join();
+	}
+	m_workers.clear();
+}
+
+void SupabaseClient::WorkerLoop(size_t index)
+{
+	// Worker 0 owns the write lane so writes to the same row can't overtake each other
+	bool writer = index == 0;
+
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_jobReady.wait(lock, [&] {
+				return m_stopping || !m_jobs.empty() || (writer && !m_orderedJobs.empty());
+			});
+
+			if (writer && !m_orderedJobs.empty()) {
+				job = std::move(m_orderedJobs.front());
+				m_orderedJobs.pop_front();
+			} else if (!m_jobs.empty()) {
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			} else {
+				return; // Stopping and drained
+			}
+		}
+		job();
+	}
+}
+
+template <typename T>
+void SupabaseClient::Submit(const std::string& coalesceKey,
+							std::function<T()> work,
+							SupabaseCallback<T> done,
+							bool ordered)
+{
+	struct Waiter {
+		std::thread::id owner; // Thread whose PollCompletions runs the callback
+		SupabaseCallback<T> callback;
+	};
+	struct Waiters {
+		std::vector<Waiter> callbacks;
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+
+		if (!coalesceKey.empty()) {
+			auto it = m_inFlight.find(coalesceKey);
+			if (it != m_inFlight.end()) {
+				// Same request already queued or running - share its result
+				if (done) {
+					static_cast<Waiters*>(it->second.get())
+						->callbacks.push_back({ std::this_thread::get_id(), std::move(done) });
+				}
+				return;
+			}
+		}
+
+		auto waiters = std::make_shared<Waiters>();
+		if (done) {
+			waiters->callbacks.push_back({ std::this_thread::get_id(), std::move(done) });
+		}
+		if (!coalesceKey.empty()) {
+			m_inFlight[coalesceKey] = waiters;
+		}
+
+		auto job = [this, coalesceKey, work = std::move(work), waiters]() {
+			T result = work();
+
+			// Once the key is gone nobody else can join, so the waiter list is final
+			{
+				std::lock_guard<std::mutex> lock(m_jobMutex);
+				if (!coalesceKey.empty()) {
+					m_inFlight.erase(coalesceKey);
+				}
+			}
+
+			if (waiters->callbacks.empty()) {
+				return;
+			}
+
+			auto shared = std::make_shared<const T>(std::move(result));
+			std::lock_guard<std::mutex> lock(m_completionMutex);
+			for (auto& waiter : waiters->callbacks) {
+				m_completions[waiter.owner].push_back(
+					[callback = std::move(waiter.callback), shared]() { callback(*shared); });
+			}
+		};
+
+		StartWorkersLocked(DEFAULT_WORKERS);
+		if (ordered) {
+			m_orderedJobs.push_back(std::move(job));
+		} else {
+			m_jobs.push_back(std::move(job));
+		}
+	}
+
+	// Only worker 0 takes writes, so wake everyone rather than risk waking a reader
+	if (ordered) {
+		m_jobReady.notify_all();
+	} else {
+		m_jobReady.notify_one();
+	}
+}
+
+size_t SupabaseClient::PollCompletions()
+{
+	std::vector<std::function<void()>> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_completionMutex);
+		auto it = m_completions.find(std::this_thread::get_id());
+		if (it != m_completions.end()) {
+			ready.swap(it->second);
+		}
+	}
+
+	for (auto& completion : ready) {
+		completion();
+	}
+	return ready.size();
+}
+
+// ============================================================================
+// Asynchronous API
+// ============================================================================
+
+void SupabaseClient::VerifyTokenAsync(const std::string& token, SupabaseCallback<std::string> done)
+{
+	Submit<std::string>("verify:" + token, [this, token]() { return VerifyToken(token); }, std::move(done));
+}
+
+void SupabaseClient::GetPlayerProfileAsync(const std::string& authId,
+										   const std::string& authToken,
+										   SupabaseCallback<std::optional<PlayerProfile>> done)
+{
+	Submit<std::optional<PlayerProfile>>(
+		"profile:" + authId,
+		[this, authId, authToken]() { return GetPlayerProfile(authId, authToken); },
+		std::move(done));
+}
+
+void SupabaseClient::CreatePlayerProfileAsync(const std::string& authId,
+											  const std::string& handle,
+											  const std::string& authToken,
+											  SupabaseCallback<bool> done)
+{
+	Submit<bool>(
+		"",
+		[this, authId, handle, authToken]() { return CreatePlayerProfile(authId, handle, authToken); },
+		std::move(done),
+		true);
+}
+
+void SupabaseClient::UpdatePlayerProfileAsync(const PlayerProfile& profile, SupabaseCallback<bool> done)
+{
+	Submit<bool>("", [this, profile]() { return UpdatePlayerProfile(profile); }, std::move(done), true);
+}
+
+void SupabaseClient::GetAllComputersAsync(SupabaseCallback<std::vector<Computer>> done)
+{
+	Submit<std::vector<Computer>>("computers", [this]() { return GetAllComputers(); }, std::move(done));
+}
+
+void SupabaseClient::UpdateComputerAsync(const Computer& computer, SupabaseCallback<bool> done)
+{
+	Submit<bool>("", [this, computer]() { return UpdateComputer(computer); }, std::move(done), true);
+}
+
+void SupabaseClient::GetAllMissionsAsync(SupabaseCallback<std::vector<Mission>> done)
+{
+	Submit<std::vector<Mission>>("missions", [this]() { return GetAllMissions(); }, std::move(done));
+}
+
+void SupabaseClient::GetUnclaimedMissionsAsync(SupabaseCallback<std::vector<Mission>> done)
+{
+	Submit<std::vector<Mission>>(
+		"missions:unclaimed", [this]() { return GetUnclaimedMissions(); }, std::move(done));
+}
+
+void SupabaseClient::UpdateMissionAsync(const Mission& mission, SupabaseCallback<bool> done)
+{
+	Submit<bool>("", [this, mission]() { return UpdateMission(mission); }, std::move(done), true);
+}
+
+void SupabaseClient::ClaimMissionAsync(int32_t missionId, int32_t playerId, SupabaseCallback<bool> done)
+{
+	Submit<bool>("",
+				 [this, missionId, playerId]() { return ClaimMission(missionId, playerId); },
+				 std::move(done),
+				 true);
+}
+
 } // namespace Net
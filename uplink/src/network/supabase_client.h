@@ -5,6 +5,12 @@
 #include <cstdint>
 #include <vector>
 #include <optional>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
 
 // Forward declarations
 // nlohmann::json is a typedef, do not forward declare as class
@@ -47,9 +53,33 @@ struct Mission {
 	bool completed;
 };
 
+struct BankAccount {
+	int32_t id;
+	int64_t bank_ip;
+	std::string account_number;
+	std::string account_name;
+	int32_t balance;
+	int32_t owner_player_id; // 0 = NPC/system
+	int32_t regen_rate;
+};
+
+// Completion callback for the asynchronous API
+template <typename T> using SupabaseCallback = std::function<void(const T&)>;
+
+// Every call below is a blocking HTTP round-trip (5 second timeout). Code on a
+// tick or UI thread should use the *Async variants instead: requests run on a
+// small worker pool and callbacks are queued until the thread that made the
+// request calls PollCompletions(), so they can touch that thread's state
+// without locking.
+//
+// Identical reads already in flight are coalesced into one HTTP request whose
+// result goes to every waiter. Writes are never coalesced and run in
+// submission order on a single worker.
+
 class SupabaseClient {
 public:
 	static SupabaseClient& Instance();
+	~SupabaseClient();
 
 	// Initialize with project URL and Anon Key
 	void Init(const std::string& url, const std::string& anonKey);
@@ -62,8 +92,13 @@ public:
 	std::string SignUp(const std::string& email, const std::string& password, const std::string& handle);
 
 	// Player Metadata
+	// The authToken overloads don't touch the shared token, so they are safe
+	// to call for several players at once
 	std::optional<PlayerProfile> GetPlayerProfile(const std::string& authId);
+	std::optional<PlayerProfile> GetPlayerProfile(const std::string& authId, const std::string& authToken);
 	bool CreatePlayerProfile(const std::string& authId, const std::string& handle);
+	bool
+	CreatePlayerProfile(const std::string& authId, const std::string& handle, const std::string& authToken);
 	bool UpdatePlayerProfile(const PlayerProfile& profile);
 
 	// World Persistence - Computers
@@ -76,24 +111,89 @@ public:
 	bool UpdateMission(const Mission& mission);
 	bool ClaimMission(int32_t missionId, int32_t playerId);
 
+	// World Persistence - Bank Accounts
+	std::vector<BankAccount> GetAllBankAccounts();
+
+	// World Persistence - bulk upserts (one request per table, rows merged on id)
+	bool UpsertComputers(const std::vector<Computer>& computers);
+	bool UpsertMissions(const std::vector<Mission>& missions);
+	bool UpsertBankAccounts(const std::vector<BankAccount>& accounts);
+
 	// Set the auth token for subsequent requests
-	void SetAuthToken(const std::string& token) { m_authToken = token; }
-	const std::string& GetAuthToken() const { return m_authToken; }
+	void SetAuthToken(const std::string& token);
+	std::string GetAuthToken() const;
 
 	// Verify a JWT token and return the user's auth_id (UUID) if valid
 	// Returns empty string if token is invalid/expired
 	std::string VerifyToken(const std::string& token);
 
 	// Get last error message for debugging
-	const std::string& GetLastError() const { return m_lastError; }
+	std::string GetLastError() const;
+
+	// ---- Asynchronous API ----
+
+	// Worker threads start on the first async call; StartWorkers picks the size up front
+	void StartWorkers(int count = DEFAULT_WORKERS);
+	// Finish every queued request, then join the workers
+	void StopWorkers();
+
+	// Run callbacks for the calling thread's finished requests. Returns how many ran.
+	size_t PollCompletions();
+
+	void VerifyTokenAsync(const std::string& token, SupabaseCallback<std::string> done);
+	void GetPlayerProfileAsync(const std::string& authId,
+							   const std::string& authToken,
+							   SupabaseCallback<std::optional<PlayerProfile>> done);
+	void CreatePlayerProfileAsync(const std::string& authId,
+								  const std::string& handle,
+								  const std::string& authToken,
+								  SupabaseCallback<bool> done = nullptr);
+	void UpdatePlayerProfileAsync(const PlayerProfile& profile, SupabaseCallback<bool> done = nullptr);
+	void GetAllComputersAsync(SupabaseCallback<std::vector<Computer>> done);
+	void UpdateComputerAsync(const Computer& computer, SupabaseCallback<bool> done = nullptr);
+	void GetAllMissionsAsync(SupabaseCallback<std::vector<Mission>> done);
+	void GetUnclaimedMissionsAsync(SupabaseCallback<std::vector<Mission>> done);
+	void UpdateMissionAsync(const Mission& mission, SupabaseCallback<bool> done = nullptr);
+	void ClaimMissionAsync(int32_t missionId, int32_t playerId, SupabaseCallback<bool> done = nullptr);
+
+	static constexpr int DEFAULT_WORKERS = 2;
 
 private:
 	SupabaseClient() = default;
 
+	void SetLastError(const std::string& error);
+	bool Upsert(const std::string& table, const std::string& rowsJson);
+
+	// Queue work on the pool. Non-empty coalesceKey joins an identical request
+	// already in flight (the key must encode the result type). ordered = write lane.
+	template <typename T>
+	void Submit(const std::string& coalesceKey,
+				std::function<T()> work,
+				SupabaseCallback<T> done,
+				bool ordered = false);
+
+	void StartWorkersLocked(int count);
+	void WorkerLoop(size_t index);
+
 	std::string m_url;
 	std::string m_anonKey;
+
+	mutable std::mutex m_stateMutex; // Guards m_authToken and m_lastError
 	std::string m_authToken;
 	std::string m_lastError;
+
+	// Worker pool
+	std::mutex m_jobMutex;
+	std::condition_variable m_jobReady;
+	std::deque<std::function<void()>> m_jobs; // Reads - any worker
+	std::deque<std::function<void()>> m_orderedJobs; // Writes - worker 0 only, FIFO
+	std::unordered_map<std::string, std::shared_ptr<void>> m_inFlight; // coalesceKey -> waiters
+	std::vector<std::thread> m_workers;
+	bool m_stopping = false;
+
+	// Finished requests waiting for PollCompletions, by requesting thread
+	std::mutex m_completionMutex;
+	std::unordered_map<std::thread::id, std::vector<std::function<void()>>> m_completions;
 };
 
 } // namespace Net
@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+ * Cybrelink World Dictionary
+ * Shared zstd dictionary for compressing world replication packets
+ *
+ * This is a raw-content dictionary: zstd primes its match window with these
+ * bytes, so the computer names, log lines and IP fragments that dominate
+ * WORLD_FULL / WORLD_DELTA payloads compress from the first packet instead
+ * of after the stream has warmed up. The most common fragments sit at the
+ * end, where match offsets are cheapest. Entries are NUL-separated; each one
+ * that starts with a digit is its own literal so "\0" never reads as octal.
+ *
+ * Client and server must ship identical bytes. Changing this file requires
+ * bumping Net::PROTOCOL_VERSION. A trained replacement can be produced from
+ * captured payloads with `zstd --train` and pasted in the same form.
+ */
+
+#include <cstddef>
+
+namespace Net {
+
+static const char WORLD_DICTIONARY[] =
+	// Companies and fixed systems
+	"Introversion Software\0Protovision\0Steve Jackson Games\0Uplink Corporation\0"
+	"Government\0InterNIC\0Global Criminal Database\0International Academic Database\0"
+	"Social Security Database\0Central Medical Database\0Uplink Test Machine\0"
+	"Uplink Credits Machine\0Uplink Public Access Server\0Uplink Internal Services System\0"
+	"Gateway\0Access Terminal\0"
+	// Generated computer names
+	" Local Area Network\0 LAN Dial Up access\0 File Server\0 Central Mainframe\0"
+	" Public Access Server\0 International Bank\0 Internal Services Machine\0"
+	// Access log actions
+	"Unknown\0Blank Action\0Accessed console\0Accessed fileserver\0Accessed logs\0"
+	"User [Admin] logged on (level 1)\0Password authentication accepted\0"
+	"Connection routed through\0Connection from\0Disconnected\0Deleted file \0Copied file \0"
+	"Transferred money\0Accessed File\0"
+	// Mission descriptions
+	"Steal research data\0Delete incriminating files\0Transfer funds discreetly\0"
+	"Trace a target user\0Destroy mainframe logs\0Copy financial records\0"
+	"Investigate corporation\0Frame a target agent\0"
+	// Fixed IPs (game/data/data.h) and common fragments
+	"458.615.48.651\0" "443.65.765.2\0" "785.234.87.124\0" "653.76.235.432\0" "432.543.12.544\0"
+	"456.789.159.459\0" "284.345.42.283\0" "265.125.767.1\0" "849.23.459.24\0" "128.128.128.128\0"
+	"234.773.0.666\0" "128.185.0.2\0" "128.185.0.8\0" "128.185.0.4\0" "127.0.0.1\0"
+	".0.\0"
+	".1\0"
+	".2\0"
+	".3\0"
+	".4\0"
+	".5\0"
+	".6\0"
+	".7\0"
+	".8\0"
+	".9\0";
+
+constexpr size_t WORLD_DICTIONARY_SIZE = sizeof(WORLD_DICTIONARY) - 1;
+
+} // namespace Net
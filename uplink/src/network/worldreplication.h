@@ -0,0 +1,278 @@
+#pragma once
+
+/*
+ * Cybrelink World Replication
+ * Entity record format for WORLD_FULL / WORLD_DELTA, shared by server and client
+ *
+ * Message payload (after fragment reassembly):
+ *   varint  tick
+ *   repeated records:
+ *     u8      EntityKind
+ *     varint  entity id
+ *     u8      EntityOp
+ *     ENTITY_UPDATE only: field markers (DeltaBuffer::WriteFieldStart) + values,
+ *                         terminated by a FIELD_END marker
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "network/deltaencoder.h"
+
+namespace Net {
+
+// ============================================================================
+// Entity Kinds and Field IDs
+// ============================================================================
+
+enum class EntityKind : uint8_t {
+	COMPUTER = 1,
+	MISSION = 2,
+	AGENT = 3,
+};
+
+enum EntityOp : uint8_t {
+	ENTITY_UPDATE = 0, // Full record or changed fields only
+	ENTITY_REMOVE = 1,
+};
+
+// Field ids are 5 bits on the wire (see WriteFieldStart); 0 is unused
+
+enum ComputerField : uint8_t {
+	COMPUTER_IP = 1,
+	COMPUTER_NAME,
+	COMPUTER_TYPE,
+	COMPUTER_SECURITY_LEVEL,
+	COMPUTER_RUNNING,
+	COMPUTER_PROXY_BYPASSED,
+	COMPUTER_FIREWALL_BYPASSED,
+	COMPUTER_MONITOR_DISABLED,
+};
+
+enum MissionField : uint8_t {
+	MISSION_TYPE = 1,
+	MISSION_TARGET_IP,
+	MISSION_DESCRIPTION,
+	MISSION_PAYMENT,
+	MISSION_DIFFICULTY,
+	MISSION_CLAIMED_BY,
+	MISSION_COMPLETED,
+};
+
+enum AgentField : uint8_t {
+	AGENT_HANDLE = 1,
+	AGENT_IS_NPC,
+	AGENT_PLAYER_ID,
+	AGENT_UPLINK_RATING,
+	AGENT_NEUROMANCER_RATING,
+	AGENT_CREDITS,
+	AGENT_CONNECTED_TO_IP,
+	AGENT_CURRENT_MISSION,
+};
+
+constexpr size_t MAX_ENTITY_FIELDS = 16;
+
+// Entities are keyed by kind + id in a single map
+inline uint64_t MakeEntityKey(EntityKind kind, uint32_t id)
+{
+	return (static_cast<uint64_t>(kind) << 32) | id;
+}
+
+inline EntityKind GetEntityKind(uint64_t key) { return static_cast<EntityKind>(key >> 32); }
+inline uint32_t GetEntityId(uint64_t key) { return static_cast<uint32_t>(key); }
+
+// ============================================================================
+// Entity State
+// ============================================================================
+
+struct FieldValue {
+	uint8_t type = FIELD_END; // FIELD_END = field not present
+	uint32_t number = 0; // FIELD_VARINT (signed values are zigzagged)
+	std::string text; // FIELD_STRING
+
+	bool operator==(const FieldValue& other) const
+	{
+		return type == other.type && number == other.number && text == other.text;
+	}
+	bool operator!=(const FieldValue& other) const { return !(*this == other); }
+};
+
+// Wire-level view of one entity, indexed by field id
+struct EntityState {
+	std::array<FieldValue, MAX_ENTITY_FIELDS> fields;
+
+	void SetNumber(uint8_t id, uint32_t value)
+	{
+		fields[id].type = FIELD_VARINT;
+		fields[id].number = value;
+	}
+
+	void SetSigned(uint8_t id, int32_t value) { SetNumber(id, EncodeZigZag(value)); }
+
+	void SetString(uint8_t id, const std::string& value)
+	{
+		fields[id].type = FIELD_STRING;
+		fields[id].text = value;
+	}
+
+	uint32_t GetNumber(uint8_t id) const { return fields[id].number; }
+	int32_t GetSigned(uint8_t id) const { return DecodeZigZag(fields[id].number); }
+	const std::string& GetString(uint8_t id) const { return fields[id].text; }
+	bool Has(uint8_t id) const { return fields[id].type != FIELD_END; }
+};
+
+// ============================================================================
+// Record Writing
+// ============================================================================
+
+inline void WriteFieldValue(DeltaBuffer& out, uint8_t id, const FieldValue& value)
+{
+	out.WriteFieldStart(id, value.type);
+	if (value.type == FIELD_STRING) {
+		out.WriteString(value.text);
+	} else {
+		out.WriteVarint(value.number);
+	}
+}
+
+inline void WriteEntityHeader(DeltaBuffer& out, uint64_t key, EntityOp op)
+{
+	out.WriteU8(static_cast<uint8_t>(GetEntityKind(key)));
+	out.WriteVarint(GetEntityId(key));
+	out.WriteU8(op);
+}
+
+// Every present field
+inline void WriteEntityFull(DeltaBuffer& out, uint64_t key, const EntityState& state)
+{
+	WriteEntityHeader(out, key, ENTITY_UPDATE);
+	for (uint8_t id = 1; id < MAX_ENTITY_FIELDS; ++id) {
+		if (state.fields[id].type != FIELD_END) {
+			WriteFieldValue(out, id, state.fields[id]);
+		}
+	}
+	out.WriteFieldStart(0, FIELD_END);
+}
+
+inline void WriteEntityRemove(DeltaBuffer& out, uint64_t key) { WriteEntityHeader(out, key, ENTITY_REMOVE); }
+
+// ============================================================================
+// Record Reading
+// ============================================================================
+
+inline bool ReadEntityHeader(DeltaReader& in, uint64_t& key, uint8_t& op)
+{
+	uint8_t kind;
+	uint32_t id;
+	if (!in.ReadU8(kind) || !in.ReadVarint(id) || !in.ReadU8(op)) {
+		return false;
+	}
+	key = MakeEntityKey(static_cast<EntityKind>(kind), id);
+	return op == ENTITY_UPDATE || op == ENTITY_REMOVE;
+}
+
+// Apply an ENTITY_UPDATE field list on top of state
+inline bool ReadEntityFields(DeltaReader& in, EntityState& state)
+{
+	for (;;) {
+		uint8_t id, type;
+		if (!in.ReadFieldStart(id, type)) {
+			return false;
+		}
+		if (type == FIELD_END) {
+			return true;
+		}
+		if (id == 0 || id >= MAX_ENTITY_FIELDS) {
+			return false;
+		}
+
+		FieldValue& field = state.fields[id];
+		if (type == FIELD_STRING) {
+			if (!in.ReadString(field.text)) {
+				return false;
+			}
+		} else if (type == FIELD_VARINT) {
+			if (!in.ReadVarint(field.number)) {
+				return false;
+			}
+		} else {
+			return false; // Unknown field type - can't skip safely
+		}
+		field.type = type;
+	}
+}
+
+// ============================================================================
+// World Mirror (client side)
+// ============================================================================
+
+// Client copy of every replicated entity, rebuilt by WORLD_FULL and kept
+// current by WORLD_DELTA.
+
+class WorldMirror {
+public:
+	WorldMirror() : m_tick(0), m_hasSnapshot(false) { }
+
+	bool ApplyFull(const uint8_t* data, size_t len)
+	{
+		m_entities.clear();
+		m_hasSnapshot = ApplyRecords(data, len);
+		return m_hasSnapshot;
+	}
+
+	bool ApplyDelta(const uint8_t* data, size_t len)
+	{
+		if (!m_hasSnapshot) {
+			return false; // Deltas are relative to a snapshot we don't have
+		}
+		return ApplyRecords(data, len);
+	}
+
+	void Clear()
+	{
+		m_entities.clear();
+		m_tick = 0;
+		m_hasSnapshot = false;
+	}
+
+	const EntityState* Find(EntityKind kind, uint32_t id) const
+	{
+		auto it = m_entities.find(MakeEntityKey(kind, id));
+		return it != m_entities.end() ? &it->second : nullptr;
+	}
+
+	const std::unordered_map<uint64_t, EntityState>& GetEntities() const { return m_entities; }
+	uint32_t GetTick() const { return m_tick; }
+	bool HasSnapshot() const { return m_hasSnapshot; }
+
+private:
+	bool ApplyRecords(const uint8_t* data, size_t len)
+	{
+		DeltaReader in(data, len);
+		if (!in.ReadVarint(m_tick)) {
+			return false;
+		}
+
+		while (in.HasMore()) {
+			uint64_t key;
+			uint8_t op;
+			if (!ReadEntityHeader(in, key, op)) {
+				return false;
+			}
+			if (op == ENTITY_REMOVE) {
+				m_entities.erase(key);
+			} else if (!ReadEntityFields(in, m_entities[key])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::unordered_map<uint64_t, EntityState> m_entities;
+	uint32_t m_tick;
+	bool m_hasSnapshot;
+};
+
+} // namespace Net
@@ -8,15 +8,17 @@
 #include "app/dos2unix.h"
 #include <fstream>
 
-#include "gucci.h"
 #include "redshirt.h"
 
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/miscutils.h"
-#include "app/opengl.h"
 #include "app/serialise.h"
 
+#ifndef UPLINK_HEADLESS
+	#include "app/opengl.h"
+#endif
+
 #include "options/options.h"
 
 //////////////////////////////////////////////////////////////////////
@@ -255,7 +257,7 @@ void Options::CreateDefaultOptions()
 
 	Option* optionSoftwareRendering = GetOption("graphics_softwarerendering");
 	if (!optionSoftwareRendering) {
-#ifdef WIN32
+#if defined(WIN32) && !defined(UPLINK_HEADLESS)
 		SetOptionValue("graphics_softwarerendering",
 					   opengl_isSoftwareRendering(),
 					   "Enable software rendering.",
@@ -265,7 +267,7 @@ void Options::CreateDefaultOptions()
 		SetOptionValue("graphics_softwarerendering", 0, "Enable software rendering.", true, false);
 #endif
 	} else {
-#ifdef WIN32
+#if defined(WIN32) && !defined(UPLINK_HEADLESS)
 		optionSoftwareRendering->SetVisible(true);
 		optionSoftwareRendering->SetValue(opengl_isSoftwareRendering());
 #else
@@ -15,8 +15,6 @@
 	#include <unistd.h>
 #endif
 
-#include "gucci.h"
-
 #include "game/data/data.h"
 #include "game/game.h"
 
@@ -24,9 +22,11 @@
 #include "app/globals.h"
 #include "app/serialise.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/linksscreen_interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/linksscreen_interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 #include "world/agent.h"
 #include "world/company/mission.h"
@@ -195,6 +195,7 @@ void Agent::GiveLink(const char* newip)
 		// If this was the player and he is looking at his links screen
 		// Update it now
 
+#ifndef UPLINK_HEADLESS
 		if (strcmp(name, "PLAYER") == 0
 			&& strcmp(game->GetWorld()->GetPlayer()->remotehost, IP_LOCALHOST) == 0
 			&& game->GetInterface()->GetRemoteInterface()->currentscreenindex == 0) {
@@ -204,6 +205,7 @@ void Agent::GiveLink(const char* newip)
 			((LinksScreenInterface*)game->GetInterface()->GetRemoteInterface()->GetInterfaceScreen())
 				->ApplyFilter(NULL);
 		}
+#endif
 	}
 
 	// Make sure it is set to appear on the world map
@@ -756,22 +758,15 @@ void Agent::AttemptMission_TraceUser()
 
 							// Look up the unfortunate individual
 
-							DArray<Person*>* people = game->GetWorld()->people.ConvertToDArray();
 							Person* framed = NULL;
 
-							for (int ip = 0; ip < people->Size(); ++ip) {
-								if (people->ValidIndex(ip)) {
-									if (people->GetData(ip)) {
-										if (strcmp(people->GetData(ip)->localhost, traced_ip) == 0) {
-											framed = people->GetData(ip);
-											break;
-										}
-									}
+							for (Person* person : game->GetWorld()->people) {
+								if (person && strcmp(person->localhost, traced_ip) == 0) {
+									framed = person;
+									break;
 								}
 							}
 
-							delete people;
-
 							if (framed) {
 
 #ifdef VERBOSEAI_ENABLED
@@ -1,8 +1,6 @@
 
 #include <string.h>
 
-#include "gucci.h"
-
 #include "game/game.h"
 
 #include "app/app.h"
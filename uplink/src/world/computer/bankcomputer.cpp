@@ -1,5 +1,4 @@
 
-#include "gucci.h"
 
 #include "app/app.h"
 #include "app/globals.h"
@@ -29,8 +29,10 @@
 
 #include "world/scheduler/notificationevent.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 Computer::Computer()
 {
@@ -50,11 +52,23 @@ Computer::Computer()
 	isexternallyopen = true;
 	isrunning = true;
 	isinfected_revelation = 0.0;
+
+	isinworld = false;
+	targetbucket = -1;
+	targetslot = -1;
 }
 
 Computer::~Computer() { DeleteDArrayData((DArray<UplinkObject*>*)&screens); }
 
-void Computer::SetTYPE(int newTYPE) { TYPE = newTYPE; }
+void Computer::SetTYPE(int newTYPE)
+{
+
+	TYPE = newTYPE;
+
+	if (isinworld) {
+		game->GetWorld()->UpdateTargetComputer(this);
+	}
+}
 
 void Computer::SetName(const char* newname)
 {
@@ -71,6 +85,10 @@ void Computer::SetCompanyName(const char* newname)
 		UplinkAssert(strlen(newname) < SIZE_COMPANY_NAME);
 		UplinkAssert(game->GetWorld()->GetCompany(newname));
 		UplinkStrncpy(companyname, newname, sizeof(companyname));
+
+		if (isinworld) {
+			game->GetWorld()->UpdateTargetComputer(this);
+		}
 	}
 }
 
@@ -80,17 +98,37 @@ void Computer::SetIP(const char* newip)
 	UplinkAssert(strlen(newip) < SIZE_VLOCATION_IP);
 	UplinkAssert(game->GetWorld()->GetVLocation(newip));
 	UplinkStrncpy(ip, newip, sizeof(ip));
+
+	if (isinworld) {
+		game->GetWorld()->computergeneration++;
+	}
 }
 
 void Computer::SetTraceSpeed(int newtracespeed) { tracespeed = newtracespeed; }
 
 void Computer::SetTraceAction(int newtraceaction) { traceaction = newtraceaction; }
 
-void Computer::SetIsTargetable(bool value) { istargetable = value; }
+void Computer::SetIsTargetable(bool value)
+{
+
+	istargetable = value;
+
+	if (isinworld) {
+		game->GetWorld()->UpdateTargetComputer(this);
+	}
+}
 
 void Computer::SetIsExternallyOpen(bool value) { isexternallyopen = value; }
 
-void Computer::SetIsRunning(bool value) { isrunning = value; }
+void Computer::SetIsRunning(bool value)
+{
+
+	isrunning = value;
+
+	if (isinworld) {
+		game->GetWorld()->UpdateTargetComputer(this);
+	}
+}
 
 void Computer::DisinfectRevelation()
 {
@@ -636,8 +674,10 @@ void Computer::Update()
 				game->GetWorld()->GetPlayer()->connection.Disconnect();
 				game->GetWorld()->GetPlayer()->connection.Reset();
 
+#ifndef UPLINK_HEADLESS
 				game->GetInterface()->GetRemoteInterface()->RunNewLocation();
 				game->GetInterface()->GetRemoteInterface()->RunScreen(2);
+#endif
 			}
 		}
 	}
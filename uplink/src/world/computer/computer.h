@@ -41,6 +41,8 @@
 		| COMPUTER_TYPE_CENTRALMAINFRAME | COMPUTER_TYPE_PUBLICBANKSERVER | COMPUTER_TYPE_PERSONALCOMPUTER   \
 		| COMPUTER_TYPE_VOICEPHONESYSTEM | COMPUTER_TYPE_LAN
 
+#define COMPUTER_NUMTYPES 7 // Bits used by the types above
+
 // Trace actions
 
 #define COMPUTER_TRACEACTION_NONE 0
@@ -78,6 +80,11 @@ public:
 	float isinfected_revelation; // Version number
 	Date infectiondate;
 
+	// Where World's index of random targets holds me - not saved
+	bool isinworld; // Set by World::CreateComputer
+	int targetbucket; // -1 if not a random target
+	int targetslot;
+
 	DArray<ComputerScreen*> screens;
 
 	DataBank databank;
@@ -2,17 +2,17 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
 
 #include "game/game.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/dialogscreen_interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/dialogscreen_interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 #include "world/computer/computerscreen/dialogscreen.h"
 
@@ -101,11 +101,13 @@ void DialogScreen::RemoveWidget(const char* name)
 
 		if (strcmp(dsw->GetName(), name) == 0) {
 
+#ifndef UPLINK_HEADLESS
 			ComputerScreen* cs = game->GetInterface()->GetRemoteInterface()->GetComputerScreen();
 
 			if (cs == this) {
 				DialogScreenInterface::RemoveWidget(dsw, GetComputer());
 			}
+#endif
 
 			widgets.RemoveData(i);
 			delete dsw;
@@ -1,9 +1,8 @@
 
 #include "app/serialise.h"
 
-#include "interface/remoteinterface/remoteinterface.h"
-
 #include "world/computer/computerscreen/genericscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 
 GenericScreen::GenericScreen()
 {
@@ -1,9 +1,8 @@
 
 #include "app/serialise.h"
 
-#include "interface/remoteinterface/remoteinterface.h"
-
 #include "world/computer/computerscreen/linksscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 
 LinksScreen::LinksScreen()
 {
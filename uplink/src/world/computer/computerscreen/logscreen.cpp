@@ -2,16 +2,16 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
 
 #include "game/game.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 #include "world/computer/bankcomputer.h"
 #include "world/computer/computer.h"
@@ -37,6 +37,8 @@ void LogScreen::SetNextPage(int newnextpage) { nextpage = newnextpage; }
 
 void LogScreen::SetTARGET(int newTARGET) { TARGET = newTARGET; }
 
+#ifndef UPLINK_HEADLESS
+
 LogBank* LogScreen::GetTargetLogBank()
 {
 
@@ -92,6 +94,8 @@ LogBank* LogScreen::GetTargetLogBank()
 	return logbank;
 }
 
+#endif
+
 bool LogScreen::Load(FILE* file)
 {
 
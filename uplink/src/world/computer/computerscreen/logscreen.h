@@ -35,7 +35,7 @@ public:
 	void SetNextPage(int newnextpage);
 	void SetTARGET(int newTARGET);
 
-	LogBank* GetTargetLogBank(); // Asserts log bank exists
+	LogBank* GetTargetLogBank(); // Asserts log bank exists. Not in uplink-core - reads the remote interface
 
 	// Common functions
 
@@ -5,8 +5,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "gucci.h"
-
 #include "game/game.h"
 
 #include "app/app.h"
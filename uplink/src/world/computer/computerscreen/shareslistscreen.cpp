@@ -2,9 +2,8 @@
 
 #include "app/serialise.h"
 
-#include "interface/remoteinterface/remoteinterface.h"
-
 #include "world/computer/computerscreen/shareslistscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 
 SharesListScreen::SharesListScreen()
 {
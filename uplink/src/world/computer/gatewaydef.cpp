@@ -2,8 +2,6 @@
 
 #include "stdafx.h"
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -1,11 +1,9 @@
 
-#include "eclipse.h"
-#include "gucci.h"
 #include "redshirt.h"
-#include "soundgarden.h"
 
 #include "app/app.h"
 #include "app/globals.h"
+#include "app/miscutils.h"
 #include "app/serialise.h"
 
 #include "game/game.h"
@@ -25,8 +23,13 @@
 #include "world/scheduler/attemptmissionevent.h"
 #include "world/scheduler/eventscheduler.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "eclipse.h"
+	#include "soundgarden.h"
+
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 bool LanMonitor::currentlyActive = false;
 LanComputer* LanMonitor::lanComputer = NULL;
@@ -116,7 +119,9 @@ void LanMonitor::ResetAll()
 	currentSelected = -1;
 	currentSpoof = -1;
 
+#ifndef UPLINK_HEADLESS
 	EclSuperUnHighlight("hud_lanview");
+#endif
 }
 
 void LanMonitor::SetCurrentSystem(int newCurrentSystem)
@@ -126,7 +131,9 @@ void LanMonitor::SetCurrentSystem(int newCurrentSystem)
 	//
 	// Reset our security level
 
+#ifndef UPLINK_HEADLESS
 	game->GetInterface()->GetRemoteInterface()->SetSecurity("Guest", 10);
+#endif
 }
 
 void LanMonitor::SetCurrentSelected(int newCurrentSelected) { currentSelected = newCurrentSelected; }
@@ -330,7 +337,7 @@ void LanMonitor::SysAdminAwaken()
 
 		sysAdminState = SYSADMIN_CURIOUS;
 		int timeToDiscover = (int)NumberGenerator::RandomNormalNumber(10, 5);
-		sysAdminTimer = (int)(EclGetAccurateTime() + timeToDiscover * 1000);
+		sysAdminTimer = (int)(GetAccurateTime() + timeToDiscover * 1000);
 	}
 }
 
@@ -343,6 +350,7 @@ void LanMonitor::SysAdminSleep()
 void LanMonitor::Update()
 {
 
+#ifndef UPLINK_HEADLESS
 	if (sysAdminState < SYSADMIN_CURIOUS && EclIsSuperHighlighted("hud_lanview")) {
 
 		EclSuperUnHighlight("hud_lanview");
@@ -352,6 +360,7 @@ void LanMonitor::Update()
 		EclSuperHighlight("hud_lanview");
 		SgPlaySound(RsArchiveFileOpen("sounds/siren.wav"), "sounds/sirens.wav");
 	}
+#endif
 
 	if (!currentlyActive) {
 		return;
@@ -375,7 +384,7 @@ void LanMonitor::Update()
 	} break;
 
 	case SYSADMIN_CURIOUS: {
-		if (EclGetAccurateTime() >= sysAdminTimer) {
+		if (GetAccurateTime() >= sysAdminTimer) {
 			sysAdminState = SYSADMIN_SEARCHING;
 			if (connection.ValidIndex(0)) {
 				sysAdminCurrentSystem = connection.GetData(0);
@@ -383,7 +392,7 @@ void LanMonitor::Update()
 				sysAdminState = SYSADMIN_ASLEEP;
 			}
 			int timeToDiscover = (int)NumberGenerator::RandomNormalNumber(10, 5);
-			sysAdminTimer = (int)(EclGetAccurateTime() + timeToDiscover * 1000);
+			sysAdminTimer = (int)(GetAccurateTime() + timeToDiscover * 1000);
 			game->GetWorld()->GetPlayer()->GetConnection()->BeginTrace();
 		}
 	} break;
@@ -393,7 +402,7 @@ void LanMonitor::Update()
 			sysAdminState = SYSADMIN_FOUNDYOU;
 		} else {
 
-			if (EclGetAccurateTime() >= sysAdminTimer) {
+			if (GetAccurateTime() >= sysAdminTimer) {
 				int nodeIndex = GetNodeIndex(sysAdminCurrentSystem);
 				if (nodeIndex == -1) {
 					sysAdminState = SYSADMIN_CURIOUS;
@@ -405,7 +414,7 @@ void LanMonitor::Update()
 					}
 				}
 				int timeToDiscover = (int)NumberGenerator::RandomNormalNumber(10, 5);
-				sysAdminTimer = (int)(EclGetAccurateTime() + timeToDiscover * 1000);
+				sysAdminTimer = (int)(GetAccurateTime() + timeToDiscover * 1000);
 			}
 		}
 
@@ -456,8 +465,10 @@ void LanMonitor::Update()
 
 		game->GetWorld()->GetPlayer()->GetConnection()->Disconnect();
 		game->GetWorld()->GetPlayer()->GetConnection()->Reset();
+#ifndef UPLINK_HEADLESS
 		game->GetInterface()->GetRemoteInterface()->RunNewLocation();
 		game->GetInterface()->GetRemoteInterface()->RunScreen(2);
+#endif
 
 	} break;
 	}
@@ -2,8 +2,6 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include "gucci.h"
-
 #include "game/game.h"
 
 #include "app/app.h"
@@ -2,11 +2,9 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include "eclipse.h"
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
+#include "app/miscutils.h"
 #include "app/serialise.h"
 
 #include "game/game.h"
@@ -23,6 +21,12 @@ static char monthname[][12] = { "January", "February", "March",		"April",   "May
 
 static char tempdate[SIZE_DATE_LONG]; // Used to return new strings
 
+static const int64_t SECONDS_PER_MINUTE = 60;
+static const int64_t SECONDS_PER_HOUR = 60 * SECONDS_PER_MINUTE;
+static const int64_t SECONDS_PER_DAY = 24 * SECONDS_PER_HOUR;
+static const int64_t SECONDS_PER_MONTH = 30 * SECONDS_PER_DAY;
+static const int64_t SECONDS_PER_YEAR = 12 * SECONDS_PER_MONTH;
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -30,12 +34,7 @@ static char tempdate[SIZE_DATE_LONG]; // Used to return new strings
 Date::Date()
 {
 
-	second = 1;
-	minute = 1;
-	hour = 1;
-	day = 1;
-	month = 1;
-	year = 1000;
+	seconds = CalendarToSeconds(1, 1, 1, 1, 1, 1000);
 
 	previousupdate = 0;
 
@@ -48,6 +47,8 @@ Date::Date(int newsecond, int newminute, int newhour, int newday, int newmonth,
 	SetDate(newsecond, newminute, newhour, newday, newmonth, newyear);
 
 	previousupdate = 0;
+
+	updateme = false;
 }
 
 Date::~Date() { }
@@ -56,165 +57,59 @@ void Date::SetDate(Date* copydate)
 {
 
 	UplinkAssert(copydate);
-	SetDate(copydate->GetSecond(),
-			copydate->GetMinute(),
-			copydate->GetHour(),
-			copydate->GetDay(),
-			copydate->GetMonth(),
-			copydate->GetYear());
+	seconds = copydate->seconds;
 }
 
 void Date::SetDate(int newsecond, int newminute, int newhour, int newday, int newmonth, int newyear)
 {
 
-	second = newsecond;
-	minute = newminute;
-	hour = newhour;
-	day = newday;
-	month = newmonth;
-	year = newyear;
-
-	AdvanceSecond(0); // Do this to "roll over" any dodgy times
-}
-
-void Date::Activate() { updateme = true; }
-
-void Date::DeActivate() { updateme = false; }
-
-bool Date::Before(Date* date)
-{
-
-	return ((year < date->year) || (year == date->year && month < date->month)
-			|| (year == date->year && month == date->month && day < date->day)
-			|| (year == date->year && month == date->month && day == date->day && hour < date->hour)
-			|| (year == date->year && month == date->month && day == date->day && hour == date->hour
-				&& minute < date->minute)
-			|| (year == date->year && month == date->month && day == date->day && hour == date->hour
-				&& minute == date->minute && second < date->second));
+	seconds = CalendarToSeconds(newsecond, newminute, newhour, newday, newmonth, newyear);
 }
 
-bool Date::After(Date* date)
-{
+int64_t Date::GetSeconds() { return seconds; }
 
-	return ((year > date->year) || (year == date->year && month > date->month)
-			|| (year == date->year && month == date->month && day > date->day)
-			|| (year == date->year && month == date->month && day == date->day && hour > date->hour)
-			|| (year == date->year && month == date->month && day == date->day && hour == date->hour
-				&& minute > date->minute)
-			|| (year == date->year && month == date->month && day == date->day && hour == date->hour
-				&& minute == date->minute && second > date->second));
-}
-
-bool Date::Equal(Date* date)
-{
-
-	return (year == date->year && month == date->month && day == date->day && hour == date->hour
-			&& minute == date->minute && second == date->second);
-}
-
-void Date::AdvanceSecond(int n)
-{
-
-	second += n;
-
-	if (second > 59) {
-		int numminutes = 1 + (second - 60) / 60;
-		second = second % 60;
-		AdvanceMinute(numminutes);
-	}
-
-	if (second < 0) {
-		int numminutes = 1 + (second * -1 - 1) / 60;
-		second = second + (60 * numminutes);
-		AdvanceMinute(numminutes * -1);
-	}
-}
+void Date::SetSeconds(int64_t newseconds) { seconds = newseconds; }
 
-void Date::AdvanceMinute(int n)
+int64_t Date::CalendarToSeconds(int second, int minute, int hour, int day, int month, int year)
 {
 
-	minute += n;
-
-	if (minute > 59) {
-		int numhours = 1 + (minute - 60) / 60;
-		minute = minute % 60;
-		AdvanceHour(numhours);
-	}
-
-	if (minute < 0) {
-		int numhours = 1 + (minute * -1 - 1) / 60;
-		minute = minute + (60 * numhours);
-		AdvanceHour(numhours * -1);
-	}
+	return year * SECONDS_PER_YEAR + (month - 1) * SECONDS_PER_MONTH + (day - 1) * SECONDS_PER_DAY
+		   + hour * SECONDS_PER_HOUR + minute * SECONDS_PER_MINUTE + second;
 }
 
-void Date::AdvanceHour(int n)
-{
+void Date::Activate() { updateme = true; }
 
-	hour += n;
+void Date::DeActivate() { updateme = false; }
 
-	if (hour > 23) {
-		int numdays = 1 + (hour - 24) / 24;
-		hour = hour % 24;
-		AdvanceDay(numdays);
-	}
+bool Date::Before(Date* date) { return seconds < date->seconds; }
 
-	if (hour < 0) {
-		int numdays = 1 + (hour * -1 - 1) / 24;
-		hour = hour + (24 * numdays);
-		AdvanceDay(numdays * -1);
-	}
-}
+bool Date::After(Date* date) { return seconds > date->seconds; }
 
-void Date::AdvanceDay(int n)
-{
+bool Date::Equal(Date* date) { return seconds == date->seconds; }
 
-	day += n;
+void Date::AdvanceSecond(int n) { seconds += n; }
 
-	if (day > 30) {
-		int nummonths = 1 + (day - 30) / 30;
-		day = day % 30;
-		AdvanceMonth(nummonths);
-	}
+void Date::AdvanceMinute(int n) { seconds += n * SECONDS_PER_MINUTE; }
 
-	if (day < 1) {
-		int nummonths = 1 + (day * -1) / 30;
-		day = day + (30 * nummonths);
-		AdvanceMonth(nummonths * -1);
-	}
-}
+void Date::AdvanceHour(int n) { seconds += n * SECONDS_PER_HOUR; }
 
-void Date::AdvanceMonth(int n)
-{
+void Date::AdvanceDay(int n) { seconds += n * SECONDS_PER_DAY; }
 
-	month += n;
+void Date::AdvanceMonth(int n) { seconds += n * SECONDS_PER_MONTH; }
 
-	if (month > 12) {
-		int numyears = 1 + (month - 12) / 12;
-		month = month % 12;
-		AdvanceYear(numyears);
-	}
+void Date::AdvanceYear(int n) { seconds += n * SECONDS_PER_YEAR; }
 
-	if (month < 1) {
-		int numyears = 1 + (month * -1) / 12;
-		month = month + (12 * numyears);
-		AdvanceYear(numyears * -1);
-	}
-}
+int Date::GetSecond() { return (int)(seconds % SECONDS_PER_MINUTE); }
 
-void Date::AdvanceYear(int n) { year += n; }
+int Date::GetMinute() { return (int)(seconds / SECONDS_PER_MINUTE % 60); }
 
-int Date::GetSecond() { return second; }
+int Date::GetHour() { return (int)(seconds / SECONDS_PER_HOUR % 24); }
 
-int Date::GetMinute() { return minute; }
+int Date::GetDay() { return (int)(seconds / SECONDS_PER_DAY % 30) + 1; }
 
-int Date::GetHour() { return hour; }
+int Date::GetMonth() { return (int)(seconds / SECONDS_PER_MONTH % 12) + 1; }
 
-int Date::GetDay() { return day; }
-
-int Date::GetMonth() { return month; }
-
-int Date::GetYear() { return year; }
+int Date::GetYear() { return (int)(seconds / SECONDS_PER_YEAR); }
 
 char* Date::GetMonthName(int month)
 {
@@ -227,7 +122,14 @@ char* Date::GetShortString()
 {
 
 	char result[SIZE_DATE_SHORT];
-	UplinkSnprintf(result, sizeof(result), "%.2d:%.2d, %d-%d-%d", hour, minute, day, month, year);
+	UplinkSnprintf(result,
+				   sizeof(result),
+				   "%.2d:%.2d, %d-%d-%d",
+				   GetHour(),
+				   GetMinute(),
+				   GetDay(),
+				   GetMonth(),
+				   GetYear());
 	UplinkStrncpy(tempdate, result, sizeof(tempdate));
 	return tempdate;
 }
@@ -239,12 +141,12 @@ char* Date::GetLongString()
 	UplinkSnprintf(result,
 				   sizeof(result),
 				   "%.2d:%.2d.%.2d, %d %s %d",
-				   hour,
-				   minute,
-				   second,
-				   day,
-				   GetMonthName(month),
-				   year);
+				   GetHour(),
+				   GetMinute(),
+				   GetSecond(),
+				   GetDay(),
+				   GetMonthName(GetMonth()),
+				   GetYear());
 	UplinkStrncpy(tempdate, result, sizeof(tempdate));
 	return tempdate;
 }
@@ -254,6 +156,10 @@ bool Date::Load(FILE* file)
 
 	LoadID(file);
 
+	// Saved as the calendar fields, as before
+
+	int second, minute, hour, day, month, year;
+
 	if (!FileReadData(&second, sizeof(second), 1, file)) {
 		return false;
 	}
@@ -277,6 +183,8 @@ bool Date::Load(FILE* file)
 		return false;
 	}
 
+	seconds = CalendarToSeconds(second, minute, hour, day, month, year);
+
 	LoadID_END(file);
 
 	return true;
@@ -287,6 +195,13 @@ void Date::Save(FILE* file)
 
 	SaveID(file);
 
+	int second = GetSecond();
+	int minute = GetMinute();
+	int hour = GetHour();
+	int day = GetDay();
+	int month = GetMonth();
+	int year = GetYear();
+
 	fwrite(&second, sizeof(second), 1, file);
 	fwrite(&minute, sizeof(minute), 1, file);
 	fwrite(&hour, sizeof(hour), 1, file);
@@ -303,7 +218,7 @@ void Date::Print()
 {
 
 	printf("Date: ");
-	printf("%d:%d:%d, %d/%d/%d\n", hour, minute, second, day, month, year);
+	printf("%d:%d:%d, %d/%d/%d\n", GetHour(), GetMinute(), GetSecond(), GetDay(), GetMonth(), GetYear());
 	if (updateme) {
 		printf("Syncronised with real world time\n");
 	} else {
@@ -316,14 +231,14 @@ void Date::Update()
 
 	if (updateme) { // Update the time
 
-		int nummilliseconds = (int)EclGetAccurateTime() - previousupdate;
+		int nummilliseconds = (int)GetAccurateTime() - previousupdate;
 
 		if (game->GameSpeed() == GAMESPEED_NORMAL) {
 
 			if (nummilliseconds > 1000) {
 
 				AdvanceSecond(1);
-				previousupdate = (int)EclGetAccurateTime();
+				previousupdate = (int)GetAccurateTime();
 			}
 
 		} else {
@@ -374,7 +289,7 @@ void Date::Update()
 					SetDate(&newdate);
 				}
 
-				previousupdate = (int)EclGetAccurateTime();
+				previousupdate = (int)GetAccurateTime();
 			}
 		}
 	}
@@ -383,13 +298,7 @@ void Date::Update()
 
 	// Verify Date is valid
 
-	UplinkAssert(second >= 0 && second < 60);
-	UplinkAssert(minute >= 0 && minute < 60);
-	UplinkAssert(hour >= 0 && hour < 24);
-
-	UplinkAssert(day > 0 && day <= 31);
-	UplinkAssert(month > 0 && month <= 12);
-	UplinkAssert(year > 0);
+	UplinkAssert(seconds >= SECONDS_PER_YEAR);
 
 #endif
 }
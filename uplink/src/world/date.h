@@ -10,6 +10,7 @@
 #ifndef _included_date_h
 #define _included_date_h
 
+#include <stdint.h>
 #include <stdio.h>
 
 #include "app/uplinkobject.h"
@@ -20,12 +21,10 @@
 class Date : public UplinkObject {
 
 protected:
-	int second;
-	int minute;
-	int hour;
-	int day;
-	int month;
-	int year;
+	// Seconds since the start of year 0, on the game's calendar of 30 day
+	// months and 12 month years. The calendar fields are worked out from it
+	// when asked for, so comparing and advancing dates is one integer op.
+	int64_t seconds;
 
 	int previousupdate;
 
@@ -40,6 +39,13 @@ public:
 	void SetDate(int newsecond, int newminute, int newhour, int newday, int newmonth, int newyear);
 	void SetDate(Date* copydate);
 
+	int64_t GetSeconds(); // See seconds above
+	void SetSeconds(int64_t newseconds);
+
+	// The calendar arithmetic behind seconds. Out of range fields roll over
+	// into the next ones, eg second 60 is the next minute.
+	static int64_t CalendarToSeconds(int second, int minute, int hour, int day, int month, int year);
+
 	void Activate(); // Update me
 	void DeActivate(); // Don't update me
 
@@ -9,8 +9,10 @@
 
 #include "options/options.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+#endif
 
 #include "world/company/companyuplink.h"
 #include "world/company/mission.h"
@@ -71,8 +73,10 @@ void ConsequenceGenerator::CaughtHacking(Person* person, Computer* comp)
 
 			person->GetConnection ()->Disconnect ();
 			person->GetConnection ()->Reset ();
+#ifndef UPLINK_HEADLESS
 			game->GetInterface ()->GetRemoteInterface ()->RunNewLocation ();
 			game->GetInterface ()->GetRemoteInterface ()->RunScreen ( 2);
+#endif
 
 		}
 
@@ -133,11 +137,13 @@ void ConsequenceGenerator::CaughtHacking(Person* person, Computer* comp)
 			person->GetConnection()->Disconnect();
 			person->GetConnection()->Reset();
 
+#ifndef UPLINK_HEADLESS
 			if (strcmp(person->name, "PLAYER") == 0) {
 
 				game->GetInterface()->GetRemoteInterface()->RunNewLocation();
 				game->GetInterface()->GetRemoteInterface()->RunScreen(2);
 			}
+#endif
 		}
 	}
 
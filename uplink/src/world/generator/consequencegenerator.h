@@ -20,8 +20,6 @@
 
 // ============================================================================
 
-#include "eclipse.h"
-
 class Person;
 class Computer;
 class Mission;
@@ -29,12 +29,11 @@
 #include "world/computer/computerscreen/menuscreen.h"
 #include "world/computer/computerscreen/messagescreen.h"
 #include "world/computer/computerscreen/passwordscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 #include "world/computer/computerscreen/useridscreen.h"
 #include "world/computer/lancomputer.h"
 #include "world/computer/securitysystem.h"
 
-#include "interface/remoteinterface/remoteinterface.h"
-
 class dos2unix : public filebuf { };
 
 void LanGenerator::Initialise() { }
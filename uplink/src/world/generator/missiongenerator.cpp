@@ -10,7 +10,6 @@
 #include <strstream>
 
 #include "redshirt.h"
-#include "soundgarden.h"
 
 #include "app/app.h"
 #include "app/globals.h"
@@ -20,7 +19,10 @@
 
 #include "game/data/data.h"
 #include "game/game.h"
-#include "game/scriptlibrary.h"
+
+#ifndef UPLINK_HEADLESS
+	#include "soundgarden.h"
+#endif
 
 #include "world/company/company.h"
 #include "world/company/companyuplink.h"
@@ -4290,7 +4292,9 @@ void MissionGenerator::MissionCompleted(Mission* mission, Person* person, Messag
 		}
 	}
 
+#ifndef UPLINK_HEADLESS
 	SgPlaySound(RsArchiveFileOpen("sounds/success.wav"), "sounds/success.wav", false);
+#endif
 }
 
 void MissionGenerator::MissionNotCompleted(Mission* mission,
@@ -2,8 +2,6 @@
 #include <string.h>
 #include <strstream>
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 
@@ -27,6 +27,7 @@
 #include "world/computer/computerscreen/menuscreen.h"
 #include "world/computer/computerscreen/messagescreen.h"
 #include "world/computer/computerscreen/passwordscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 
 #include "world/generator/langenerator.h"
 #include "world/generator/missiongenerator.h"
@@ -37,9 +38,11 @@
 #include "world/scheduler/notificationevent.h"
 #include "world/scheduler/runplotsceneevent.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
-#include "interface/taskmanager/taskmanager.h"
+#ifndef UPLINK_HEADLESS
+	#include "interface/interface.h"
+	#include "interface/remoteinterface/remoteinterface.h"
+	#include "interface/taskmanager/taskmanager.h"
+#endif
 
 const char* MISSION_TITLE[] = { "Backfire",
 								"Tracer",
@@ -907,8 +910,10 @@ void PlotGenerator::RunRevelation(char* ip, float version, bool playerresponsibl
 		game->GetWorld()->GetPlayer()->connection.Disconnect();
 		game->GetWorld()->GetPlayer()->connection.Reset();
 
+#ifndef UPLINK_HEADLESS
 		game->GetInterface()->GetRemoteInterface()->RunNewLocation();
 		game->GetInterface()->GetRemoteInterface()->RunScreen(2);
+#endif
 	}
 
 #endif // DEMOGAME
@@ -1730,7 +1735,7 @@ void PlotGenerator::Run_Act2Scene1()
 		return;
 	}
 	char* ip = hiscomp->ip;
-	game->GetWorld()->computers.RemoveData(hiscomputername);
+	game->GetWorld()->RemoveComputer(hiscomp);
 
 	Computer* comp = new Computer();
 	comp->SetTYPE(COMPUTER_TYPE_PERSONALCOMPUTER);
@@ -2752,10 +2757,12 @@ void PlotGenerator::Run_Act5Scene2()
 		game->GetWorld()->GetPlayer()->GiveMission(mission);
 
 		game->SetGameSpeed(GAMESPEED_NORMAL);
+#ifndef UPLINK_HEADLESS
 		EclDirtyButton("hud_speed 0");
 		EclDirtyButton("hud_speed 1");
 		EclDirtyButton("hud_speed 2");
 		EclDirtyButton("hud_speed 3");
+#endif
 
 		//
 		// Start the AI going
@@ -2796,10 +2803,12 @@ void PlotGenerator::Run_Act5Scene2()
 		game->GetWorld()->GetPlayer()->GiveMission(mission);
 
 		game->SetGameSpeed(GAMESPEED_NORMAL);
+#ifndef UPLINK_HEADLESS
 		EclDirtyButton("hud_speed 0");
 		EclDirtyButton("hud_speed 1");
 		EclDirtyButton("hud_speed 2");
 		EclDirtyButton("hud_speed 3");
+#endif
 
 		//
 		// Start the AI going
@@ -4752,7 +4761,9 @@ void PlotGenerator::Revelation_ReleaseUncontrolled()
 
 	// Run revelation locally
 
+#ifndef UPLINK_HEADLESS
 	game->GetInterface()->GetTaskManager()->RunSoftware("Revelation", version_revelation);
+#endif
 }
 
 #endif // FULLGAME
@@ -6,7 +6,6 @@
 
 #include <strstream>
 
-#include "gucci.h"
 #include "redshirt.h"
 
 #include "game/data/data.h"
@@ -17,15 +16,13 @@
 #include "app/miscutils.h"
 #include "app/serialise.h"
 
-#include "interface/interface.h"
-#include "interface/localinterface/hud_interface.h"
-#include "interface/localinterface/localinterface.h"
-#include "interface/remoteinterface/remoteinterface.h"
-
 #include "options/options.h"
 
 #include "app/dos2unix.h"
-#include "app/opengl_interface.h"
+
+#ifndef UPLINK_HEADLESS
+	#include "gucci.h"
+#endif
 
 #include "world/company/companyuplink.h"
 #include "world/company/mission.h"
@@ -57,6 +54,7 @@
 #include "world/computer/computerscreen/menuscreen.h"
 #include "world/computer/computerscreen/messagescreen.h"
 #include "world/computer/computerscreen/passwordscreen.h"
+#include "world/computer/computerscreen/screencodes.h"
 #include "world/computer/computerscreen/shareslistscreen.h"
 #include "world/computer/computerscreen/useridscreen.h"
 
@@ -69,6 +67,7 @@ Image* WorldGenerator::worldmapmask = NULL;
 void WorldGenerator::Initialise()
 {
 
+#ifndef UPLINK_HEADLESS
 	worldmapmask = new Image();
 	char* filename;
 	if (game->GetWorldMapType() == Game::defconworldmap) {
@@ -80,14 +79,17 @@ void WorldGenerator::Initialise()
 	worldmapmask->Scale(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
 	worldmapmask->FlipAroundH();
 	delete[] filename;
+#endif
 }
 
 void WorldGenerator::Shutdown()
 {
 
+#ifndef UPLINK_HEADLESS
 	if (worldmapmask) {
 		delete worldmapmask;
 	}
+#endif
 }
 
 void WorldGenerator::GenerateAll()
@@ -102,7 +104,9 @@ void WorldGenerator::GenerateAll()
 void WorldGenerator::GenerateValidMapPos(int& x, int& y)
 {
 
+#ifndef UPLINK_HEADLESS
 	UplinkAssert(worldmapmask);
+#endif
 
 	/********** Start code by Franois Gagn **********/
 	int retryDiffLoc = 0;
@@ -117,7 +121,13 @@ void WorldGenerator::GenerateValidMapPos(int& x, int& y)
 		UplinkAssert(tX >= 0 && tX < VIRTUAL_WIDTH);
 		UplinkAssert(tY >= 0 && tY < VIRTUAL_HEIGHT);
 
-		if (worldmapmask->GetPixelR(tX, tY) != 0) {
+#ifndef UPLINK_HEADLESS
+		bool onLand = worldmapmask->GetPixelR(tX, tY) != 0;
+#else
+		bool onLand = true; // uplink-core has no image loader for the mask, any position is accepted
+#endif
+
+		if (onLand) {
 
 			/********** Start code by Franois Gagn **********/
 			int found = 0;
@@ -4156,48 +4166,73 @@ void WorldGenerator::UpdateSoftwareUpgrades()
 	}
 }
 
+// Picks evenly among the entries of tree that isvalid accepts, without
+// copying the tree: one pass counts them, a second finds the chosen one.
+// Returns NULL if there are none.
+template <class T, class Predicate> static T PickRandom(const SortedTree<T>& tree, Predicate isvalid)
+{
+
+	int numvalid = 0;
+	for (T data : tree) {
+		if (isvalid(data)) {
+			numvalid++;
+		}
+	}
+
+	if (numvalid == 0) {
+		return NULL;
+	}
+
+	int index = NumberGenerator::RandomNumber(numvalid);
+
+	for (T data : tree) {
+		if (isvalid(data) && index-- == 0) {
+			return data;
+		}
+	}
+
+	return NULL;
+}
+
 VLocation* WorldGenerator::GetRandomLocation()
 {
 
-	DArray<char*>* vls = game->GetWorld()->locations.ConvertIndexToDArray();
-	UplinkAssert(vls->Size() > 0);
+	SortedTree<VLocation*>& locations = game->GetWorld()->locations;
+	UplinkAssert(locations.Size() > 0);
 
-	int index = NumberGenerator::RandomNumber(vls->Size());
-	UplinkAssert(vls->ValidIndex(index));
+	int index = NumberGenerator::RandomNumber(locations.Size());
 
-	VLocation* vl = game->GetWorld()->GetVLocation(vls->GetData(index));
-	delete vls;
-	return vl;
+	for (VLocation* vl : locations) {
+		if (index-- == 0) {
+			return vl;
+		}
+	}
+
+	UplinkAbort("GetRandomLocation : index out of range");
+	return NULL;
 }
 
 Company* WorldGenerator::GetRandomCompany()
 {
 
-	DArray<char*>* comps = game->GetWorld()->companies.ConvertIndexToDArray();
-	UplinkAssert(comps->Size() > 0);
+	UplinkAssert(game->GetWorld()->companies.Size() > 0);
 
-	while (1) {
-
-		int index = NumberGenerator::RandomNumber(comps->Size());
-		UplinkAssert(comps->ValidIndex(index));
+	// Make sure we don't pick up the player's computer
+	// Or a persons private company
+	// Or a Government computer
+	// Or an Uplink computer
+	// Or a plot company (because it cause problems when the plot as begun)
 
-		Company* comp = game->GetWorld()->GetCompany(comps->GetData(index));
+	Company* comp = PickRandom(game->GetWorld()->companies, [](Company* comp) {
 		UplinkAssert(comp);
+		return strcmp(comp->name, "Player") != 0 && strcmp(comp->name, "Government") != 0
+			   && strcmp(comp->name, "Uplink") != 0 && strcmp(comp->name, "Sample Company") != 0
+			   && !game->GetWorld()->plotgenerator.IsPlotCompany(comp->name)
+			   && comp->TYPE != COMPANYTYPE_UNKNOWN;
+	});
 
-		// Make sure we haven't picked up the player's computer
-		// Or a persons private company
-		// Or a Government computer
-		// Or an Uplink computer
-		// Or a plot company (because it cause problems when the plot as begun)
-
-		if (strcmp(comp->name, "Player") != 0 && strcmp(comp->name, "Government") != 0
-			&& strcmp(comp->name, "Uplink") != 0 && strcmp(comp->name, "Sample Company") != 0
-			&& !game->GetWorld()->plotgenerator.IsPlotCompany(comp->name)
-			&& comp->TYPE != COMPANYTYPE_UNKNOWN) {
-			delete comps;
-			return comp;
-		}
-	}
+	UplinkAssert(comp);
+	return comp;
 }
 
 Computer* WorldGenerator::GetRandomComputer()
@@ -4229,31 +4264,13 @@ Computer* WorldGenerator::GetRandomComputer()
 Computer* WorldGenerator::GetRandomComputer(int TYPE)
 {
 
-	DArray<char*>* comps = game->GetWorld()->computers.ConvertIndexToDArray();
-	UplinkAssert(comps->Size() > 0);
+	UplinkAssert(game->GetWorld()->computers.Size() > 0);
 
-	// Create a new array of all valid computers
+	// World keeps the valid computers bucketed by TYPE as they change
 
-	DArray<char*>* typecomps = new DArray<char*>();
+	int numvalid = game->GetWorld()->NumTargetComputers(TYPE);
 
-	for (int i = 0; i < comps->Size(); ++i) {
-
-		if (comps->ValidIndex(i)) {
-
-			Computer* comp = game->GetWorld()->GetComputer(comps->GetData(i));
-			UplinkAssert(comp);
-
-			if ((comp->TYPE & TYPE) && comp->istargetable && comp->isrunning
-				&& strcmp(comp->companyname, "Government") != 0) {
-				typecomps->PutData(comps->GetData(i));
-			}
-		}
-	}
-
-	if (typecomps->Size() == 0) {
-
-		delete comps;
-		delete typecomps;
+	if (numvalid == 0) {
 
 		// We couldn't find a valid computer
 		// Generate one now
@@ -4263,20 +4280,10 @@ Computer* WorldGenerator::GetRandomComputer(int TYPE)
 		Company* company = GetRandomCompany();
 		UplinkAssert(company);
 		return GenerateComputer(company->name, TYPE);
-
-	} else {
-
-		int index = NumberGenerator::RandomNumber(typecomps->Size());
-		UplinkAssert(typecomps->ValidIndex(index));
-
-		Computer* comp = game->GetWorld()->GetComputer(typecomps->GetData(index));
-		UplinkAssert(comp);
-
-		delete comps;
-		delete typecomps;
-
-		return comp;
 	}
+
+	int index = NumberGenerator::RandomNumber(numvalid);
+	return game->GetWorld()->GetTargetComputer(TYPE, index);
 }
 
 Computer* WorldGenerator::GetRandomLowSecurityComputer(int TYPE)
@@ -4321,49 +4328,30 @@ Person* WorldGenerator::GetRandomPerson()
 	*/
 
 	//
-	// Build a list of all valid People
-
-	DArray<char*>* people = game->GetWorld()->people.ConvertIndexToDArray();
-	UplinkAssert(people->Size() > 0);
+	// Pick from all valid People
 
-	DArray<Person*> validPeople;
+	UplinkAssert(game->GetWorld()->people.Size() > 0);
 
-	for (int i = 0; i < people->Size(); ++i) {
-
-		UplinkAssert(people->ValidIndex(i));
-
-		Person* person = game->GetWorld()->GetPerson(people->GetData(i));
+	Person* person = PickRandom(game->GetWorld()->people, [](Person* person) {
 		UplinkAssert(person);
+		return person->istargetable && person->GetStatus() == PERSON_STATUS_NONE;
+	});
 
-		if (person->istargetable && person->GetStatus() == PERSON_STATUS_NONE) {
-
-			validPeople.PutData(person);
-		}
-	}
-
-	delete people;
-
-	if (validPeople.Size() == 0) {
+	if (!person) {
 
 		// No person fits the criteria
 		// Create a new one and return him
 
-		Person* person = WorldGenerator::GeneratePerson();
-		return person;
-
-	} else {
-
-		int index = NumberGenerator::RandomNumber(validPeople.Size());
-		UplinkAssert(validPeople.ValidIndex(index));
-		return (Person*)validPeople.GetData(index);
+		person = WorldGenerator::GeneratePerson();
 	}
+
+	return person;
 }
 
 Agent* WorldGenerator::GetRandomAgent()
 {
 
-	DArray<char*>* people = game->GetWorld()->people.ConvertIndexToDArray();
-	UplinkAssert(people->Size() > 0);
+	UplinkAssert(game->GetWorld()->people.Size() > 0);
 
 	/*
 
@@ -4390,40 +4378,23 @@ Agent* WorldGenerator::GetRandomAgent()
 	*/
 
 	//
-	// Build a list of all valid Agents
+	// Pick from all valid Agents
 
-	DArray<Person*> validPeople;
-
-	for (int i = 0; i < people->Size(); ++i) {
-
-		UplinkAssert(people->ValidIndex(i));
-
-		Person* person = game->GetWorld()->GetPerson(people->GetData(i));
+	Person* person = PickRandom(game->GetWorld()->people, [](Person* person) {
 		UplinkAssert(person);
+		return person->istargetable && person->rating.uplinkrating > 0
+			   && person->GetStatus() == PERSON_STATUS_NONE;
+	});
 
-		if (person->istargetable && person->rating.uplinkrating > 0
-			&& person->GetStatus() == PERSON_STATUS_NONE) {
-
-			validPeople.PutData(person);
-		}
-	}
-
-	delete people;
-
-	if (validPeople.Size() == 0) {
+	if (!person) {
 
 		// No agent fits the criteria
 		// Create a new one and return him
 
-		Agent* agent = WorldGenerator::GenerateAgent();
-		return agent;
-
-	} else {
-
-		int index = NumberGenerator::RandomNumber(validPeople.Size());
-		UplinkAssert(validPeople.ValidIndex(index));
-		return (Agent*)validPeople.GetData(index);
+		return WorldGenerator::GenerateAgent();
 	}
+
+	return (Agent*)person;
 }
 
 Mission* WorldGenerator::GetRandomMission()
@@ -4446,55 +4417,37 @@ Mission* WorldGenerator::GetRandomMission()
 void WorldGenerator::ReplaceAdminCompanies(Person* person)
 {
 
-	DArray<class Company*>* comps = game->GetWorld()->companies.ConvertToDArray();
-
-	for (int i = comps->Size() - 1; i >= 0; i--) {
-
-		if (comps->ValidIndex(i)) {
+	for (Company* cp : game->GetWorld()->companies) {
 
-			Company* cp = comps->GetData(i);
+		if (cp->administrator && strcmp(person->name, cp->administrator) == 0) {
 
-			if (cp->administrator && strcmp(person->name, cp->administrator) == 0) {
-
-				Person* newadmin = WorldGenerator::GetRandomPerson();
-				UplinkAssert(newadmin);
-				cp->SetAdmin(newadmin->name);
-			}
+			Person* newadmin = WorldGenerator::GetRandomPerson();
+			UplinkAssert(newadmin);
+			cp->SetAdmin(newadmin->name);
 		}
 	}
-
-	delete comps;
 }
 
 void WorldGenerator::ReplaceInvalidCompanyAdmins()
 {
 
 	World* world = game->GetWorld();
-	DArray<class Company*>* comps = world->companies.ConvertToDArray();
-
-	for (int i = comps->Size() - 1; i >= 0; i--) {
-
-		if (comps->ValidIndex(i)) {
-
-			Company* cp = comps->GetData(i);
+	for (Company* cp : world->companies) {
 
-			if (cp->administrator) {
+		if (cp->administrator) {
 
-				Person* admin = world->GetPerson(cp->administrator);
+			Person* admin = world->GetPerson(cp->administrator);
 
-				// Some administrator ( like Unlisted ) are valid but not a person
+			// Some administrator ( like Unlisted ) are valid but not a person
 
-				if (admin && admin->GetStatus() != PERSON_STATUS_NONE) {
+			if (admin && admin->GetStatus() != PERSON_STATUS_NONE) {
 
-					Person* newadmin = WorldGenerator::GetRandomPerson();
-					UplinkAssert(newadmin);
-					cp->SetAdmin(newadmin->name);
-				}
+				Person* newadmin = WorldGenerator::GetRandomPerson();
+				UplinkAssert(newadmin);
+				cp->SetAdmin(newadmin->name);
 			}
 		}
 	}
-
-	delete comps;
 }
 
 /*
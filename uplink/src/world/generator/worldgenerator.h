@@ -7,7 +7,6 @@
 
 // ============================================================================
 
-#include "gucci.h"
 #include "tosser.h"
 
 class VLocation;
@@ -19,6 +18,7 @@ class Player;
 class Mission;
 class Sale;
 class Button;
+class Image;
 
 // ============================================================================
 
@@ -1,8 +1,6 @@
 
 #include "stdafx.h"
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -10,9 +8,6 @@
 #include "game/data/data.h"
 #include "game/game.h"
 
-#include "interface/interface.h"
-#include "interface/remoteinterface/remoteinterface.h"
-
 #include "world/computer/computer.h"
 #include "world/computer/lanmonitor.h"
 #include "world/message.h"
@@ -42,15 +37,9 @@ Player::~Player() { DeleteBTreeData(&shares); }
 void Player::GiveAllLinks()
 {
 
-	DArray<VLocation*>* locs = game->GetWorld()->locations.ConvertToDArray();
-
-	for (int i = 0; i < locs->Size(); ++i) {
-		if (locs->ValidIndex(i)) {
-			GiveLink(locs->GetData(i)->ip);
-		}
+	for (VLocation* vl : game->GetWorld()->locations) {
+		GiveLink(vl->ip);
 	}
-
-	delete locs;
 }
 
 void Player::GiveMessage(Message* message)
@@ -379,7 +368,6 @@ void Player::Update()
 			// Trace completed - act on action
 
 			Computer* comp = GetRemoteHost()->GetComputer();
-			char* username = game->GetInterface()->GetRemoteInterface()->security_name;
 
 			ConsequenceGenerator::CaughtHacking(this, comp);
 		}
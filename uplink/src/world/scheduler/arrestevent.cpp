@@ -1,8 +1,6 @@
 
 #include <strstream>
 
-#include "soundgarden.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -1,15 +1,16 @@
 
 #include <strstream>
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
 
 #include "game/data/data.h"
 #include "game/game.h"
-#include "game/scriptlibrary.h"
+
+#ifndef UPLINK_HEADLESS
+	#include "game/scriptlibrary.h"
+#endif
 
 #include "world/company/company.h"
 #include "world/company/companyuplink.h"
@@ -158,17 +159,11 @@ char* NotificationEvent::GetLongString() { return GetShortString(); }
 void NotificationEvent::ApplyMonthlyGrowth()
 {
 
-	DArray<Company*>* d_companies = game->GetWorld()->companies.ConvertToDArray();
-
-	for (int i = 0; i < d_companies->Size(); ++i) {
-		if (d_companies->ValidIndex(i)) {
-			d_companies->GetData(i)->Grow(30);
-			d_companies->GetData(i)->VaryGrowth();
-		}
+	for (Company* company : game->GetWorld()->companies) {
+		company->Grow(30);
+		company->VaryGrowth();
 	}
 
-	delete d_companies;
-
 	// Schedule another at the start of the next month
 
 	Date duedate;
@@ -224,16 +219,10 @@ void NotificationEvent::DemoGenerateNewMission()
 void NotificationEvent::CheckForSecurityBreaches()
 {
 
-	DArray<Computer*>* d_computers = game->GetWorld()->computers.ConvertToDArray();
-
-	for (int i = 0; i < d_computers->Size(); ++i) {
-		if (d_computers->ValidIndex(i)) {
-			d_computers->GetData(i)->CheckForSecurityBreaches();
-		}
+	for (Computer* computer : game->GetWorld()->computers) {
+		computer->CheckForSecurityBreaches();
 	}
 
-	delete d_computers;
-
 	// Schedule another
 
 	Date duedate;
@@ -246,9 +235,22 @@ void NotificationEvent::CheckForSecurityBreaches()
 	game->GetWorld()->scheduler.ScheduleEvent(event);
 }
 
-void NotificationEvent::BuyAgentList() { ScriptLibrary::RunScript(71); }
+// The agent list special mission is offered through the game's script library,
+// so uplink-core doesn't offer it
 
-void NotificationEvent::AgentsOnListDie() { ScriptLibrary::RunScript(72); }
+void NotificationEvent::BuyAgentList()
+{
+#ifndef UPLINK_HEADLESS
+	ScriptLibrary::RunScript(71);
+#endif
+}
+
+void NotificationEvent::AgentsOnListDie()
+{
+#ifndef UPLINK_HEADLESS
+	ScriptLibrary::RunScript(72);
+#endif
+}
 
 void NotificationEvent::ExpireOldStuff()
 {
@@ -257,16 +259,10 @@ void NotificationEvent::ExpireOldStuff()
 	// Expire old access logs
 	//
 
-	DArray<Computer*>* d_computers = game->GetWorld()->computers.ConvertToDArray();
-
-	for (int i = 0; i < d_computers->Size(); ++i) {
-		if (d_computers->ValidIndex(i)) {
-			d_computers->GetData(i)->ManageOldLogs();
-		}
+	for (Computer* computer : game->GetWorld()->computers) {
+		computer->ManageOldLogs();
 	}
 
-	delete d_computers;
-
 	//
 	// Expire old news stories
 	//
@@ -423,16 +419,10 @@ void NotificationEvent::CheckMissionDueDates()
 void NotificationEvent::CheckRecentHackCount()
 {
 
-	DArray<Computer*>* d_computers = game->GetWorld()->computers.ConvertToDArray();
-
-	for (int i = 0; i < d_computers->Size(); ++i) {
-		if (d_computers->ValidIndex(i)) {
-			d_computers->GetData(i)->UpdateRecentHacks();
-		}
+	for (Computer* computer : game->GetWorld()->computers) {
+		computer->UpdateRecentHacks();
 	}
 
-	delete d_computers;
-
 	// Schedule another
 
 	NotificationEvent* ne = new NotificationEvent();
@@ -609,45 +599,38 @@ void NotificationEvent::PayUplinkMonthlyFee()
 	// everyone with an Uplink Rating
 	//
 
-	DArray<Person*>* people = (DArray<Person*>*)game->GetWorld()->people.ConvertToDArray();
+	for (Person* person : game->GetWorld()->people) {
 
-	for (int i = 0; i < people->Size(); ++i) {
-		if (people->ValidIndex(i)) {
+		UplinkAssert(person);
 
-			Person* person = people->GetData(i);
-			UplinkAssert(person);
+		if (person->rating.uplinkrating > 0) {
 
-			if (person->rating.uplinkrating > 0) {
+			person->ChangeBalance(COST_UPLINK_PERMONTH * -1, "Uplink Corporation : Monthly fee");
 
-				person->ChangeBalance(COST_UPLINK_PERMONTH * -1, "Uplink Corporation : Monthly fee");
+			std::ostrstream body;
+			body << "Uplink Corporation has deducted the standard monthly "
+					"membership fee of "
+				 << COST_UPLINK_PERMONTH
+				 << " credits from "
+					"you current account.\n\n"
+					"We are confident you will agree that this represents "
+					"incredible value for money and wish you another successful "
+					"and prosperous month with our organisation.\n"
+					"Thank you."
+				 << '\x0';
 
-				std::ostrstream body;
-				body << "Uplink Corporation has deducted the standard monthly "
-						"membership fee of "
-					 << COST_UPLINK_PERMONTH
-					 << " credits from "
-						"you current account.\n\n"
-						"We are confident you will agree that this represents "
-						"incredible value for money and wish you another successful "
-						"and prosperous month with our organisation.\n"
-						"Thank you."
-					 << '\x0';
-
-				Message* m = new Message();
-				m->SetTo(person->name);
-				m->SetFrom("Uplink Corporation");
-				m->SetSubject("Uplink monthly fee deducted");
-				m->SetBody(body.str());
-				m->Send();
+			Message* m = new Message();
+			m->SetTo(person->name);
+			m->SetFrom("Uplink Corporation");
+			m->SetSubject("Uplink monthly fee deducted");
+			m->SetBody(body.str());
+			m->Send();
 
-				body.rdbuf()->freeze(0);
-				// delete [] body.str ();
-			}
+			body.rdbuf()->freeze(0);
+			// delete [] body.str ();
 		}
 	}
 
-	delete people;
-
 	//
 	// Schedule another in a month
 	//
@@ -1,16 +1,10 @@
 
 #include <strstream>
 
-#include "soundgarden.h"
-
 #include "app/app.h"
 #include "app/globals.h"
-#include "app/opengl.h"
-#include "app/opengl_interface.h"
 #include "app/serialise.h"
 
-#include "mainmenu/mainmenu.h"
-
 #include "game/data/data.h"
 #include "game/game.h"
 
@@ -1,8 +1,6 @@
 
 #include <strstream>
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -12,8 +12,6 @@
 
 // ============================================================================
 
-#include "eclipse.h"
-
 #include "world/person.h"
 #include "world/scheduler/uplinkevent.h"
 
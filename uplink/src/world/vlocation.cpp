@@ -2,8 +2,6 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include "gucci.h"
-
 #include "app/app.h"
 #include "app/globals.h"
 #include "app/serialise.h"
@@ -24,6 +22,9 @@ VLocation::VLocation()
 	listed = true;
 	displayed = true;
 	colored = false;
+
+	cachedcomputer = NULL;
+	cachedgeneration = 0;
 }
 
 VLocation::~VLocation() { }
@@ -51,6 +52,7 @@ void VLocation::SetComputer(const char* newcomputer)
 
 	UplinkAssert(strlen(newcomputer) < SIZE_COMPUTER_NAME);
 	UplinkStrncpy(computer, newcomputer, sizeof(computer));
+	cachedcomputer = NULL;
 
 	//	UplinkAssert ( game->GetWorld ()->GetComputer ( computer ) );
 }
@@ -94,7 +96,13 @@ Computer* VLocation::GetComputer()
 			return NULL;
 	*/
 
-	BTree<Computer*>* tree = &(game->GetWorld()->computers);
+	World* world = game->GetWorld();
+
+	if (cachedcomputer && cachedgeneration == world->computergeneration) {
+		return cachedcomputer;
+	}
+
+	SortedTree<Computer*>* tree = &(world->computers);
 
 	/*  Remember there is no rule that states computer names have to be unique.
 	 *  eg "CompanyName Access Terminal" - there can be many.
@@ -106,19 +114,14 @@ Computer* VLocation::GetComputer()
 	 *
 	 */
 
-	while (tree) {
-		tree = tree->LookupTree(computer);
-
-		if (tree) {
-			Computer* comp = tree->data;
-			if (comp && strcmp(comp->ip, ip) == 0) {
-				return comp;
-			} else if (comp && comp->TYPE == COMPUTER_TYPE_LAN && GetOBJECTID() == OID_VLOCATIONSPECIAL) {
-				return comp;
-			} else {
-				// Copies with identical names will always be on the left branch
-				tree = tree->Left();
-			}
+	for (SortedTreeNode<Computer*>* node = tree->LookupTree(computer); node; node = tree->LookupNext(node)) {
+		Computer* comp = node->data;
+		if (comp
+			&& (strcmp(comp->ip, ip) == 0
+				|| (comp->TYPE == COMPUTER_TYPE_LAN && GetOBJECTID() == OID_VLOCATIONSPECIAL))) {
+			cachedcomputer = comp;
+			cachedgeneration = world->computergeneration;
+			return comp;
 		}
 	}
 
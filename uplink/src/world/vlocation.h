@@ -26,6 +26,10 @@ class Computer;
 
 class VLocation : public UplinkObject {
 
+protected:
+	Computer* cachedcomputer; // Last GetComputer result, good while
+	int cachedgeneration; // World::computergeneration is unchanged
+
 public:
 	char ip[SIZE_VLOCATION_IP]; // Unique
 	char computer[SIZE_COMPUTER_NAME];
@@ -49,6 +49,8 @@ World::World()
 	date.SetDate(WORLD_START_DATE);
 	date.Activate(); // Make it update with the game
 
+	computergeneration = 0;
+
 	//
 	// Initialise the static generators
 	//
@@ -118,10 +120,10 @@ World::~World()
 	NameGenerator::Shutdown();
 	MissionGenerator::Shutdown();
 
-	DeleteBTreeData((BTree<UplinkObject*>*)&locations);
-	DeleteBTreeData((BTree<UplinkObject*>*)&companies);
-	DeleteBTreeData((BTree<UplinkObject*>*)&computers);
-	DeleteBTreeData((BTree<UplinkObject*>*)&people);
+	DeleteBTreeData((SortedTree<UplinkObject*>*)&locations);
+	DeleteBTreeData((SortedTree<UplinkObject*>*)&companies);
+	DeleteBTreeData((SortedTree<UplinkObject*>*)&computers);
+	DeleteBTreeData((SortedTree<UplinkObject*>*)&people);
 
 	DeleteDArrayData(&passwords);
 
@@ -137,7 +139,7 @@ World::~World()
 VLocation* World::CreateVLocation(const char* ip, int phys_x, int phys_y)
 {
 
-	if (locations.LookupTree(ip) != NULL) {
+	if (locationsbyip.find(ip) != locationsbyip.end()) {
 
 		char warning[128];
 		UplinkSnprintf(warning, sizeof(warning), "Duplicate IP created : %s", ip);
@@ -146,6 +148,7 @@ VLocation* World::CreateVLocation(const char* ip, int phys_x, int phys_y)
 
 	VLocation* vl = new VLocation();
 	locations.PutData(ip, vl);
+	locationsbyip.emplace(ip, vl); // The first of any duplicates stays, as with LookupTree
 
 	vl->SetIP(ip);
 	vl->SetPLocation(phys_x, phys_y);
@@ -185,6 +188,10 @@ Computer* World::CreateComputer(const char* name, const char* companyname, const
 	computer->SetCompanyName(companyname);
 	computer->SetIP(ip);
 
+	computer->isinworld = true;
+	UpdateTargetComputer(computer);
+	computergeneration++;
+
 	UplinkAssert(GetVLocation(ip));
 	GetVLocation(ip)->SetComputer(name);
 
@@ -211,6 +218,7 @@ void World::CreateVLocation(VLocation* vlocation)
 	UplinkAssert(vlocation->ip);
 
 	locations.PutData(vlocation->ip, vlocation);
+	locationsbyip.emplace(vlocation->ip, vlocation);
 }
 
 void World::CreateCompany(Company* company)
@@ -230,6 +238,10 @@ void World::CreateComputer(Computer* computer)
 
 	computers.PutData(computer->name, computer);
 
+	computer->isinworld = true;
+	UpdateTargetComputer(computer);
+	computergeneration++;
+
 	UplinkAssert(GetVLocation(computer->ip));
 	GetVLocation(computer->ip)->SetComputer(computer->name);
 }
@@ -265,13 +277,70 @@ void World::CreateGatewayDef(GatewayDef* newdef)
 	gatewaydefs.Sort(GatewayDef::GatewayDefComparator);
 }
 
+void World::UpdateTargetComputer(Computer* computer)
+{
+
+	UplinkAssert(computer);
+
+	int bucket = -1;
+
+	if (computer->isinworld && computer->istargetable && computer->isrunning
+		&& strcmp(computer->companyname, "Government") != 0) {
+
+		// Computers only have one TYPE bit, so file them under the first
+
+		for (int i = 0; i < COMPUTER_NUMTYPES; ++i) {
+			if (computer->TYPE & (1 << i)) {
+				bucket = i;
+				break;
+			}
+		}
+	}
+
+	if (bucket == computer->targetbucket) {
+		return;
+	}
+
+	if (computer->targetbucket != -1) {
+
+		// Move the last computer in the old bucket into this one's slot
+
+		std::vector<Computer*>& oldbucket = targetcomputers[computer->targetbucket];
+		Computer* last = oldbucket.back();
+		oldbucket[computer->targetslot] = last;
+		last->targetslot = computer->targetslot;
+		oldbucket.pop_back();
+	}
+
+	computer->targetbucket = bucket;
+
+	if (bucket != -1) {
+		targetcomputers[bucket].push_back(computer);
+		computer->targetslot = (int)targetcomputers[bucket].size() - 1;
+	} else {
+		computer->targetslot = -1;
+	}
+}
+
+void World::RemoveComputer(Computer* computer)
+{
+
+	UplinkAssert(computer);
+
+	computers.RemoveData(computer->name, computer);
+
+	computer->isinworld = false;
+	UpdateTargetComputer(computer);
+	computergeneration++;
+}
+
 VLocation* World::GetVLocation(const char* ip)
 {
 
-	BTree<VLocation*>* vl = locations.LookupTree(ip);
+	auto vl = locationsbyip.find(ip);
 
-	if (vl) {
-		return vl->data;
+	if (vl != locationsbyip.end()) {
+		return vl->second;
 	} else {
 		return NULL;
 	}
@@ -280,7 +349,7 @@ VLocation* World::GetVLocation(const char* ip)
 Company* World::GetCompany(const char* name)
 {
 
-	BTree<Company*>* company = companies.LookupTree(name);
+	SortedTreeNode<Company*>* company = companies.LookupTree(name);
 
 	if (company) {
 		return company->data;
@@ -292,7 +361,7 @@ Company* World::GetCompany(const char* name)
 Computer* World::GetComputer(const char* name)
 {
 
-	BTree<Computer*>* computer = computers.LookupTree(name);
+	SortedTreeNode<Computer*>* computer = computers.LookupTree(name);
 
 	if (computer) {
 		return computer->data;
@@ -313,7 +382,7 @@ Person* World::GetPerson(const char* name)
 
 		// We're not looking for the player
 
-		BTree<Person*>* person = people.LookupTree(name);
+		SortedTreeNode<Person*>* person = people.LookupTree(name);
 
 		if (person) {
 			return person->data;
@@ -360,10 +429,44 @@ GatewayDef* World::GetGatewayDef(const char* name)
 	return NULL;
 }
 
+int World::NumTargetComputers(int TYPE)
+{
+
+	int count = 0;
+
+	for (int i = 0; i < COMPUTER_NUMTYPES; ++i) {
+		if (TYPE & (1 << i)) {
+			count += (int)targetcomputers[i].size();
+		}
+	}
+
+	return count;
+}
+
+Computer* World::GetTargetComputer(int TYPE, int index)
+{
+
+	for (int i = 0; i < COMPUTER_NUMTYPES; ++i) {
+		if (TYPE & (1 << i)) {
+
+			int size = (int)targetcomputers[i].size();
+
+			if (index < size) {
+				return targetcomputers[i][index];
+			}
+
+			index -= size;
+		}
+	}
+
+	UplinkAbort("World::GetTargetComputer : index out of range");
+	return NULL;
+}
+
 Player* World::GetPlayer()
 {
 
-	BTree<Person*>* player = people.LookupTree("PLAYER");
+	SortedTreeNode<Person*>* player = people.LookupTree("PLAYER");
 
 	UplinkAssert(player);
 
@@ -388,16 +491,27 @@ bool World::Load(FILE* file)
 		return false;
 	}
 
-	if (!LoadBTree((BTree<UplinkObject*>*)&locations, file)) {
+	if (!LoadBTree((SortedTree<UplinkObject*>*)&locations, file)) {
 		return false;
 	}
-	if (!LoadBTree((BTree<UplinkObject*>*)&companies, file)) {
+
+	locationsbyip.clear();
+	for (VLocation* vl : locations) {
+		locationsbyip.emplace(vl->ip, vl);
+	}
+	if (!LoadBTree((SortedTree<UplinkObject*>*)&companies, file)) {
 		return false;
 	}
-	if (!LoadBTree((BTree<UplinkObject*>*)&computers, file)) {
+	if (!LoadBTree((SortedTree<UplinkObject*>*)&computers, file)) {
 		return false;
 	}
-	if (!LoadBTree((BTree<UplinkObject*>*)&people, file)) {
+
+	for (Computer* computer : computers) {
+		computer->isinworld = true;
+		UpdateTargetComputer(computer);
+	}
+	computergeneration++;
+	if (!LoadBTree((SortedTree<UplinkObject*>*)&people, file)) {
 		return false;
 	}
 
@@ -426,10 +540,10 @@ void World::Save(FILE* file)
 	plotgenerator.Save(file);
 	demoplotgenerator.Save(file);
 
-	SaveBTree((BTree<UplinkObject*>*)&locations, file);
-	SaveBTree((BTree<UplinkObject*>*)&companies, file);
-	SaveBTree((BTree<UplinkObject*>*)&computers, file);
-	SaveBTree((BTree<UplinkObject*>*)&people, file);
+	SaveBTree((SortedTree<UplinkObject*>*)&locations, file);
+	SaveBTree((SortedTree<UplinkObject*>*)&companies, file);
+	SaveBTree((SortedTree<UplinkObject*>*)&computers, file);
+	SaveBTree((SortedTree<UplinkObject*>*)&people, file);
 
 	SaveID_END(file);
 }
@@ -444,10 +558,10 @@ void World::Print()
 	plotgenerator.Print();
 	demoplotgenerator.Print();
 
-	PrintBTree((BTree<UplinkObject*>*)&locations);
-	PrintBTree((BTree<UplinkObject*>*)&companies);
-	PrintBTree((BTree<UplinkObject*>*)&computers);
-	PrintBTree((BTree<UplinkObject*>*)&people);
+	PrintBTree((SortedTree<UplinkObject*>*)&locations);
+	PrintBTree((SortedTree<UplinkObject*>*)&companies);
+	PrintBTree((SortedTree<UplinkObject*>*)&computers);
+	PrintBTree((SortedTree<UplinkObject*>*)&people);
 
 	printf("============== E N D  O F  W O R L D =======================\n");
 }
@@ -461,10 +575,10 @@ void World::Update()
 
 	if (date.After(&nextupdate)) {
 
-		UpdateBTree((BTree<UplinkObject*>*)&locations);
-		UpdateBTree((BTree<UplinkObject*>*)&companies);
-		UpdateBTree((BTree<UplinkObject*>*)&computers);
-		UpdateBTree((BTree<UplinkObject*>*)&people);
+		UpdateBTree((SortedTree<UplinkObject*>*)&locations);
+		UpdateBTree((SortedTree<UplinkObject*>*)&companies);
+		UpdateBTree((SortedTree<UplinkObject*>*)&computers);
+		UpdateBTree((SortedTree<UplinkObject*>*)&people);
 
 		scheduler.Update();
 		plotgenerator.Update();
@@ -475,7 +589,7 @@ void World::Update()
 
 #ifdef WAREZRELEASE
 
-		int timePlaying = EclGetAccurateTime() - app->starttime;
+		int timePlaying = GetAccurateTime() - app->starttime;
 		if (timePlaying > WAREZ_MAXPLAYTIME) {
 
 			Date rundate;
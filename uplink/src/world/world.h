@@ -14,10 +14,15 @@
 // ============================================================================
 
 #include <stdio.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "tosser.h"
 
 #include "app/uplinkobject.h"
+#include "world/computer/computer.h"
 #include "world/date.h"
 #include "world/generator/demoplotgenerator.h"
 #include "world/generator/plotgenerator.h"
@@ -25,12 +30,18 @@
 
 class VLocation;
 class Company;
-class Computer;
 class Person;
 class Mission;
 class Player;
 class GatewayDef;
 
+// Lets the IP index be searched with a char * without building a std::string
+
+struct IPHash {
+	using is_transparent = void;
+	size_t operator()(std::string_view ip) const { return std::hash<std::string_view>()(ip); }
+};
+
 // ============================================================================
 
 class World : public UplinkObject {
@@ -38,16 +49,26 @@ class World : public UplinkObject {
 protected:
 	Date nextupdate;
 
+	std::unordered_map<std::string, VLocation*, IPHash, std::equal_to<>> locationsbyip; // Mirrors locations
+
 public:
 	Date date;
 	EventScheduler scheduler;
 	PlotGenerator plotgenerator;
 	DemoPlotGenerator demoplotgenerator;
 
-	BTree<VLocation*> locations;
-	BTree<Company*> companies;
-	BTree<Computer*> computers;
-	BTree<Person*> people;
+	SortedTree<VLocation*> locations;
+	SortedTree<Company*> companies;
+	SortedTree<Computer*> computers;
+	SortedTree<Person*> people;
+
+	// Targetable, running, non Government computers, by TYPE bit, so
+	// WorldGenerator::GetRandomComputer needn't look at them all
+	std::vector<Computer*> targetcomputers[COMPUTER_NUMTYPES];
+
+	// Bumped whenever a computer is added, removed or moved to another IP,
+	// which is what VLocation::GetComputer's cached answer depends on
+	int computergeneration;
 
 	DArray<char*> passwords; // No need to serialise
 	DArray<GatewayDef*> gatewaydefs; // No need to serialise
@@ -71,6 +92,9 @@ public:
 	void CreatePerson(Person* person);
 	void CreateGatewayDef(GatewayDef* newdef);
 
+	void UpdateTargetComputer(Computer* computer); // Call when it may have become or stopped being a target
+	void RemoveComputer(Computer* computer); // Takes it out of computers, without deleting it
+
 	VLocation* GetVLocation(const char* ip); //  These all return NULL
 	Company* GetCompany(const char* name); //  if the specified object
 	Computer* GetComputer(const char* name); //  is not found in the database
@@ -78,6 +102,9 @@ public:
 	char* GetPassword(int index);
 	GatewayDef* GetGatewayDef(const char* name);
 
+	int NumTargetComputers(int TYPE); // Any of the TYPE bits
+	Computer* GetTargetComputer(int TYPE, int index); // 0 <= index < NumTargetComputers ( TYPE )
+
 	Player* GetPlayer(); //  Asserts that player exists
 
 	// Common functions